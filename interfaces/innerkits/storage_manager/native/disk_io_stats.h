@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_MANAGER_DISK_IO_STATS_H
+#define OHOS_STORAGE_MANAGER_DISK_IO_STATS_H
+
+#include <string>
+
+#include "parcel.h"
+
+namespace OHOS {
+namespace StorageManager {
+/*
+ * I/O activity of one disk over the sampling window, derived from
+ * /sys/block/<dev>/stat. Rates are per second, latencies are the average
+ * time a request of that direction spent in the block layer.
+ */
+class DiskIoStats final : public Parcelable {
+public:
+    DiskIoStats() {}
+    ~DiskIoStats() {}
+
+    std::string diskId_;
+    int64_t windowMs_ {0};
+    uint32_t samples_ {0};
+    double readIops_ {0};
+    double writeIops_ {0};
+    double readBytesPerSec_ {0};
+    double writeBytesPerSec_ {0};
+    double readLatencyUs_ {0};
+    double writeLatencyUs_ {0};
+    double utilPercent_ {0};
+    uint32_t inflightRead_ {0};
+    uint32_t inflightWrite_ {0};
+
+    bool Marshalling(Parcel &parcel) const override;
+    static std::unique_ptr<DiskIoStats> Unmarshalling(Parcel &parcel);
+};
+} // StorageManager
+} // OHOS
+
+#endif // OHOS_STORAGE_MANAGER_DISK_IO_STATS_H
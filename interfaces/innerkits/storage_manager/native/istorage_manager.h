@@ -20,6 +20,7 @@
 #include "volume_core.h"
 #include "volume_external.h"
 #include "disk.h"
+#include "disk_io_stats.h"
 #include "bundle_stats.h"
 #include "storage_stats.h"
 
@@ -51,6 +52,7 @@ public:
     virtual void NotifyDiskDestroyed(std::string diskId) = 0;
     virtual int32_t Partition(std::string diskId, int32_t type) = 0;
     virtual std::vector<Disk> GetAllDisks() = 0;
+    virtual int32_t GetDiskIoStats(std::string diskId, DiskIoStats &stats) = 0;
 
     // fscrypt api
     virtual int32_t GenerateUserKeys(uint32_t userId, uint32_t flags) = 0;
@@ -90,6 +92,7 @@ public:
         ACTIVE_USER_KEY,
         INACTIVE_USER_KEY,
         UPDATE_KEY_CONTEXT,
+        GET_DISK_IO_STATS,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"OHOS.StorageManager.IStorageManager");
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_MANAGER_MEDIA_BENCHMARK_RESULT_H
+#define OHOS_STORAGE_MANAGER_MEDIA_BENCHMARK_RESULT_H
+
+#include <string>
+
+#include "parcel.h"
+
+namespace OHOS {
+namespace StorageManager {
+/*
+ * Outcome of a speed benchmark of a mounted removable volume. Throughput is
+ * in MB/s with MB = 1000000 bytes as the SD speed classes use, random I/O is
+ * 4 KiB at queue depth 1. speedClass_ lists the classes the measured averages
+ * reach, e.g. "C10 U3 V30 A1"; it is an estimate, not a certification.
+ */
+class MediaBenchmarkResult final : public Parcelable {
+public:
+    MediaBenchmarkResult() {}
+    ~MediaBenchmarkResult() {}
+
+    std::string volumeId_;
+    int64_t durationMs_ {0};
+    bool direct_ {false};
+    bool cancelled_ {false};
+    double seqWriteMBps_ {0};
+    double seqReadMBps_ {0};
+    double randWriteIops_ {0};
+    double randReadIops_ {0};
+    std::string speedClass_;
+
+    bool Marshalling(Parcel &parcel) const override;
+    static std::unique_ptr<MediaBenchmarkResult> Unmarshalling(Parcel &parcel);
+};
+} // StorageManager
+} // OHOS
+
+#endif // OHOS_STORAGE_MANAGER_MEDIA_BENCHMARK_RESULT_H
@@ -39,6 +39,7 @@ enum ErrNo {
     E_NOT_SUPPORT,            // not support
     E_SYS_CALL,               // syscall error
     E_NO_CHILD,               // child not exist
+    E_CANCELED,               // canceled before completion
 };
 }
 
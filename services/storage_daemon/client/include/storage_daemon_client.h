@@ -42,6 +42,9 @@ public:
     static int32_t ActiveUserKey(uint32_t userId, std::string auth, std::string compSecret);
     static int32_t InactiveUserKey(uint32_t userId);
     static int32_t FscryptEnable(const std::string &fscryptOptions);
+    static int32_t BenchmarkVolume(const std::string &volId, uint32_t budgetMs,
+        StorageManager::MediaBenchmarkResult &result);
+    static int32_t CancelBenchmark(const std::string &volId);
 
 private:
     static sptr<IStorageDaemon> GetStorageDaemonProxy(void);
@@ -284,5 +284,38 @@ int32_t StorageDaemonClient::FscryptEnable(const std::string &fscryptOptions)
 
     return 0;
 }
+
+int32_t StorageDaemonClient::BenchmarkVolume(const std::string &volId, uint32_t budgetMs,
+    StorageManager::MediaBenchmarkResult &result)
+{
+    if (!CheckServiceStatus(STORAGE_SERVICE_FLAG)) {
+        LOGE("service check failed");
+        return -EAGAIN;
+    }
+
+    sptr<IStorageDaemon> client = GetStorageDaemonProxy();
+    if (client == nullptr) {
+        LOGE("get storage daemon service failed");
+        return -EAGAIN;
+    }
+
+    return client->BenchmarkVolume(volId, budgetMs, result);
+}
+
+int32_t StorageDaemonClient::CancelBenchmark(const std::string &volId)
+{
+    if (!CheckServiceStatus(STORAGE_SERVICE_FLAG)) {
+        LOGE("service check failed");
+        return -EAGAIN;
+    }
+
+    sptr<IStorageDaemon> client = GetStorageDaemonProxy();
+    if (client == nullptr) {
+        LOGE("get storage daemon service failed");
+        return -EAGAIN;
+    }
+
+    return client->CancelBenchmark(volId);
+}
 } // namespace StorageDaemon
 } // namespace OHOS
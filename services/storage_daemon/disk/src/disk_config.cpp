@@ -17,8 +17,6 @@
 
 #include <fnmatch.h>
 
-#include "storage_service_log.h"
-
 namespace OHOS {
 namespace StorageDaemon {
 DiskConfig::DiskConfig(const std::string &sysPattern, const std::string &label, int flag)
@@ -32,11 +30,8 @@ DiskConfig::~DiskConfig()
 {
 }
 
-bool DiskConfig::IsMatch(std::string &sysPattern)
+bool DiskConfig::IsMatch(const std::string &sysPattern) const
 {
-    LOGI("config sysPattern %{public}s", sysPattern_.c_str());
-    LOGI("device sysPattern %{public}s", sysPattern.c_str());
-
     return !fnmatch(sysPattern_.c_str(), sysPattern.c_str(), 0);
 }
 
@@ -44,5 +39,15 @@ int DiskConfig::GetFlag() const
 {
     return flag_;
 }
+
+const std::string &DiskConfig::GetSysPattern() const
+{
+    return sysPattern_;
+}
+
+const std::string &DiskConfig::GetLabel() const
+{
+    return label_;
+}
 } // namespace STORAGE_DAEMON
 } // namespace OHOS
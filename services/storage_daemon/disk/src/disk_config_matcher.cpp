@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disk/disk_config_matcher.h"
+
+#include <algorithm>
+
+#include <fnmatch.h>
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr uint32_t NO_NODE = 0;
+constexpr uint32_t ROOT_NODE = 0;
+const char *GLOB_CHARS = "*?[\\";
+}
+
+DiskConfigMatcher::DiskConfigMatcher() : nodes_(1)
+{
+}
+
+uint32_t DiskConfigMatcher::Child(uint32_t node, char c) const
+{
+    auto &next = nodes_[node].next;
+    auto it = std::lower_bound(next.begin(), next.end(), c,
+        [](const std::pair<char, uint32_t> &entry, char key) { return entry.first < key; });
+    if (it == next.end() || it->first != c) {
+        return NO_NODE;
+    }
+    return it->second;
+}
+
+void DiskConfigMatcher::Add(const std::shared_ptr<DiskConfig> &config)
+{
+    const std::string &pattern = config->GetSysPattern();
+    size_t headLen = pattern.find_first_of(GLOB_CHARS);
+    bool literal = (headLen == std::string::npos);
+    if (literal) {
+        headLen = pattern.size();
+    }
+
+    uint32_t node = ROOT_NODE;
+    for (size_t i = 0; i < headLen; i++) {
+        uint32_t child = Child(node, pattern[i]);
+        if (child == NO_NODE) {
+            child = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+            auto &next = nodes_[node].next;
+            auto it = std::lower_bound(next.begin(), next.end(), pattern[i],
+                [](const std::pair<char, uint32_t> &entry, char key) { return entry.first < key; });
+            next.insert(it, { pattern[i], child });
+        }
+        node = child;
+    }
+
+    nodes_[node].rules.push_back(static_cast<uint32_t>(rules_.size()));
+    rules_.push_back({ config, headLen, literal });
+}
+
+bool DiskConfigMatcher::RuleMatch(const Rule &rule, const std::string &devPath) const
+{
+    if (rule.literal) {
+        return devPath.size() == rule.headLen;
+    }
+    /* The head already matched literally, without FNM_PATHNAME the tail can be matched on its own */
+    return fnmatch(rule.config->GetSysPattern().c_str() + rule.headLen, devPath.c_str() + rule.headLen, 0) == 0;
+}
+
+std::shared_ptr<DiskConfig> DiskConfigMatcher::Match(const std::string &devPath) const
+{
+    uint32_t best = static_cast<uint32_t>(rules_.size());
+    uint32_t node = ROOT_NODE;
+    for (size_t i = 0;; i++) {
+        for (uint32_t index : nodes_[node].rules) {
+            if (index >= best) {
+                break;
+            }
+            if (RuleMatch(rules_[index], devPath)) {
+                best = index;
+                break;
+            }
+        }
+        if (i == devPath.size()) {
+            break;
+        }
+        node = Child(node, devPath[i]);
+        if (node == NO_NODE) {
+            break;
+        }
+    }
+
+    if (best == rules_.size()) {
+        return nullptr;
+    }
+    return rules_[best].config;
+}
+
+size_t DiskConfigMatcher::Size() const
+{
+    return rules_.size();
+}
+} // STORAGE_DAEMON
+} // OHOS
@@ -15,23 +15,27 @@
 
 #include "disk/disk_info.h"
 
+#include <cerrno>
+#include <vector>
+
 #include <sys/sysmacros.h>
 
 #include "disk/disk_manager.h"
+#include "disk/partition_table.h"
 #include "ipc/storage_manager_client.h"
 #include "storage_service_errno.h"
 #include "storage_service_log.h"
 #include "utils/string_utils.h"
 #include "utils/disk_utils.h"
 #include "utils/file_utils.h"
+#include "utils/sysfs_reader.h"
 #include "volume/volume_manager.h"
 
 namespace OHOS {
 namespace StorageDaemon {
-const std::string SGDISK_PATH = "/system/bin/sgdisk";
-const std::string SGDISK_DUMP_CMD = "--ohos-dump";
-const std::string SGDISK_ZAP_CMD = "--zap-all";
-const std::string SGDISK_PART_CMD = "--new=0:0:-0 --typeconde=0:0c00 --gpttombr=1";
+namespace {
+constexpr uint64_t WIPE_PROGRESS_STEPS = 10;
+}
 
 DiskInfo::DiskInfo(std::string sysPath, std::string devPath, dev_t device, int flag)
 {
@@ -110,21 +114,33 @@ int DiskInfo::Create()
 
 int DiskInfo::Destroy()
 {
-    int ret;
-    auto volume = VolumeManager::Instance();
-
-    for (auto volumeId : volumeId_) {
-        ret = volume->DestroyVolume(volumeId);
-        if (ret != E_OK) {
-            LOGE("Destroy volume %{public}s failed", volumeId.c_str());
-            return E_ERR;
-        }
+    std::vector<std::string> volumeIds(volumeId_.begin(), volumeId_.end());
+    int ret = DestroyVolumes(volumeIds);
+    if (ret != E_OK) {
+        return ret;
     }
     status = sDestroy;
-    volumeId_.clear();
     return E_OK;
 }
 
+int DiskInfo::DestroyVolumes(const std::vector<std::string> &volumeIds)
+{
+    std::vector<int32_t> results;
+    VolumeManager::Instance()->DestroyVolumes(volumeIds, results);
+
+    int ret = E_OK;
+    for (size_t i = 0; i < volumeIds.size(); i++) {
+        if (results[i] != E_OK) {
+            LOGE("Destroy volume %{public}s failed", volumeIds[i].c_str());
+            ret = E_ERR;
+        } else {
+            volumeId_.remove(volumeIds[i]);
+            partitions_.erase(volumeIds[i]);
+        }
+    }
+    return ret;
+}
+
 void DiskInfo::ReadMetadata()
 {
     size_ = -1;
@@ -133,15 +149,19 @@ void DiskInfo::ReadMetadata()
         size_ = -1;
     }
 
+    SysfsDir sysDir(sysPath_);
+    if (!sysDir.IsOpen()) {
+        LOGE("open %{public}s failed, errno %{public}d", sysPath_.c_str(), errno);
+        return;
+    }
+
     unsigned int majorId = major(device_);
     if (majorId == DISK_MMC_MAJOR) {
-        std::string path(sysPath_ + "/device/manfid");
-        std::string str;
-        if (!ReadFile(path, &str)) {
-            LOGE("open file %{public}s failed", path.c_str());
+        int64_t manfid = 0;
+        if (sysDir.ReadInt("device/manfid", manfid) != E_OK) {
+            LOGE("read %{public}s/device/manfid failed", sysPath_.c_str());
             return;
         }
-        int manfid = std::stoi(str);
         switch (manfid) {
             case 0x000003: {
                 vendor_ = "SanDisk";
@@ -161,23 +181,20 @@ void DiskInfo::ReadMetadata()
             }
             default : {
                 vendor_ = "Unknown";
-                LOGI("Unknown vendor information: %{public}d", manfid);
+                LOGI("Unknown vendor information: %{public}lld", static_cast<long long>(manfid));
                 break;
             }
         }
     } else {
-        std::string path(sysPath_ + "/device/vendor");
-        std::string str;
-        if (!ReadFile(path, &str)) {
-            LOGE("open file %{public}s failed", path.c_str());
+        if (sysDir.Read("device/vendor", vendor_) != E_OK) {
+            LOGE("read %{public}s/device/vendor failed", sysPath_.c_str());
             return;
         }
-        vendor_ = str;
-    LOGI("Read metadata %{public}s", path.c_str());
+        LOGI("Read metadata %{public}s", sysPath_.c_str());
     }
 }
 
-int DiskInfo::ReadPartition()
+int DiskInfo::ReadPartitionEntries(std::vector<PartitionEntry> &entries)
 {
     int maxVolumes = GetMaxVolume(device_);
     if (maxVolumes < 0) {
@@ -185,52 +202,90 @@ int DiskInfo::ReadPartition()
         return E_ERR;
     }
 
-    std::vector<std::string> cmd;
-    std::vector<std::string> output;
-    std::vector<std::string> lines;
-    int res;
-
-    cmd.push_back(SGDISK_PATH);
-    cmd.push_back(SGDISK_DUMP_CMD);
-    cmd.push_back(devPath_);
-    res = ForkExec(cmd, &output);
+    PartitionTable table;
+    int res = ReadPartitionTable(devPath_, table);
     if (res != E_OK) {
         LOGE("get %{private}s partition failed", devPath_.c_str());
         return res;
     }
-    std::string bufToken = "\n";
-    for (auto &buf : output) {
-        auto split = SplitLine(buf, bufToken);
-        for (auto &tmp : split)
-            lines.push_back(tmp);
+
+    entries.clear();
+    for (auto &entry : table.entries) {
+        if (entry.index > static_cast<uint32_t>(maxVolumes) || entry.index < 1) {
+            LOGE("Invalid partition %{public}u", entry.index);
+            continue;
+        }
+        entries.push_back(entry);
+    }
+    return E_OK;
+}
+
+int DiskInfo::ReadPartition()
+{
+    std::vector<PartitionEntry> entries;
+    int res = ReadPartitionEntries(entries);
+    if (res != E_OK) {
+        return res;
     }
 
-    std::string lineToken = " ";
     status = sScan;
-    for (auto &line : lines) {
-        auto split = SplitLine(line, lineToken);
-        auto it = split.begin();
-        if (it == split.end()) {
-            continue;
+    for (auto &entry : entries) {
+        res = CreatePartitionVolume(entry);
+        if (res != E_OK) {
+            return res;
         }
-        if (*it == "DISK") {
-            continue;
-        } else if (*it == "PART") {
-            if (++it == split.end()) {
-                continue;
-            }
-            int32_t index = std::stoi(*it);
-            if (index > maxVolumes || index < 1) {
-                LOGE("Invalid partition %{public}d", index);
-                continue;
-            }
-            dev_t partitionDev = makedev(major(device_), minor(device_) + static_cast<uint32_t>(index));
-            res = CreateVolume(partitionDev);
-            if (res != E_OK) {
-                return res;
-            }
+    }
+    return E_OK;
+}
+
+int DiskInfo::Rescan()
+{
+    std::vector<PartitionEntry> entries;
+    int res = ReadPartitionEntries(entries);
+    if (res != E_OK) {
+        return res;
+    }
+
+    /* A volume without a recorded layout never matches (index 0 is not a partition), so it is recreated */
+    std::vector<std::string> volumeIds(volumeId_.begin(), volumeId_.end());
+    std::vector<PartitionEntry> known(volumeIds.size());
+    for (size_t i = 0; i < volumeIds.size(); i++) {
+        auto layout = partitions_.find(volumeIds[i]);
+        if (layout != partitions_.end()) {
+            known[i] = layout->second;
         }
     }
+
+    std::vector<size_t> removed;
+    std::vector<size_t> added;
+    DiffPartitionEntries(known, entries, removed, added);
+    LOGI("rescan %{public}s: %{public}zu kept, %{public}zu removed, %{public}zu added", id_.c_str(),
+        volumeIds.size() - removed.size(), removed.size(), added.size());
+
+    std::vector<std::string> stale;
+    for (size_t i : removed) {
+        stale.push_back(volumeIds[i]);
+    }
+    int ret = DestroyVolumes(stale);
+
+    status = sScan;
+    for (size_t i : added) {
+        /* Fails while an old volume that could not be destroyed still holds this index's device */
+        if (CreatePartitionVolume(entries[i]) != E_OK) {
+            ret = E_ERR;
+        }
+    }
+    return ret;
+}
+
+int DiskInfo::CreatePartitionVolume(const PartitionEntry &entry)
+{
+    dev_t partitionDev = makedev(major(device_), minor(device_) + entry.index);
+    int res = CreateVolume(partitionDev);
+    if (res != E_OK) {
+        return res;
+    }
+    partitions_[volumeId_.back()] = entry;
     return E_OK;
 }
 
@@ -249,36 +304,62 @@ int DiskInfo::CreateVolume(dev_t dev)
     return E_OK;
 }
 
-int DiskInfo::Partition()
+int DiskInfo::Wipe(bool allowZeroOut)
 {
-    std::vector<std::string> cmd;
-    int res;
+    auto wiper = std::make_shared<DiskWiper>(DISK_WIPE_THREADS,
+        allowZeroOut ? UINT64_MAX : DISK_WIPE_ZEROOUT_MAX_BYTES);
+    {
+        std::lock_guard<std::mutex> lock(wipeLock_);
+        wiper_ = wiper;
+    }
 
-    res = Destroy();
+    /* Progress runs under the wiper's own lock, so lastStep needs none */
+    uint64_t lastStep = 0;
+    DiskWipeReport report;
+    int ret = wiper->WipeDevice(devPath_, sysPath_, report, [this, &lastStep](uint64_t done, uint64_t total) {
+        uint64_t step = done * WIPE_PROGRESS_STEPS / total;
+        if (step > lastStep) {
+            lastStep = step;
+            LOGI("wipe %{public}s %{public}llu%%", id_.c_str(),
+                static_cast<unsigned long long>(step * 100 / WIPE_PROGRESS_STEPS));
+        }
+    });
+
+    std::lock_guard<std::mutex> lock(wipeLock_);
+    wiper_.reset();
+    return ret;
+}
+
+int DiskInfo::CancelWipe()
+{
+    std::lock_guard<std::mutex> lock(wipeLock_);
+    if (wiper_ == nullptr) {
+        return E_NON_EXIST;
+    }
+    wiper_->Cancel();
+    return E_OK;
+}
+
+int DiskInfo::Partition(bool wipe, bool allowZeroOut)
+{
+    int res = Destroy();
     if (res != E_OK) {
         LOGE("Destroy failed in Partition()");
     }
 
-    cmd.push_back(SGDISK_PATH);
-    cmd.push_back(SGDISK_ZAP_CMD);
-    cmd.push_back(devPath_);
-    res = ForkExec(cmd);
-    if (res != E_OK) {
-        LOGE("sgdisk: zap fail");
-        return res;
+    /* A failed wipe still gets the new table, so the disk is left consistent */
+    int wiped = wipe ? Wipe(allowZeroOut) : E_OK;
+    if (wiped != E_OK) {
+        LOGE("wipe %{private}s failed", devPath_.c_str());
     }
 
-    cmd.clear();
-    cmd.push_back(SGDISK_PATH);
-    cmd.push_back(SGDISK_PART_CMD);
-    cmd.push_back(devPath_);
-    res = ForkExec(cmd);
+    res = WriteSinglePartitionTable(devPath_, MBR_TYPE_FAT32_LBA);
     if (res != E_OK) {
-        LOGE("sgdisk: partition fail");
+        LOGE("partition %{private}s failed", devPath_.c_str());
         return res;
     }
 
-    return E_OK;
+    return wiped;
 }
 } // namespace STORAGE_DAEMON
 } // namespace OHOS
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disk/disk_io_sampler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iterator>
+#include <set>
+
+#include "storage_service_errno.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr uint64_t SECTOR_SIZE = 512;
+constexpr double MS_PER_SEC = 1000.0;
+constexpr double US_PER_MS = 1000.0;
+constexpr double PERCENT = 100.0;
+
+/* Field order of Documentation/block/stat.rst, only the ones used here */
+enum DiskStatField {
+    STAT_READ_IOS = 0,
+    STAT_READ_SECTORS = 2,
+    STAT_READ_TICKS = 3,
+    STAT_WRITE_IOS = 4,
+    STAT_WRITE_SECTORS = 6,
+    STAT_WRITE_TICKS = 7,
+    STAT_IN_FLIGHT = 8,
+    STAT_IO_TICKS = 9,
+    STAT_MIN_FIELDS = 11,
+};
+
+size_t ParseFields(const std::string &str, uint64_t *fields, size_t max)
+{
+    const char *p = str.c_str();
+    size_t count = 0;
+    while (count < max) {
+        char *end = nullptr;
+        errno = 0;
+        unsigned long long value = strtoull(p, &end, 10);
+        if (end == p || errno != 0) {
+            break;
+        }
+        fields[count++] = static_cast<uint64_t>(value);
+        p = end;
+    }
+    return count;
+}
+
+int64_t NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double PerSecond(uint64_t delta, int64_t ms)
+{
+    return static_cast<double>(delta) * MS_PER_SEC / static_cast<double>(ms);
+}
+
+double AverageUs(uint64_t ticks, uint64_t ios)
+{
+    return ios == 0 ? 0 : static_cast<double>(ticks) * US_PER_MS / static_cast<double>(ios);
+}
+}
+
+bool ParseDiskStat(const std::string &stat, DiskIoSample &sample)
+{
+    uint64_t fields[STAT_MIN_FIELDS] = { 0 };
+    if (ParseFields(stat, fields, STAT_MIN_FIELDS) < STAT_MIN_FIELDS) {
+        return false;
+    }
+    sample.readIos = fields[STAT_READ_IOS];
+    sample.readSectors = fields[STAT_READ_SECTORS];
+    sample.readTicks = fields[STAT_READ_TICKS];
+    sample.writeIos = fields[STAT_WRITE_IOS];
+    sample.writeSectors = fields[STAT_WRITE_SECTORS];
+    sample.writeTicks = fields[STAT_WRITE_TICKS];
+    sample.ioTicks = fields[STAT_IO_TICKS];
+    /* Only the total is in stat, inflight gives the split when available */
+    sample.inflightRead = static_cast<uint32_t>(fields[STAT_IN_FLIGHT]);
+    sample.inflightWrite = 0;
+    return true;
+}
+
+bool ParseDiskInflight(const std::string &inflight, DiskIoSample &sample)
+{
+    uint64_t fields[2] = { 0 };
+    if (ParseFields(inflight, fields, 2) < 2) {
+        return false;
+    }
+    sample.inflightRead = static_cast<uint32_t>(fields[0]);
+    sample.inflightWrite = static_cast<uint32_t>(fields[1]);
+    return true;
+}
+
+void DeriveDiskIoStats(const DiskIoSample &first, const DiskIoSample &last, StorageManager::DiskIoStats &stats)
+{
+    stats.inflightRead_ = last.inflightRead;
+    stats.inflightWrite_ = last.inflightWrite;
+    int64_t ms = last.timeMs - first.timeMs;
+    stats.windowMs_ = ms;
+    if (ms <= 0) {
+        return;
+    }
+
+    uint64_t readIos = last.readIos - first.readIos;
+    uint64_t writeIos = last.writeIos - first.writeIos;
+    stats.readIops_ = PerSecond(readIos, ms);
+    stats.writeIops_ = PerSecond(writeIos, ms);
+    stats.readBytesPerSec_ = PerSecond((last.readSectors - first.readSectors) * SECTOR_SIZE, ms);
+    stats.writeBytesPerSec_ = PerSecond((last.writeSectors - first.writeSectors) * SECTOR_SIZE, ms);
+    stats.readLatencyUs_ = AverageUs(last.readTicks - first.readTicks, readIos);
+    stats.writeLatencyUs_ = AverageUs(last.writeTicks - first.writeTicks, writeIos);
+    stats.utilPercent_ = std::min(PERCENT, static_cast<double>(last.ioTicks - first.ioTicks) * PERCENT / ms);
+}
+
+DiskIoSampler::DiskIoSampler(DiskSource source, std::chrono::milliseconds interval)
+    : source_(std::move(source)), interval_(interval)
+{
+}
+
+DiskIoSampler::~DiskIoSampler()
+{
+    Stop();
+}
+
+void DiskIoSampler::Start()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    if (running_) {
+        return;
+    }
+    /* Rings left from before a Stop would span the idle gap */
+    disks_.clear();
+    running_ = true;
+    thread_ = std::thread(&DiskIoSampler::Run, this);
+}
+
+void DiskIoSampler::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cond_.notify_all();
+    thread_.join();
+}
+
+void DiskIoSampler::Run()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    while (running_) {
+        lock.unlock();
+        SampleOnce();
+        lock.lock();
+        cond_.wait_for(lock, interval_, [this] { return !running_; });
+    }
+}
+
+void DiskIoSampler::Push(DiskRing &ring, const DiskIoSample &sample)
+{
+    if (ring.count > 0) {
+        /* Counters going backwards mean the device was reset, older samples no longer compare */
+        auto &newest = ring.samples[(ring.head + DISK_IO_RING_SIZE - 1) % DISK_IO_RING_SIZE];
+        if (sample.readIos < newest.readIos || sample.writeIos < newest.writeIos ||
+            sample.ioTicks < newest.ioTicks) {
+            ring.count = 0;
+        }
+    }
+    ring.samples[ring.head] = sample;
+    ring.head = (ring.head + 1) % DISK_IO_RING_SIZE;
+    ring.count = std::min(ring.count + 1, DISK_IO_RING_SIZE);
+}
+
+void DiskIoSampler::SampleOnce()
+{
+    auto known = source_();
+    std::set<std::string> ids;
+
+    std::lock_guard<std::mutex> lock(lock_);
+    for (auto &disk : known) {
+        ids.insert(disk.first);
+        auto &ring = disks_[disk.first];
+        if (ring.dir == nullptr || ring.sysPath != disk.second) {
+            ring.sysPath = disk.second;
+            ring.dir = std::make_unique<SysfsDir>(disk.second);
+            ring.count = 0;
+        }
+
+        std::string stat;
+        std::string inflight;
+        DiskIoSample sample = {};
+        if (ring.dir->Read("stat", stat) != E_OK || !ParseDiskStat(stat, sample)) {
+            continue;
+        }
+        if (ring.dir->Read("inflight", inflight) == E_OK) {
+            (void)ParseDiskInflight(inflight, sample);
+        }
+        sample.timeMs = NowMs();
+        Push(ring, sample);
+    }
+
+    for (auto it = disks_.begin(); it != disks_.end();) {
+        it = ids.count(it->first) == 0 ? disks_.erase(it) : std::next(it);
+    }
+}
+
+int32_t DiskIoSampler::Query(const std::string &diskId, StorageManager::DiskIoStats &stats)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = disks_.find(diskId);
+    if (it == disks_.end()) {
+        return E_NON_EXIST;
+    }
+
+    auto &ring = it->second;
+    stats.diskId_ = diskId;
+    stats.samples_ = ring.count;
+    if (ring.count == 0) {
+        return E_OK;
+    }
+    auto &oldest = ring.samples[(ring.head + DISK_IO_RING_SIZE - ring.count) % DISK_IO_RING_SIZE];
+    auto &newest = ring.samples[(ring.head + DISK_IO_RING_SIZE - 1) % DISK_IO_RING_SIZE];
+    DeriveDiskIoStats(oldest, newest, stats);
+    return E_OK;
+}
+} // STORAGE_DAEMON
+} // OHOS
@@ -15,19 +15,31 @@
 
 #include "disk/disk_manager.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <future>
 #include <thread>
+#include <vector>
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <sys/sysmacros.h>
+#include <unistd.h>
 
 #include "storage_service_errno.h"
 #include "storage_service_log.h"
 #include "utils/string_utils.h"
 #include "utils/file_utils.h"
 #include "utils/disk_utils.h"
+#include "utils/sysfs_reader.h"
+#include "utils/uevent_trigger.h"
 #include "ipc/storage_manager_client.h"
 
 namespace OHOS {
 namespace StorageDaemon {
+constexpr uint32_t UEVENT_REPLAY_THREADS = 4;
+
 DiskManager* DiskManager::instance_ = nullptr;
 
 DiskManager* DiskManager::Instance()
@@ -39,6 +51,16 @@ DiskManager* DiskManager::Instance()
     return instance_;
 }
 
+DiskManager::DiskManager() : ioSampler_([this] {
+    std::vector<std::pair<std::string, std::string>> sources;
+    for (auto &disk : disks_.Snapshot()) {
+        sources.emplace_back(disk->GetId(), disk->GetSysPath());
+    }
+    return sources;
+})
+{
+}
+
 DiskManager::~DiskManager()
 {
     LOGI("Destroy DiskManager");
@@ -46,35 +68,43 @@ DiskManager::~DiskManager()
 
 void DiskManager::HandleDiskEvent(NetlinkData *data)
 {
-    std::lock_guard<std::mutex> lock(lock_);
-    std::string devType = data->GetParam("DEVTYPE");
-    if (devType != "disk") {
+    if (data->GetParam(NetlinkData::PARAM_DEVTYPE) != "disk") {
         return;
     }
 
-    unsigned int major = (unsigned int) std::stoi(data->GetParam("MAJOR"));
-    unsigned int minor = (unsigned int) std::stoi(data->GetParam("MINOR"));
-    dev_t device = makedev(major, minor);
+    if (data->GetMajor() < 0 || data->GetMinor() < 0) {
+        LOGE("Invalid MAJOR or MINOR in disk event");
+        return;
+    }
+    dev_t device = makedev(static_cast<unsigned int>(data->GetMajor()), static_cast<unsigned int>(data->GetMinor()));
 
     switch (data->GetAction()) {
         case NetlinkData::Actions::ADD: {
-            auto diskInfo = MatchConfig(data);
-            if (diskInfo == nullptr) {
-                LOGE("Can't match config");
-            } else {
-                CreateDisk(diskInfo);
+            std::string sysPath = data->GetSyspath();
+            std::string devPath = data->GetDevpath();
+            strands_.Post(device, [this, sysPath, devPath, device] {
+                AddDisk(sysPath, devPath, device);
                 LOGI("Handle Disk Add Event");
-            }
+            });
             break;
         }
         case NetlinkData::Actions::CHANGE: {
-            ChangeDisk(device);
-            LOGI("Handle Disk Change Event");
+            strands_.Post(device, [this, device] {
+                ChangeDisk(device);
+                LOGI("Handle Disk Change Event");
+            });
             break;
         }
         case NetlinkData::Actions::REMOVE: {
-            DestroyDisk(device);
-            LOGI("Handle Disk Remove Event");
+            /* A wipe holds the strand, stop it now rather than queueing behind it */
+            auto diskInfo = disks_.Find(device);
+            if (diskInfo != nullptr) {
+                (void)diskInfo->CancelWipe();
+            }
+            strands_.Post(device, [this, device] {
+                DestroyDisk(device);
+                LOGI("Handle Disk Remove Event");
+            });
             break;
         }
         default: {
@@ -84,109 +114,292 @@ void DiskManager::HandleDiskEvent(NetlinkData *data)
     }
 }
 
+void DiskManager::AddDisk(const std::string &sysPath, const std::string &devPath, dev_t device)
+{
+    if (GetDisk(device) != nullptr) {
+        LOGI("Disk already known, ignore add event");
+        return;
+    }
+    auto diskInfo = MatchConfig(sysPath, devPath, device);
+    if (diskInfo == nullptr) {
+        LOGE("Can't match config");
+        return;
+    }
+    CreateDisk(diskInfo);
+}
+
 std::shared_ptr<DiskInfo> DiskManager::MatchConfig(NetlinkData *data)
 {
-    std::string sysPath = data->GetSyspath();
-    std::string devPath = data->GetDevpath();
-    unsigned int major = (unsigned int) std::stoi(data->GetParam("MAJOR"));
-    unsigned int minor = (unsigned int) std::stoi(data->GetParam("MINOR"));
-    dev_t device = makedev(major, minor);
-
-    for (auto config : diskConfig_) {
-        if (config->IsMatch(devPath)) {
-            uint32_t flag = static_cast<uint32_t>(config->GetFlag());
-            if (major == DISK_MMC_MAJOR) {
-                flag |= DiskInfo::DeviceFlag::SD_FLAG;
-            } else {
-                flag |= DiskInfo::DeviceFlag::USB_FLAG;
-            }
-            auto diskInfo =  std::make_shared<DiskInfo>(sysPath, devPath, device, static_cast<int>(flag));
-            return diskInfo;
-        }
+    if (data->GetMajor() < 0 || data->GetMinor() < 0) {
+        return nullptr;
+    }
+    dev_t device = makedev(static_cast<unsigned int>(data->GetMajor()), static_cast<unsigned int>(data->GetMinor()));
+    return MatchConfig(data->GetSyspath(), data->GetDevpath(), device);
+}
+
+std::shared_ptr<DiskInfo> DiskManager::MatchConfig(const std::string &sysPath, const std::string &devPath,
+    dev_t device)
+{
+    std::shared_ptr<DiskConfig> config;
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        config = configs_.Match(devPath);
+    }
+    if (config == nullptr) {
+        return nullptr;
     }
 
-    return nullptr;
+    uint32_t flag = static_cast<uint32_t>(config->GetFlag());
+    if (major(device) == DISK_MMC_MAJOR) {
+        flag |= DiskInfo::DeviceFlag::SD_FLAG;
+    } else {
+        flag |= DiskInfo::DeviceFlag::USB_FLAG;
+    }
+    return std::make_shared<DiskInfo>(sysPath, devPath, device, static_cast<int>(flag));
 }
 
+/* Called on the disk's strand, so no other add of the same device slips in between the check and Add */
 void DiskManager::CreateDisk(std::shared_ptr<DiskInfo> &diskInfo)
 {
     int ret;
 
+    /* Create() makes the volumes, a duplicate would leave them behind unowned */
+    if (disks_.Find(diskInfo->GetDevice()) != nullptr) {
+        LOGW("Disk %{public}s already registered", diskInfo->GetId().c_str());
+        return;
+    }
+
     ret = diskInfo->Create();
     if (ret != E_OK) {
         LOGE("Create DiskInfo failed");
         return;
     }
 
-    disk_.push_back(diskInfo);
+    (void)disks_.Add(diskInfo);
+    UpdateIoSampler();
+}
+
+/* Each caller decides after its own Add/Remove, so the last one to get here sees the final count */
+void DiskManager::UpdateIoSampler()
+{
+    std::lock_guard<std::mutex> lock(samplerLock_);
+    if (disks_.Size() == 0) {
+        ioSampler_.Stop();
+    } else {
+        ioSampler_.Start();
+    }
 }
 
 void DiskManager::ChangeDisk(dev_t device)
 {
-    for (auto &diskInfo : disk_) {
-        if (diskInfo->GetDevice() == device) {
-            diskInfo->ReadMetadata();
-        }
+    auto diskInfo = disks_.Find(device);
+    if (diskInfo == nullptr) {
+        return;
+    }
+    diskInfo->ReadMetadata();
+    /* Volumes on partitions that did not change stay mounted */
+    if (diskInfo->Rescan() != E_OK) {
+        LOGE("Rescan %{public}s failed", diskInfo->GetId().c_str());
     }
 }
 
 void DiskManager::DestroyDisk(dev_t device)
 {
-    int ret;
+    auto diskInfo = disks_.Find(device);
+    if (diskInfo == nullptr) {
+        return;
+    }
 
-    for (auto i = disk_.begin(); i != disk_.end();) {
-        if ((*i)->GetDevice() == device) {
-            ret = (*i)->Destroy();
-            if (ret != E_OK) {
-                LOGE("Destroy DiskInfo failed");
-                return;
-            }
+    int ret = diskInfo->Destroy();
+    if (ret != E_OK) {
+        LOGE("Destroy DiskInfo failed");
+        return;
+    }
+    (void)disks_.Remove(device);
+    UpdateIoSampler();
 
-            StorageManagerClient client;
-            ret = client.NotifyDiskDestroyed((*i)->GetId());
-            if (ret != E_OK) {
-                LOGI("Notify Disk Destroyed failed");
-            }
-            i = disk_.erase(i);
-        } else {
-            i++;
-        }
+    StorageManagerClient client;
+    ret = client.NotifyDiskDestroyed(diskInfo->GetId());
+    if (ret != E_OK) {
+        LOGI("Notify Disk Destroyed failed");
     }
 }
 
 std::shared_ptr<DiskInfo> DiskManager::GetDisk(dev_t device)
 {
-    for (auto &diskInfo : disk_) {
-        if (diskInfo->GetDevice() == device) {
-            return diskInfo;
-        }
-    }
-    return nullptr;
+    return disks_.Find(device);
 }
 
 void DiskManager::AddDiskConfig(std::shared_ptr<DiskConfig> &diskConfig)
 {
     std::lock_guard<std::mutex> lock(lock_);
-    diskConfig_.push_back(diskConfig);
+    configs_.Add(diskConfig);
 }
 
+/*
+ * Ask the kernel to re-announce the disks that were probed before we started
+ * listening. Only /sys/block entries matching a disk config are triggered, so
+ * virtual devices and partitions do not flood the uevent queue at boot.
+ */
 void DiskManager::ReplayUevent()
 {
-    TraverseDirUevent(sysBlockPath_, true);
+    DiskConfigMatcher configs;
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        configs = configs_;
+    }
+
+    auto filter = [&configs](const std::string &devPath, int32_t depth) -> uint32_t {
+        return configs.Match(devPath) != nullptr ? WALK_TRIGGER : WALK_SKIP;
+    };
+
+    UeventWalkStats stats;
+    if (TriggerUeventTree(sysBlockPath_, filter, UEVENT_REPLAY_THREADS, stats) != E_OK) {
+        return;
+    }
+    LOGI("Replay uevent: visited %{public}u, triggered %{public}u, failed %{public}u, cost %{public}lld us",
+        stats.visited, stats.triggered, stats.failed, static_cast<long long>(stats.elapsedUs));
 }
 
-int32_t DiskManager::HandlePartition(std::string diskId)
+/*
+ * Collect the whole disks currently present under /sys/block as a synthetic
+ * "add" uevent per device, built from the device's own uevent attribute.
+ */
+static bool ScanSysBlock(const std::string &sysBlockPath, std::map<dev_t, std::string> &present)
 {
-    int32_t ret = E_NON_EXIST;
+    SysfsDir sysBlock(sysBlockPath);
+    if (!sysBlock.IsOpen()) {
+        LOGE("Open %{public}s failed, errno %{public}d", sysBlockPath.c_str(), errno);
+        return false;
+    }
+    /* List the entries through the same open directory the attributes are read from */
+    int32_t listFd = fcntl(sysBlock.Fd(), F_DUPFD_CLOEXEC, 0);
+    DIR *dir = listFd < 0 ? nullptr : fdopendir(listFd);
+    if (dir == nullptr) {
+        LOGE("List %{public}s failed, errno %{public}d", sysBlockPath.c_str(), errno);
+        if (listFd >= 0) {
+            close(listFd);
+        }
+        return false;
+    }
 
-    for (auto i = disk_.begin(); i != disk_.end(); i++) {
-        if ((*i)->GetId() == diskId) {
-            ret = (*i)->Partition();
-            break;
+    for (struct dirent *ent = readdir(dir); ent != nullptr; ent = readdir(dir)) {
+        if (ent->d_name[0] == '.') {
+            continue;
+        }
+
+        std::string path = sysBlockPath + "/" + ent->d_name;
+        std::string uevent;
+        char realPath[PATH_MAX] = { 0 };
+        if (sysBlock.Read((std::string(ent->d_name) + "/uevent").c_str(), uevent) != E_OK ||
+            realpath(path.c_str(), realPath) == nullptr) {
+            continue;
+        }
+
+        std::string devPath = realPath;
+        if (devPath.compare(0, strlen("/sys/"), "/sys/") == 0) {
+            devPath.erase(0, strlen("/sys"));
+        }
+        std::string msg = "add@" + devPath + '\0' + "ACTION=add" + '\0' + "DEVPATH=" + devPath + '\0' +
+            "SUBSYSTEM=block" + '\0' + uevent;
+        std::replace(msg.begin(), msg.end(), '\n', '\0');
+
+        NetlinkData data;
+        data.Decode(msg.data(), msg.size());
+        if (data.GetParam(NetlinkData::PARAM_DEVTYPE) != "disk" || data.GetMajor() < 0 || data.GetMinor() < 0) {
+            continue;
+        }
+        present[makedev(static_cast<unsigned int>(data.GetMajor()), static_cast<unsigned int>(data.GetMinor()))] =
+            std::move(msg);
+    }
+    closedir(dir);
+    return true;
+}
+
+int32_t PlanDiskResync(const std::string &sysBlockPath, const std::vector<dev_t> &known, DiskResyncPlan &plan)
+{
+    if (!ScanSysBlock(sysBlockPath, plan.added)) {
+        return E_ERR;
+    }
+    for (dev_t device : known) {
+        if (plan.added.erase(device) == 0) {
+            plan.removed.push_back(device);
         }
     }
+    return E_OK;
+}
+
+/*
+ * Bring the registry back in line with /sys/block after uevents were lost. Only the
+ * difference is applied: vanished disks are destroyed and unknown ones are
+ * created, disks present on both sides are left untouched.
+ */
+void DiskManager::Resync()
+{
+    /* Let queued disk work finish first so the diff sees its outcome */
+    strands_.WaitIdle();
+    std::vector<dev_t> known;
+    for (auto &diskInfo : disks_.Snapshot()) {
+        known.push_back(diskInfo->GetDevice());
+    }
+    DiskResyncPlan plan;
+    if (PlanDiskResync(sysBlockPath_, known, plan) != E_OK) {
+        return;
+    }
+
+    for (dev_t device : plan.removed) {
+        strands_.Post(device, [this, device] { DestroyDisk(device); });
+    }
+    for (auto &entry : plan.added) {
+        NetlinkData data;
+        data.Decode(entry.second.data(), entry.second.size());
+        std::string sysPath = data.GetSyspath();
+        std::string devPath = data.GetDevpath();
+        dev_t device = entry.first;
+        strands_.Post(device, [this, sysPath, devPath, device] { AddDisk(sysPath, devPath, device); });
+    }
+    LOGI("Resync queued %{public}zu disks to remove, %{public}zu to add", plan.removed.size(), plan.added.size());
+}
 
+int32_t DiskManager::GetDiskIoStats(const std::string &diskId, StorageManager::DiskIoStats &stats)
+{
+    if (disks_.FindById(diskId) == nullptr) {
+        return E_NON_EXIST;
+    }
+    /* A disk that was just added may not have been sampled yet */
+    int32_t ret = ioSampler_.Query(diskId, stats);
+    if (ret == E_NON_EXIST) {
+        stats.diskId_ = diskId;
+        stats.samples_ = 0;
+        return E_OK;
+    }
     return ret;
 }
+
+int32_t DiskManager::HandlePartition(std::string diskId, bool wipe, bool allowZeroOut)
+{
+    auto diskInfo = disks_.FindById(diskId);
+    if (diskInfo == nullptr) {
+        return E_NON_EXIST;
+    }
+
+    /* Ordered with the disk's own events, while other disks keep being handled */
+    auto result = std::make_shared<std::promise<int32_t>>();
+    auto future = result->get_future();
+    auto task = [diskInfo, result, wipe, allowZeroOut] { result->set_value(diskInfo->Partition(wipe, allowZeroOut)); };
+    if (!strands_.Post(diskInfo->GetDevice(), task)) {
+        return E_ERR;
+    }
+    return future.get();
+}
+
+int32_t DiskManager::CancelWipe(const std::string &diskId)
+{
+    auto diskInfo = disks_.FindById(diskId);
+    if (diskInfo == nullptr) {
+        return E_NON_EXIST;
+    }
+    return diskInfo->CancelWipe();
+}
 } // namespace STORAGE_DAEMON
 } // namespace OHOS
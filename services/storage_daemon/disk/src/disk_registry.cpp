@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "disk/disk_registry.h"
+
+#include <mutex>
+
+namespace OHOS {
+namespace StorageDaemon {
+bool DiskRegistry::Add(const std::shared_ptr<DiskInfo> &disk)
+{
+    std::unique_lock<std::shared_mutex> lock(lock_);
+    if (!byDevice_.emplace(disk->GetDevice(), disk).second) {
+        return false;
+    }
+    byId_[disk->GetId()] = disk;
+    return true;
+}
+
+std::shared_ptr<DiskInfo> DiskRegistry::Remove(dev_t device)
+{
+    std::unique_lock<std::shared_mutex> lock(lock_);
+    auto it = byDevice_.find(device);
+    if (it == byDevice_.end()) {
+        return nullptr;
+    }
+    auto disk = it->second;
+    byDevice_.erase(it);
+    byId_.erase(disk->GetId());
+    return disk;
+}
+
+std::shared_ptr<DiskInfo> DiskRegistry::Find(dev_t device) const
+{
+    std::shared_lock<std::shared_mutex> lock(lock_);
+    auto it = byDevice_.find(device);
+    return (it == byDevice_.end()) ? nullptr : it->second;
+}
+
+std::shared_ptr<DiskInfo> DiskRegistry::FindById(const std::string &id) const
+{
+    std::shared_lock<std::shared_mutex> lock(lock_);
+    auto it = byId_.find(id);
+    return (it == byId_.end()) ? nullptr : it->second;
+}
+
+std::vector<std::shared_ptr<DiskInfo>> DiskRegistry::Snapshot() const
+{
+    std::shared_lock<std::shared_mutex> lock(lock_);
+    std::vector<std::shared_ptr<DiskInfo>> disks;
+    disks.reserve(byDevice_.size());
+    for (auto &entry : byDevice_) {
+        disks.push_back(entry.second);
+    }
+    return disks;
+}
+
+size_t DiskRegistry::Size() const
+{
+    std::shared_lock<std::shared_mutex> lock(lock_);
+    return byDevice_.size();
+}
+} // STORAGE_DAEMON
+} // OHOS
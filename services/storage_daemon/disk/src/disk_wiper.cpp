@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disk/disk_wiper.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+#include "utils/sysfs_reader.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+DiskWiper::DiskWiper(uint32_t threads, uint64_t zeroOutLimit)
+    : threads_(std::max(threads, 1U)), zeroOutLimit_(zeroOutLimit)
+{
+}
+
+void DiskWiper::Cancel()
+{
+    cancelled_ = true;
+}
+
+int32_t DiskWiper::Wipe(const RangeOp &op, uint64_t size, uint64_t rangeBytes, DiskWipeMode mode,
+    DiskWipeReport &report, const Progress &progress)
+{
+    auto start = std::chrono::steady_clock::now();
+    report = DiskWipeReport();
+    report.mode = mode;
+    if (rangeBytes == 0) {
+        return E_ERR;
+    }
+    bool zeroOutAllowed = size <= zeroOutLimit_;
+    if (mode == WIPE_ZEROOUT && !zeroOutAllowed) {
+        LOGE("Zeroing out %{public}llu bytes needs an explicit request", static_cast<unsigned long long>(size));
+        return E_NOT_SUPPORT;
+    }
+
+    uint64_t count = (size + rangeBytes - 1) / rangeBytes;
+    std::atomic<uint64_t> next { 0 };
+    std::atomic<int32_t> current { mode };
+    std::atomic<int32_t> failure { 0 };
+    std::atomic<bool> refused { false };
+    std::mutex progressLock;
+    auto worker = [&] {
+        for (uint64_t i = next++; i < count && !cancelled_ && failure == 0; i = next++) {
+            uint64_t offset = i * rangeBytes;
+            uint64_t length = std::min(rangeBytes, size - offset);
+            auto rangeMode = static_cast<DiskWipeMode>(current.load());
+            int32_t err = op(rangeMode, offset, length);
+            if (err != 0 && rangeMode == WIPE_DISCARD && !zeroOutAllowed) {
+                if (!refused.exchange(true)) {
+                    LOGE("Discard failed, errno %{public}d, zeroing out %{public}llu bytes needs an explicit request",
+                        err, static_cast<unsigned long long>(size));
+                }
+                failure = err;
+                return;
+            }
+            if (err != 0 && rangeMode == WIPE_DISCARD) {
+                if (current.exchange(WIPE_ZEROOUT) == WIPE_DISCARD) {
+                    LOGI("Discard failed, errno %{public}d, zeroing out instead", err);
+                }
+                err = op(WIPE_ZEROOUT, offset, length);
+            }
+            if (err != 0) {
+                LOGE("Wipe range at %{public}llu failed, errno %{public}d", static_cast<unsigned long long>(offset),
+                    err);
+                failure = err;
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(progressLock);
+            report.bytes += length;
+            report.ranges++;
+            if (progress != nullptr) {
+                progress(report.bytes, size);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (uint64_t i = 1; i < std::min<uint64_t>(threads_, count); i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : workers) {
+        thread.join();
+    }
+
+    report.mode = static_cast<DiskWipeMode>(current.load());
+    report.cancelled = cancelled_ && report.bytes < size;
+    report.elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    if (failure != 0) {
+        return refused ? E_NOT_SUPPORT : E_ERR;
+    }
+    return report.cancelled ? E_CANCELED : E_OK;
+}
+
+int32_t DiskWiper::WipeDevice(const std::string &devPath, const std::string &sysPath, DiskWipeReport &report,
+    const Progress &progress)
+{
+    /* O_EXCL fails while anything on the disk is still mounted */
+    int32_t fd = TEMP_FAILURE_RETRY(open(devPath.c_str(), O_RDWR | O_EXCL | O_CLOEXEC));
+    if (fd < 0) {
+        LOGE("Open %{private}s failed, errno %{public}d", devPath.c_str(), errno);
+        return E_ERR;
+    }
+    uint64_t size = 0;
+    int32_t sectorSize = 0;
+    if (ioctl(fd, BLKGETSIZE64, &size) != 0 || ioctl(fd, BLKSSZGET, &sectorSize) != 0 || sectorSize <= 0) {
+        LOGE("Get size of %{private}s failed, errno %{public}d", devPath.c_str(), errno);
+        (void)close(fd);
+        return E_ERR;
+    }
+
+    int64_t discardMax = 0;
+    if (ReadSysfsInt(sysPath + "/queue/discard_max_bytes", discardMax) != E_OK) {
+        discardMax = 0;
+    }
+    DiskWipeMode mode = discardMax > 0 ? WIPE_DISCARD : WIPE_ZEROOUT;
+    uint64_t rangeBytes = DISK_WIPE_RANGE_BYTES;
+    if (mode == WIPE_DISCARD) {
+        uint64_t limit = static_cast<uint64_t>(discardMax);
+        rangeBytes = std::min(rangeBytes, std::max<uint64_t>(limit - limit % sectorSize, sectorSize));
+    }
+
+    auto op = [fd](DiskWipeMode rangeMode, uint64_t offset, uint64_t length) {
+        uint64_t range[2] = { offset, length };
+        return ioctl(fd, rangeMode == WIPE_DISCARD ? BLKDISCARD : BLKZEROOUT, range) == 0 ? 0 : errno;
+    };
+    int32_t ret = Wipe(op, size, rangeBytes, mode, report, progress);
+    (void)close(fd);
+
+    LOGI("Wipe %{private}s ret %{public}d, %{public}s %{public}llu of %{public}llu bytes in %{public}u ranges, "
+        "%{public}lld ms%{public}s", devPath.c_str(), ret, report.mode == WIPE_DISCARD ? "discard" : "zeroout",
+        static_cast<unsigned long long>(report.bytes), static_cast<unsigned long long>(size), report.ranges,
+        static_cast<long long>(report.elapsedUs / 1000), report.cancelled ? ", cancelled" : "");
+    return ret;
+}
+} // STORAGE_DAEMON
+} // OHOS
@@ -0,0 +1,528 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "disk/partition_table.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+
+#include <endian.h>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "securec.h"
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr uint32_t CRC32_POLY = 0xEDB88320;
+constexpr size_t CRC32_TABLE_SIZE = 256;
+
+constexpr size_t MBR_TABLE_OFFSET = 446;
+constexpr size_t MBR_SIGNATURE_OFFSET = 510;
+constexpr uint16_t MBR_SIGNATURE = 0xAA55;
+constexpr uint32_t MBR_PRIMARY_COUNT = 4;
+constexpr uint32_t MBR_FIRST_LOGICAL = 5;
+constexpr uint32_t MBR_MAX_LOGICAL = 256;
+constexpr uint8_t MBR_TYPE_EMPTY = 0x00;
+constexpr uint8_t MBR_TYPE_GPT_PROTECTIVE = 0xEE;
+constexpr uint8_t MBR_TYPE_EXTENDED[] = { 0x05, 0x0F, 0x85 };
+
+constexpr char GPT_SIGNATURE[] = "EFI PART";
+constexpr size_t GPT_SIGNATURE_LEN = 8;
+constexpr uint32_t GPT_HEADER_MIN_SIZE = 92;
+constexpr uint32_t GPT_ENTRY_SIZE = 128;
+constexpr uint32_t GPT_MAX_ENTRIES = 4096;
+constexpr uint64_t GPT_PRIMARY_LBA = 1;
+constexpr uint64_t GPT_ARRAY_BYTES = 16 * 1024;
+
+constexpr size_t MBR_DISK_ID_OFFSET = 440;
+constexpr uint64_t PARTITION_ALIGN_BYTES = 1024 * 1024;
+constexpr size_t DIRECT_IO_ALIGN = 4096;
+
+struct __attribute__((packed)) MbrEntry {
+    uint8_t status;
+    uint8_t chsFirst[3];
+    uint8_t type;
+    uint8_t chsLast[3];
+    uint32_t startLba;
+    uint32_t sectors;
+};
+
+struct __attribute__((packed)) GptHeader {
+    char signature[GPT_SIGNATURE_LEN];
+    uint32_t revision;
+    uint32_t headerSize;
+    uint32_t headerCrc;
+    uint32_t reserved;
+    uint64_t myLba;
+    uint64_t alternateLba;
+    uint64_t firstUsableLba;
+    uint64_t lastUsableLba;
+    uint8_t diskGuid[GPT_GUID_LEN];
+    uint64_t entryLba;
+    uint32_t entryCount;
+    uint32_t entrySize;
+    uint32_t entryCrc;
+};
+
+struct __attribute__((packed)) GptEntry {
+    uint8_t typeGuid[GPT_GUID_LEN];
+    uint8_t uniqueGuid[GPT_GUID_LEN];
+    uint64_t firstLba;
+    uint64_t lastLba;
+    uint64_t attributes;
+    uint16_t name[36];
+};
+
+static_assert(sizeof(MbrEntry) == 16, "MBR entry is 16 bytes");
+static_assert(sizeof(GptEntry) == GPT_ENTRY_SIZE, "GPT entry is 128 bytes");
+
+struct Crc32Table {
+    uint32_t values[CRC32_TABLE_SIZE];
+    constexpr Crc32Table() : values()
+    {
+        for (uint32_t i = 0; i < CRC32_TABLE_SIZE; i++) {
+            uint32_t crc = i;
+            for (int32_t bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ CRC32_POLY : crc >> 1;
+            }
+            values[i] = crc;
+        }
+    }
+};
+
+constexpr Crc32Table CRC32_TABLE;
+
+class SectorReader {
+public:
+    SectorReader(int32_t fd, uint32_t sectorSize) : fd_(fd), sectorSize_(sectorSize) {}
+
+    bool Read(uint64_t lba, uint64_t count, std::vector<uint8_t> &buf) const
+    {
+        size_t len = static_cast<size_t>(count * sectorSize_);
+        buf.resize(len);
+        size_t done = 0;
+        while (done < len) {
+            ssize_t n = TEMP_FAILURE_RETRY(pread(fd_, buf.data() + done, len - done,
+                static_cast<off_t>(lba * sectorSize_ + done)));
+            if (n <= 0) {
+                LOGE("Read lba %{public}llu failed, errno %{public}d", static_cast<unsigned long long>(lba), errno);
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    uint32_t SectorSize() const
+    {
+        return sectorSize_;
+    }
+
+private:
+    int32_t fd_;
+    uint32_t sectorSize_;
+};
+
+bool IsExtended(uint8_t type)
+{
+    for (auto extended : MBR_TYPE_EXTENDED) {
+        if (type == extended) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReadMbrEntries(const std::vector<uint8_t> &sector, MbrEntry (&entries)[MBR_PRIMARY_COUNT])
+{
+    uint16_t signature = 0;
+    (void)memcpy_s(&signature, sizeof(signature), sector.data() + MBR_SIGNATURE_OFFSET, sizeof(signature));
+    if (le16toh(signature) != MBR_SIGNATURE) {
+        return false;
+    }
+    (void)memcpy_s(entries, sizeof(entries), sector.data() + MBR_TABLE_OFFSET, sizeof(entries));
+    for (auto &entry : entries) {
+        entry.startLba = le32toh(entry.startLba);
+        entry.sectors = le32toh(entry.sectors);
+    }
+    return true;
+}
+
+bool ReadGptHeader(const SectorReader &reader, uint64_t lba, uint64_t lastLba, GptHeader &header)
+{
+    std::vector<uint8_t> sector;
+    if (!reader.Read(lba, 1, sector)) {
+        return false;
+    }
+    (void)memcpy_s(&header, sizeof(header), sector.data(), sizeof(header));
+    uint32_t headerSize = le32toh(header.headerSize);
+    if (memcmp(header.signature, GPT_SIGNATURE, GPT_SIGNATURE_LEN) != 0 ||
+        headerSize < GPT_HEADER_MIN_SIZE || headerSize > reader.SectorSize()) {
+        return false;
+    }
+
+    uint32_t crc = le32toh(header.headerCrc);
+    (void)memset_s(sector.data() + offsetof(GptHeader, headerCrc), sizeof(uint32_t), 0, sizeof(uint32_t));
+    if (PartitionCrc32(sector.data(), headerSize) != crc) {
+        LOGE("GPT header at lba %{public}llu has a bad crc", static_cast<unsigned long long>(lba));
+        return false;
+    }
+
+    header.myLba = le64toh(header.myLba);
+    header.alternateLba = le64toh(header.alternateLba);
+    header.firstUsableLba = le64toh(header.firstUsableLba);
+    header.lastUsableLba = le64toh(header.lastUsableLba);
+    header.entryLba = le64toh(header.entryLba);
+    header.entryCount = le32toh(header.entryCount);
+    header.entrySize = le32toh(header.entrySize);
+    header.entryCrc = le32toh(header.entryCrc);
+    return header.myLba == lba && header.firstUsableLba <= header.lastUsableLba &&
+        header.lastUsableLba <= lastLba && header.entrySize == GPT_ENTRY_SIZE &&
+        header.entryCount > 0 && header.entryCount <= GPT_MAX_ENTRIES && header.entryLba <= lastLba;
+}
+
+bool ReadGpt(const SectorReader &reader, uint64_t lba, uint64_t lastLba, PartitionTable &table)
+{
+    GptHeader header;
+    if (!ReadGptHeader(reader, lba, lastLba, header)) {
+        return false;
+    }
+
+    uint64_t arrayLen = static_cast<uint64_t>(header.entryCount) * header.entrySize;
+    uint64_t arraySectors = (arrayLen + reader.SectorSize() - 1) / reader.SectorSize();
+    std::vector<uint8_t> array;
+    if (header.entryLba + arraySectors > lastLba + 1 || !reader.Read(header.entryLba, arraySectors, array)) {
+        return false;
+    }
+    if (PartitionCrc32(array.data(), static_cast<size_t>(arrayLen)) != header.entryCrc) {
+        LOGE("GPT entries at lba %{public}llu have a bad crc", static_cast<unsigned long long>(header.entryLba));
+        return false;
+    }
+
+    static const std::array<uint8_t, GPT_GUID_LEN> unused {};
+    table.entries.clear();
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        GptEntry entry;
+        (void)memcpy_s(&entry, sizeof(entry), array.data() + static_cast<size_t>(i) * header.entrySize, sizeof(entry));
+        uint64_t first = le64toh(entry.firstLba);
+        uint64_t last = le64toh(entry.lastLba);
+        if (memcmp(entry.typeGuid, unused.data(), GPT_GUID_LEN) == 0 || first > last || last > lastLba) {
+            continue;
+        }
+        PartitionEntry part;
+        part.index = i + 1;
+        part.startLba = first;
+        part.sectors = last - first + 1;
+        (void)memcpy_s(part.typeGuid.data(), part.typeGuid.size(), entry.typeGuid, GPT_GUID_LEN);
+        table.entries.push_back(part);
+    }
+    table.type = TABLE_GPT;
+    return true;
+}
+
+class AlignedBuffer {
+public:
+    explicit AlignedBuffer(size_t size) : size_(size)
+    {
+        void *data = nullptr;
+        if (posix_memalign(&data, DIRECT_IO_ALIGN, size) != 0) {
+            LOGE("Alloc %{public}zu bytes failed", size);
+            return;
+        }
+        data_ = static_cast<uint8_t *>(data);
+        (void)memset_s(data_, size_, 0, size_);
+    }
+    ~AlignedBuffer()
+    {
+        free(data_);
+    }
+    uint8_t *Data() const
+    {
+        return data_;
+    }
+    size_t Size() const
+    {
+        return size_;
+    }
+
+private:
+    uint8_t *data_ { nullptr };
+    size_t size_;
+};
+
+bool WriteFull(int32_t fd, const uint8_t *buf, size_t len, uint64_t offset)
+{
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = TEMP_FAILURE_RETRY(pwrite(fd, buf + done, len - done, static_cast<off_t>(offset + done)));
+        if (n <= 0) {
+            LOGE("Write at %{public}llu failed, errno %{public}d", static_cast<unsigned long long>(offset), errno);
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int32_t GetGeometry(int32_t fd, uint64_t &size, uint32_t &sectorSize, bool &isBlock)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        LOGE("Stat disk failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+    isBlock = S_ISBLK(st.st_mode);
+    if (!isBlock) {
+        size = static_cast<uint64_t>(st.st_size);
+        sectorSize = DEFAULT_SECTOR_SIZE;
+        return E_OK;
+    }
+    int32_t logical = 0;
+    if (ioctl(fd, BLKGETSIZE64, &size) != 0 || ioctl(fd, BLKSSZGET, &logical) != 0 || logical <= 0) {
+        LOGE("Get disk size failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+    sectorSize = static_cast<uint32_t>(logical);
+    return E_OK;
+}
+
+void ReadLogical(const SectorReader &reader, uint64_t extStart, uint64_t lastLba, PartitionTable &table)
+{
+    uint64_t ebrLba = extStart;
+    uint32_t index = MBR_FIRST_LOGICAL;
+    std::vector<uint8_t> sector;
+    for (uint32_t i = 0; i < MBR_MAX_LOGICAL && ebrLba <= lastLba; i++) {
+        MbrEntry entries[MBR_PRIMARY_COUNT];
+        if (!reader.Read(ebrLba, 1, sector) || !ReadMbrEntries(sector, entries)) {
+            return;
+        }
+        const MbrEntry &logical = entries[0];
+        if (logical.type != MBR_TYPE_EMPTY && logical.sectors != 0) {
+            PartitionEntry part;
+            part.index = index++;
+            part.startLba = ebrLba + logical.startLba;
+            part.sectors = logical.sectors;
+            part.mbrType = logical.type;
+            table.entries.push_back(part);
+        }
+        const MbrEntry &next = entries[1];
+        if (!IsExtended(next.type) || next.startLba == 0) {
+            return;
+        }
+        ebrLba = extStart + next.startLba;
+    }
+}
+} // namespace
+
+uint32_t PartitionCrc32(const void *data, size_t len)
+{
+    auto bytes = static_cast<const uint8_t *>(data);
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc = CRC32_TABLE.values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+bool SamePartition(const PartitionEntry &a, const PartitionEntry &b)
+{
+    return a.index == b.index && a.startLba == b.startLba && a.sectors == b.sectors && a.mbrType == b.mbrType &&
+        a.typeGuid == b.typeGuid;
+}
+
+void DiffPartitionEntries(const std::vector<PartitionEntry> &before, const std::vector<PartitionEntry> &after,
+    std::vector<size_t> &removed, std::vector<size_t> &added)
+{
+    removed.clear();
+    added.clear();
+    auto contains = [](const std::vector<PartitionEntry> &entries, const PartitionEntry &entry) {
+        return std::any_of(entries.begin(), entries.end(),
+            [&entry](const PartitionEntry &other) { return SamePartition(entry, other); });
+    };
+    for (size_t i = 0; i < before.size(); i++) {
+        if (!contains(after, before[i])) {
+            removed.push_back(i);
+        }
+    }
+    for (size_t i = 0; i < after.size(); i++) {
+        if (!contains(before, after[i])) {
+            added.push_back(i);
+        }
+    }
+}
+
+int32_t ReadPartitionTable(int32_t fd, uint64_t diskSize, uint32_t sectorSize, PartitionTable &table)
+{
+    table = PartitionTable();
+    table.sectorSize = sectorSize;
+    if (sectorSize < DEFAULT_SECTOR_SIZE || diskSize < static_cast<uint64_t>(sectorSize) * 2) {
+        return E_ERR;
+    }
+    uint64_t lastLba = diskSize / sectorSize - 1;
+
+    SectorReader reader(fd, sectorSize);
+    std::vector<uint8_t> sector;
+    if (!reader.Read(0, 1, sector)) {
+        return E_ERR;
+    }
+    MbrEntry entries[MBR_PRIMARY_COUNT];
+    if (!ReadMbrEntries(sector, entries)) {
+        return E_OK;
+    }
+
+    for (const auto &entry : entries) {
+        if (entry.type != MBR_TYPE_GPT_PROTECTIVE) {
+            continue;
+        }
+        if (ReadGpt(reader, GPT_PRIMARY_LBA, lastLba, table)) {
+            return E_OK;
+        }
+        LOGW("Primary GPT is invalid, trying the backup");
+        if (!ReadGpt(reader, lastLba, lastLba, table)) {
+            LOGE("No valid GPT behind the protective MBR");
+        }
+        return E_OK;
+    }
+
+    bool extendedSeen = false;
+    for (uint32_t i = 0; i < MBR_PRIMARY_COUNT; i++) {
+        const MbrEntry &entry = entries[i];
+        if (entry.type == MBR_TYPE_EMPTY || entry.sectors == 0) {
+            continue;
+        }
+        if (IsExtended(entry.type)) {
+            if (!extendedSeen) {
+                extendedSeen = true;
+                ReadLogical(reader, entry.startLba, lastLba, table);
+            }
+            continue;
+        }
+        PartitionEntry part;
+        part.index = i + 1;
+        part.startLba = entry.startLba;
+        part.sectors = entry.sectors;
+        part.mbrType = entry.type;
+        table.entries.push_back(part);
+    }
+    table.type = TABLE_MBR;
+    return E_OK;
+}
+
+int32_t ReadPartitionTable(const std::string &devPath, PartitionTable &table)
+{
+    int32_t fd = TEMP_FAILURE_RETRY(open(devPath.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0) {
+        LOGE("Open %{private}s failed, errno %{public}d", devPath.c_str(), errno);
+        return E_ERR;
+    }
+
+    uint64_t size = 0;
+    uint32_t sectorSize = DEFAULT_SECTOR_SIZE;
+    bool isBlock = false;
+    int32_t ret = GetGeometry(fd, size, sectorSize, isBlock);
+    if (ret == E_OK) {
+        ret = ReadPartitionTable(fd, size, sectorSize, table);
+    }
+    (void)close(fd);
+    return ret;
+}
+
+int32_t WriteSinglePartitionTable(int32_t fd, uint64_t diskSize, uint32_t sectorSize, uint8_t mbrType)
+{
+    if (sectorSize < DEFAULT_SECTOR_SIZE || PARTITION_ALIGN_BYTES % sectorSize != 0) {
+        LOGE("Unsupported sector size %{public}u", sectorSize);
+        return E_ERR;
+    }
+    uint64_t totalSectors = diskSize / sectorSize;
+    uint64_t headSectors = PARTITION_ALIGN_BYTES / sectorSize;
+    uint64_t tailSectors = 1 + (GPT_ARRAY_BYTES + sectorSize - 1) / sectorSize;
+    if (totalSectors <= headSectors + tailSectors) {
+        LOGE("Disk of %{public}llu bytes is too small to partition", static_cast<unsigned long long>(diskSize));
+        return E_ERR;
+    }
+
+    /* Like sgdisk --new=0:0:-0 --gpttombr, the partition ends before the backup GPT area */
+    uint64_t start = headSectors;
+    uint64_t sectors = std::min<uint64_t>(totalSectors - tailSectors - start, UINT32_MAX - start);
+
+    AlignedBuffer head(PARTITION_ALIGN_BYTES);
+    AlignedBuffer tail(static_cast<size_t>(tailSectors * sectorSize));
+    if (head.Data() == nullptr || tail.Data() == nullptr) {
+        return E_ERR;
+    }
+    uint8_t *mbr = head.Data();
+    uint32_t diskId = htole32(static_cast<uint32_t>(
+        std::chrono::system_clock::now().time_since_epoch().count()));
+    (void)memcpy_s(mbr + MBR_DISK_ID_OFFSET, sizeof(diskId), &diskId, sizeof(diskId));
+    MbrEntry entry = { 0, { 0xFE, 0xFF, 0xFF }, mbrType, { 0xFE, 0xFF, 0xFF },
+        htole32(static_cast<uint32_t>(start)), htole32(static_cast<uint32_t>(sectors)) };
+    (void)memcpy_s(mbr + MBR_TABLE_OFFSET, sizeof(entry), &entry, sizeof(entry));
+    uint16_t signature = htole16(MBR_SIGNATURE);
+    (void)memcpy_s(mbr + MBR_SIGNATURE_OFFSET, sizeof(signature), &signature, sizeof(signature));
+
+    /* Tail first, so an interrupted write never leaves a new MBR in front of a stale backup GPT */
+    if (!WriteFull(fd, tail.Data(), tail.Size(), (totalSectors - tailSectors) * sectorSize) ||
+        !WriteFull(fd, head.Data(), head.Size(), 0)) {
+        return E_ERR;
+    }
+    if (TEMP_FAILURE_RETRY(fsync(fd)) != 0) {
+        LOGE("Sync partition table failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+    return E_OK;
+}
+
+int32_t WriteSinglePartitionTable(const std::string &devPath, uint8_t mbrType)
+{
+    auto start = std::chrono::steady_clock::now();
+    int32_t fd = TEMP_FAILURE_RETRY(open(devPath.c_str(), O_RDWR | O_DIRECT | O_CLOEXEC));
+    if (fd < 0 && errno == EINVAL) {
+        fd = TEMP_FAILURE_RETRY(open(devPath.c_str(), O_RDWR | O_CLOEXEC));
+    }
+    if (fd < 0) {
+        LOGE("Open %{private}s failed, errno %{public}d", devPath.c_str(), errno);
+        return E_ERR;
+    }
+
+    uint64_t size = 0;
+    uint32_t sectorSize = DEFAULT_SECTOR_SIZE;
+    bool isBlock = false;
+    int32_t ret = GetGeometry(fd, size, sectorSize, isBlock);
+    if (ret == E_OK) {
+        ret = WriteSinglePartitionTable(fd, size, sectorSize, mbrType);
+    }
+    auto written = std::chrono::steady_clock::now();
+    if (ret == E_OK && isBlock && ioctl(fd, BLKRRPART, nullptr) != 0) {
+        LOGE("Reread partition table of %{private}s failed, errno %{public}d", devPath.c_str(), errno);
+        ret = E_ERR;
+    }
+    (void)close(fd);
+
+    auto done = std::chrono::steady_clock::now();
+    LOGI("Partition %{private}s ret %{public}d, write %{public}lld us, reread %{public}lld us", devPath.c_str(), ret,
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(written - start).count()),
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(done - written).count()));
+    return ret;
+}
+} // StorageDaemon
+} // OHOS
@@ -13,16 +13,50 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "storage_service_errno.h"
 #include "storage_service_log.h"
 #include "disk/disk_config.h"
+#include "disk/disk_config_matcher.h"
 
 namespace OHOS {
 namespace StorageDaemon {
 using namespace testing::ext;
 
+namespace {
+/* Patterns as they appear in config.txt, plus a few shapes the trie has to handle */
+const std::vector<std::string> PATTERNS = {
+    "/devices/platform/fe2b0000.dwmmc/*",
+    "/devices/platform/fe800000.usb/*",
+    "/devices/platform/fe900000.usb/*",
+    "/devices/platform/usbhost*/block/sd[a-c]",
+    "/devices/platform/soc/*.sdhci/mmc_host/mmc?/*",
+    "/devices/virtual/block/loop0",
+    "/devices/pci0000:00/*/usb?/*",
+    "/devices/platform/fe2b0000.dwmmc/mmc_host/mmc1/*",
+};
+
+const std::vector<std::string> DEV_PATHS = {
+    "/devices/platform/fe2b0000.dwmmc/mmc_host/mmc1/mmc1:0001/block/mmcblk1",
+    "/devices/platform/fe800000.usb/usb1/1-1/1-1:1.0/host0/target0:0:0/0:0:0:0/block/sda",
+    "/devices/platform/fe900000.usb/usb2/2-1/block/sdb",
+    "/devices/platform/usbhost0/block/sdb",
+    "/devices/platform/usbhost0/block/sdd",
+    "/devices/platform/soc/fe310000.sdhci/mmc_host/mmc0/mmc0:0001/block/mmcblk0",
+    "/devices/virtual/block/loop0",
+    "/devices/virtual/block/loop1",
+    "/devices/virtual/block/dm-0",
+    "/devices/pci0000:00/0000:00:14.0/usb3/3-2/block/sdc",
+    "/devices/platform",
+    "",
+};
+}
+
 class DiskConfigTest : public testing::Test {
 public:
     static void SetUpTestCase(void) {};
@@ -66,5 +100,88 @@ HWTEST_F(DiskConfigTest, Storage_Service_DiskManagerTest_GetFlag_001, TestSize.L
     EXPECT_TRUE(ret == flag);
     GTEST_LOG_(INFO) << "Storage_Service_DiskManagerTest_GetFlag_001 end";
 }
+
+/**
+ * @tc.name: Storage_Service_DiskConfigTest_Match_001
+ * @tc.desc: Verify the compiled matcher picks the same config as trying IsMatch in config order.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskConfigTest, Storage_Service_DiskConfigTest_Match_001, TestSize.Level1)
+{
+    std::vector<std::shared_ptr<DiskConfig>> configs;
+    DiskConfigMatcher matcher;
+    for (size_t i = 0; i < PATTERNS.size(); i++) {
+        configs.push_back(std::make_shared<DiskConfig>(PATTERNS[i], "disk" + std::to_string(i), i));
+        matcher.Add(configs.back());
+    }
+    EXPECT_EQ(matcher.Size(), PATTERNS.size());
+
+    for (auto &path : DEV_PATHS) {
+        std::shared_ptr<DiskConfig> expect;
+        for (auto &config : configs) {
+            if (config->IsMatch(path)) {
+                expect = config;
+                break;
+            }
+        }
+        EXPECT_EQ(matcher.Match(path), expect) << path;
+    }
+
+    /* The dwmmc wildcard was added first, so it wins over the more specific mmc1 entry */
+    auto config = matcher.Match(DEV_PATHS[0]);
+    ASSERT_NE(config, nullptr);
+    EXPECT_EQ(config->GetLabel(), "disk0");
+    EXPECT_EQ(config->GetFlag(), 0);
+    EXPECT_EQ(matcher.Match("/devices/virtual/block/loop0")->GetLabel(), "disk5");
+    EXPECT_EQ(matcher.Match("/devices/virtual/block/loop"), nullptr);
+    EXPECT_EQ(DiskConfigMatcher().Match(DEV_PATHS[0]), nullptr);
+}
+
+/**
+ * @tc.name: Storage_Service_DiskConfigTest_Benchmark_001
+ * @tc.desc: Compare the per-event cost of the compiled matcher with the per-config fnmatch loop.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskConfigTest, Storage_Service_DiskConfigTest_Benchmark_001, TestSize.Level3)
+{
+    const int32_t rounds = 20000;
+    std::vector<std::shared_ptr<DiskConfig>> configs;
+    DiskConfigMatcher matcher;
+    for (auto &pattern : PATTERNS) {
+        configs.push_back(std::make_shared<DiskConfig>(pattern, "disk", 0));
+        matcher.Add(configs.back());
+    }
+
+    size_t loopHits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < rounds; i++) {
+        for (auto &path : DEV_PATHS) {
+            for (auto &config : configs) {
+                if (config->IsMatch(path)) {
+                    loopHits++;
+                    break;
+                }
+            }
+        }
+    }
+    auto loopNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    size_t matchHits = 0;
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < rounds; i++) {
+        for (auto &path : DEV_PATHS) {
+            matchHits += matcher.Match(path) != nullptr ? 1 : 0;
+        }
+    }
+    auto matchNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    double lookups = static_cast<double>(rounds) * DEV_PATHS.size();
+    GTEST_LOG_(INFO) << "fnmatch loop " << loopNs.count() / lookups << " ns/event, matcher "
+                     << matchNs.count() / lookups << " ns/event";
+    EXPECT_EQ(loopHits, matchHits);
+    EXPECT_LT(matchNs, loopNs);
+}
+}
 }
-}
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include "disk_info_test_mock.h"
 #include "utils/string_utils.h"
 #include "utils/file_utils.h"
+#include "utils/sysfs_reader.h"
 
 namespace OHOS {
 namespace StorageDaemon {
@@ -558,7 +559,7 @@ HWTEST_F(DiskInfoTest, Storage_Service_DiskInfoTest_GetDevVendor_001, TestSize.L
     int flag = 0;
     std::string path(sysPath + "/device/manfid");
     std::string str;
-    ReadFile(path, &str);
+    (void)ReadSysfsAttr(path, str);
     auto mock = std::make_shared<DiskInfoTestMock>(sysPath, devPath, device, flag);
 
     EXPECT_CALL(*mock, GetDevVendor()).WillOnce(testing::Return(str));
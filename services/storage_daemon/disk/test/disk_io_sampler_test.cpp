@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "disk/disk_io_sampler.h"
+#include "storage_service_errno.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_DIR = "/data/disk_io_sampler_test";
+const std::string DISK_ID = "disk-8-0";
+
+void WriteAttr(const std::string &name, const std::string &content)
+{
+    int fd = open((TEST_DIR + "/" + name).c_str(), O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    close(fd);
+}
+
+std::string Stat(uint64_t readIos, uint64_t readSectors, uint64_t readTicks, uint64_t writeIos,
+    uint64_t writeSectors, uint64_t writeTicks, uint64_t ioTicks)
+{
+    char buf[256];
+    (void)snprintf(buf, sizeof(buf), "%8llu 0 %8llu %8llu %8llu 0 %8llu %8llu 0 %8llu %8llu 0 0 0 0\n",
+        static_cast<unsigned long long>(readIos), static_cast<unsigned long long>(readSectors),
+        static_cast<unsigned long long>(readTicks), static_cast<unsigned long long>(writeIos),
+        static_cast<unsigned long long>(writeSectors), static_cast<unsigned long long>(writeTicks),
+        static_cast<unsigned long long>(ioTicks), static_cast<unsigned long long>(readTicks + writeTicks));
+    return buf;
+}
+}
+
+class DiskIoSamplerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp()
+    {
+        system(("rm -rf " + TEST_DIR).c_str());
+        ASSERT_EQ(system(("mkdir -p " + TEST_DIR).c_str()), 0);
+        disks_ = { { DISK_ID, TEST_DIR } };
+    };
+    void TearDown()
+    {
+        system(("rm -rf " + TEST_DIR).c_str());
+    };
+
+    std::vector<std::pair<std::string, std::string>> disks_;
+};
+
+/**
+ * @tc.name: DiskIoSamplerTest_Parse_001
+ * @tc.desc: Verify the stat and inflight attributes are parsed, and short input is rejected.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskIoSamplerTest, DiskIoSamplerTest_Parse_001, TestSize.Level1)
+{
+    DiskIoSample sample = {};
+    EXPECT_TRUE(ParseDiskStat(Stat(100, 800, 50, 20, 4096, 300, 340), sample));
+    EXPECT_EQ(sample.readIos, 100);
+    EXPECT_EQ(sample.readSectors, 800);
+    EXPECT_EQ(sample.readTicks, 50);
+    EXPECT_EQ(sample.writeIos, 20);
+    EXPECT_EQ(sample.writeSectors, 4096);
+    EXPECT_EQ(sample.writeTicks, 300);
+    EXPECT_EQ(sample.ioTicks, 340);
+
+    EXPECT_TRUE(ParseDiskInflight("       3        7\n", sample));
+    EXPECT_EQ(sample.inflightRead, 3);
+    EXPECT_EQ(sample.inflightWrite, 7);
+
+    EXPECT_FALSE(ParseDiskStat("1 2 3 4 5", sample));
+    EXPECT_FALSE(ParseDiskStat("", sample));
+    EXPECT_FALSE(ParseDiskInflight("1", sample));
+}
+
+/**
+ * @tc.name: DiskIoSamplerTest_Derive_001
+ * @tc.desc: Verify throughput, IOPS, latency and utilisation derived from two samples.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskIoSamplerTest, DiskIoSamplerTest_Derive_001, TestSize.Level1)
+{
+    DiskIoSample first = { 1000, 100, 800, 50, 20, 4096, 300, 340, 0, 0 };
+    DiskIoSample last = { 3000, 300, 2400, 250, 60, 12288, 1100, 1340, 1, 2 };
+    StorageManager::DiskIoStats stats;
+    DeriveDiskIoStats(first, last, stats);
+
+    EXPECT_EQ(stats.windowMs_, 2000);
+    EXPECT_DOUBLE_EQ(stats.readIops_, 100);
+    EXPECT_DOUBLE_EQ(stats.writeIops_, 20);
+    EXPECT_DOUBLE_EQ(stats.readBytesPerSec_, 1600 * 512 / 2);
+    EXPECT_DOUBLE_EQ(stats.writeBytesPerSec_, 8192 * 512 / 2);
+    EXPECT_DOUBLE_EQ(stats.readLatencyUs_, 1000);
+    EXPECT_DOUBLE_EQ(stats.writeLatencyUs_, 20000);
+    EXPECT_DOUBLE_EQ(stats.utilPercent_, 50);
+    EXPECT_EQ(stats.inflightRead_, 1);
+    EXPECT_EQ(stats.inflightWrite_, 2);
+
+    StorageManager::DiskIoStats idle;
+    DeriveDiskIoStats(first, first, idle);
+    EXPECT_EQ(idle.windowMs_, 0);
+    EXPECT_DOUBLE_EQ(idle.readIops_, 0);
+}
+
+/**
+ * @tc.name: DiskIoSamplerTest_Sample_001
+ * @tc.desc: Verify sampling the known disks, resets on counters going backwards and dropping removed disks.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskIoSamplerTest, DiskIoSamplerTest_Sample_001, TestSize.Level1)
+{
+    DiskIoSampler sampler([this] { return disks_; });
+    StorageManager::DiskIoStats stats;
+    EXPECT_EQ(sampler.Query(DISK_ID, stats), E_NON_EXIST);
+
+    WriteAttr("stat", Stat(100, 800, 50, 20, 4096, 300, 340));
+    WriteAttr("inflight", "0 1\n");
+    sampler.SampleOnce();
+    EXPECT_EQ(sampler.Query(DISK_ID, stats), E_OK);
+    EXPECT_EQ(stats.diskId_, DISK_ID);
+    EXPECT_EQ(stats.samples_, 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    WriteAttr("stat", Stat(200, 1600, 150, 20, 4096, 300, 440));
+    sampler.SampleOnce();
+    EXPECT_EQ(sampler.Query(DISK_ID, stats), E_OK);
+    EXPECT_EQ(stats.samples_, 2);
+    EXPECT_GT(stats.windowMs_, 0);
+    EXPECT_GT(stats.readIops_, 0);
+    EXPECT_DOUBLE_EQ(stats.writeIops_, 0);
+    EXPECT_DOUBLE_EQ(stats.readLatencyUs_, 1000);
+    EXPECT_EQ(stats.inflightWrite_, 1);
+
+    WriteAttr("stat", Stat(5, 40, 5, 0, 0, 0, 5));
+    sampler.SampleOnce();
+    EXPECT_EQ(sampler.Query(DISK_ID, stats), E_OK);
+    EXPECT_EQ(stats.samples_, 1);
+
+    disks_.clear();
+    sampler.SampleOnce();
+    EXPECT_EQ(sampler.Query(DISK_ID, stats), E_NON_EXIST);
+}
+
+/**
+ * @tc.name: DiskIoSamplerTest_Thread_001
+ * @tc.desc: Verify the sampling thread fills the ring on its own and stops promptly.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskIoSamplerTest, DiskIoSamplerTest_Thread_001, TestSize.Level1)
+{
+    WriteAttr("stat", Stat(100, 800, 50, 20, 4096, 300, 340));
+    DiskIoSampler sampler([this] { return disks_; }, std::chrono::milliseconds(5));
+    sampler.Start();
+    sampler.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto start = std::chrono::steady_clock::now();
+    sampler.Stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+
+    StorageManager::DiskIoStats stats;
+    EXPECT_EQ(sampler.Query(DISK_ID, stats), E_OK);
+    EXPECT_GT(stats.samples_, 1);
+    EXPECT_LE(stats.samples_, DISK_IO_RING_SIZE);
+}
+
+/**
+ * @tc.name: DiskIoSamplerTest_Thread_002
+ * @tc.desc: Verify a stopped sampler can be started again and begins with fresh rings.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskIoSamplerTest, DiskIoSamplerTest_Thread_002, TestSize.Level1)
+{
+    WriteAttr("stat", Stat(100, 800, 50, 20, 4096, 300, 340));
+    DiskIoSampler sampler([this] { return disks_; }, std::chrono::milliseconds(5));
+    sampler.Stop();
+    sampler.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sampler.Stop();
+
+    StorageManager::DiskIoStats stats;
+    ASSERT_EQ(sampler.Query(DISK_ID, stats), E_OK);
+    uint32_t before = stats.samples_;
+    EXPECT_GT(before, 1u);
+
+    sampler.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sampler.Stop();
+    ASSERT_EQ(sampler.Query(DISK_ID, stats), E_OK);
+    EXPECT_GE(stats.samples_, 1u);
+    EXPECT_LT(stats.samples_, before);
+}
+
+/**
+ * @tc.name: DiskIoSamplerTest_Benchmark_001
+ * @tc.desc: Measure the cost of one sampling round per disk.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskIoSamplerTest, DiskIoSamplerTest_Benchmark_001, TestSize.Level3)
+{
+    const int32_t rounds = 5000;
+    WriteAttr("stat", Stat(100, 800, 50, 20, 4096, 300, 340));
+    WriteAttr("inflight", "0 0\n");
+    DiskIoSampler sampler([this] { return disks_; });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < rounds; i++) {
+        sampler.SampleOnce();
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    GTEST_LOG_(INFO) << "sampling costs " << ns.count() / rounds << " ns per disk and round";
+
+    StorageManager::DiskIoStats stats;
+    EXPECT_EQ(sampler.Query(DISK_ID, stats), E_OK);
+    EXPECT_EQ(stats.samples_, DISK_IO_RING_SIZE);
+    /* One round a second must stay far below a millisecond of CPU */
+    EXPECT_LT(ns / rounds, std::chrono::microseconds(100));
+}
+} // namespace StorageDaemon
+} // namespace OHOS
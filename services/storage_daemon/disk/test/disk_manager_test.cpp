@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <sys/sysmacros.h>
+#include <unistd.h>
 #include <fstream>
 
 #include "storage_service_errno.h"
@@ -25,6 +26,7 @@
 #include "netlink/netlink_data.h"
 #include "volume/external_volume_info.h"
 
+#include "utils/file_utils.h"
 #include "utils/string_utils.h"
 
 namespace OHOS {
@@ -386,6 +388,56 @@ HWTEST_F(DiskManagerTest, Storage_Service_DiskManagerTest_ReplayUevent_001, Test
     GTEST_LOG_(INFO) << "Storage_Service_DiskManagerTest_ReplayUevent_001 end";
 }
 
+/* Adds a whole disk to a fake sysfs tree the way the kernel links it under block/ */
+static void MakeFakeSysDisk(const std::string &root, const std::string &name, int major, int minor)
+{
+    std::string devDir = root + "/devices/" + name;
+    MkDirRecurse(devDir, S_IRWXU);
+    std::ofstream(devDir + "/uevent") << "MAJOR=" << major << "\nMINOR=" << minor << "\nDEVNAME=" << name <<
+        "\nDEVTYPE=disk\n";
+    (void)symlink(("../devices/" + name).c_str(), (root + "/block/" + name).c_str());
+}
+
+/**
+ * @tc.name: Storage_Service_DiskManagerTest_Resync_001
+ * @tc.desc: Verify a resync adds the disks new in sysfs, removes the stale ones and keeps the rest.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskManagerTest, Storage_Service_DiskManagerTest_Resync_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "Storage_Service_DiskManagerTest_Resync_001 start";
+
+    const std::string root = "/data/disk_resync_test";
+    (void)RmDirRecurse(root);
+    MkDirRecurse(root + "/block", S_IRWXU);
+    MakeFakeSysDisk(root, "sdx", 8, 0);
+    MakeFakeSysDisk(root, "sdy", 8, 16);
+
+    dev_t added = makedev(8, 0);
+    dev_t kept = makedev(8, 16);
+    dev_t stale = makedev(8, 32);
+    DiskResyncPlan plan;
+    EXPECT_EQ(PlanDiskResync(root + "/block", { kept, stale }, plan), E_OK);
+
+    ASSERT_EQ(plan.removed.size(), 1u);
+    EXPECT_EQ(plan.removed[0], stale);
+    ASSERT_EQ(plan.added.size(), 1u);
+    ASSERT_EQ(plan.added.count(added), 1u);
+    NetlinkData data;
+    data.Decode(plan.added[added].data(), plan.added[added].size());
+    EXPECT_EQ(data.GetAction(), NetlinkData::Actions::ADD);
+    EXPECT_EQ(data.GetParam(NetlinkData::PARAM_DEVTYPE), "disk");
+    EXPECT_EQ(data.GetDevpath(), root + "/devices/sdx");
+
+    plan = DiskResyncPlan();
+    EXPECT_EQ(PlanDiskResync(root + "/missing", { kept }, plan), E_ERR);
+    EXPECT_TRUE(plan.removed.empty());
+    (void)RmDirRecurse(root);
+
+    GTEST_LOG_(INFO) << "Storage_Service_DiskManagerTest_Resync_001 end";
+}
+
 /**
  * @tc.name: Storage_Service_DiskManagerTest_MatchConfig_001
  * @tc.desc: Verify the MatchConfig function.
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/sysmacros.h>
+
+#include "gtest/gtest.h"
+
+#include "disk/disk_registry.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+constexpr uint32_t TEST_MAJOR = 8;
+constexpr int32_t READER_THREADS = 4;
+constexpr auto STRESS_DURATION = std::chrono::milliseconds(500);
+constexpr auto SLOW_EVENT = std::chrono::milliseconds(20);
+constexpr auto LOOKUP_INTERVAL = std::chrono::microseconds(100);
+
+std::shared_ptr<DiskInfo> MakeDisk(uint32_t minor)
+{
+    return std::make_shared<DiskInfo>("/sys/block/sdx", "/devices/test/sdx", makedev(TEST_MAJOR, minor), 0);
+}
+
+/* The previous layout: a list scanned under the mutex the event path holds throughout */
+class LegacyRegistry {
+public:
+    void HandleSlowAdd(uint32_t minor)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        std::this_thread::sleep_for(SLOW_EVENT);
+        disks_.push_back(MakeDisk(minor));
+        if (disks_.size() > 1) {
+            disks_.pop_front();
+        }
+    }
+    std::shared_ptr<DiskInfo> FindById(const std::string &id)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        for (auto &disk : disks_) {
+            if (disk->GetId() == id) {
+                return disk;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    std::mutex lock_;
+    std::list<std::shared_ptr<DiskInfo>> disks_;
+};
+
+struct StressResult {
+    uint64_t lookups { 0 };
+    int64_t maxWaitUs { 0 };
+};
+
+StressResult RunStress(const std::function<void(uint32_t)> &slowAdd,
+    const std::function<void(const std::string &)> &lookup)
+{
+    std::atomic<bool> stop { false };
+    std::atomic<uint64_t> lookups { 0 };
+    std::atomic<int64_t> maxWaitUs { 0 };
+    std::vector<std::thread> readers;
+    for (int32_t i = 0; i < READER_THREADS; i++) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                auto start = std::chrono::steady_clock::now();
+                lookup("disk-8-0");
+                int64_t waitUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+                int64_t cur = maxWaitUs.load();
+                while (waitUs > cur && !maxWaitUs.compare_exchange_weak(cur, waitUs)) {}
+                lookups++;
+                std::this_thread::sleep_for(LOOKUP_INTERVAL);
+            }
+        });
+    }
+
+    auto end = std::chrono::steady_clock::now() + STRESS_DURATION;
+    for (uint32_t minor = 1; std::chrono::steady_clock::now() < end; minor++) {
+        slowAdd(minor);
+    }
+    stop = true;
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    return { lookups.load(), maxWaitUs.load() };
+}
+}
+
+class DiskRegistryTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: DiskRegistryTest_Index_001
+ * @tc.desc: Verify disks are found by device number and id, duplicates are refused and removal drops both.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskRegistryTest, DiskRegistryTest_Index_001, TestSize.Level1)
+{
+    DiskRegistry registry;
+    auto first = MakeDisk(0);
+    auto second = MakeDisk(16);
+    EXPECT_TRUE(registry.Add(first));
+    EXPECT_TRUE(registry.Add(second));
+    EXPECT_FALSE(registry.Add(MakeDisk(0)));
+    EXPECT_EQ(registry.Size(), 2);
+
+    EXPECT_EQ(registry.Find(makedev(TEST_MAJOR, 16)), second);
+    EXPECT_EQ(registry.FindById("disk-8-0"), first);
+    EXPECT_EQ(registry.Find(makedev(TEST_MAJOR, 32)), nullptr);
+    EXPECT_EQ(registry.FindById("disk-8-32"), nullptr);
+
+    EXPECT_EQ(registry.Remove(makedev(TEST_MAJOR, 0)), first);
+    EXPECT_EQ(registry.Remove(makedev(TEST_MAJOR, 0)), nullptr);
+    EXPECT_EQ(registry.FindById("disk-8-0"), nullptr);
+    auto disks = registry.Snapshot();
+    ASSERT_EQ(disks.size(), 1);
+    EXPECT_EQ(disks[0], second);
+}
+
+/**
+ * @tc.name: DiskRegistryTest_Stress_001
+ * @tc.desc: Time lookups racing slow disk events, against the single mutex list they used to wait on.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskRegistryTest, DiskRegistryTest_Stress_001, TestSize.Level3)
+{
+    DiskRegistry registry;
+    std::mutex eventLock;
+    auto slowAdd = [&](uint32_t minor) {
+        std::lock_guard<std::mutex> lock(eventLock);
+        std::this_thread::sleep_for(SLOW_EVENT);
+        ASSERT_TRUE(registry.Add(MakeDisk(minor)));
+        (void)registry.Remove(makedev(TEST_MAJOR, minor - 1));
+    };
+    auto result = RunStress(slowAdd, [&](const std::string &id) { (void)registry.FindById(id); });
+
+    LegacyRegistry legacy;
+    auto legacyResult = RunStress([&](uint32_t minor) { legacy.HandleSlowAdd(minor); },
+        [&](const std::string &id) { (void)legacy.FindById(id); });
+
+    GTEST_LOG_(INFO) << "registry " << result.lookups << " lookups, max wait " << result.maxWaitUs << " us; legacy "
+                     << legacyResult.lookups << " lookups, max wait " << legacyResult.maxWaitUs << " us";
+    EXPECT_EQ(registry.Size(), 1);
+    EXPECT_LT(result.maxWaitUs, legacyResult.maxWaitUs);
+}
+} // StorageDaemon
+} // OHOS
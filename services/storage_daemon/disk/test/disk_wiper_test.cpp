@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cerrno>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "disk/disk_wiper.h"
+#include "storage_service_errno.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+constexpr uint64_t RANGE = 1 << 20;
+
+/* Records the ranges handed to the op, optionally failing discards or sleeping per range */
+class FakeDevice {
+public:
+    explicit FakeDevice(int32_t discardErr = 0, std::chrono::milliseconds delay = std::chrono::milliseconds(0))
+        : discardErr_(discardErr), delay_(delay)
+    {
+    }
+
+    DiskWiper::RangeOp Op()
+    {
+        return [this](DiskWipeMode mode, uint64_t offset, uint64_t length) {
+            if (delay_.count() > 0) {
+                std::this_thread::sleep_for(delay_);
+            }
+            if (mode == WIPE_DISCARD && discardErr_ != 0) {
+                return discardErr_;
+            }
+            std::lock_guard<std::mutex> lock(lock_);
+            ranges_[offset] = length;
+            return 0;
+        };
+    }
+
+    /* True if the recorded ranges tile [0, size) without holes or overlaps */
+    bool Covers(uint64_t size)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        uint64_t end = 0;
+        for (auto &range : ranges_) {
+            if (range.first != end) {
+                return false;
+            }
+            end += range.second;
+        }
+        return end == size;
+    }
+
+private:
+    int32_t discardErr_;
+    std::chrono::milliseconds delay_;
+    std::mutex lock_;
+    std::map<uint64_t, uint64_t> ranges_;
+};
+}
+
+class DiskWiperTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: DiskWiperTest_Wipe_001
+ * @tc.desc: Verify the ranges cover the device exactly once, with a short last range and monotonic progress.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskWiperTest, DiskWiperTest_Wipe_001, TestSize.Level1)
+{
+    const uint64_t size = 1000 * RANGE + 4096;
+    FakeDevice device;
+    DiskWiper wiper(4);
+    uint64_t last = 0;
+    bool monotonic = true;
+    DiskWipeReport report;
+    EXPECT_EQ(wiper.Wipe(device.Op(), size, RANGE, WIPE_DISCARD, report, [&](uint64_t done, uint64_t total) {
+        monotonic = monotonic && done > last && total == size;
+        last = done;
+    }), E_OK);
+
+    EXPECT_TRUE(device.Covers(size));
+    EXPECT_TRUE(monotonic);
+    EXPECT_EQ(last, size);
+    EXPECT_EQ(report.mode, WIPE_DISCARD);
+    EXPECT_EQ(report.bytes, size);
+    EXPECT_EQ(report.ranges, 1001);
+    EXPECT_FALSE(report.cancelled);
+}
+
+/**
+ * @tc.name: DiskWiperTest_Fallback_001
+ * @tc.desc: Verify a device refusing discards is zeroed out instead, the failed range included.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskWiperTest, DiskWiperTest_Fallback_001, TestSize.Level1)
+{
+    const uint64_t size = 64 * RANGE;
+    FakeDevice device(EOPNOTSUPP);
+    DiskWiper wiper(4);
+    DiskWipeReport report;
+    EXPECT_EQ(wiper.Wipe(device.Op(), size, RANGE, WIPE_DISCARD, report), E_OK);
+
+    EXPECT_TRUE(device.Covers(size));
+    EXPECT_EQ(report.mode, WIPE_ZEROOUT);
+    EXPECT_EQ(report.bytes, size);
+}
+
+/**
+ * @tc.name: DiskWiperTest_Limit_001
+ * @tc.desc: Verify a device above the zero out limit is discarded but never zeroed out.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskWiperTest, DiskWiperTest_Limit_001, TestSize.Level1)
+{
+    const uint64_t size = 64 * RANGE;
+    DiskWiper wiper(4, size - 1);
+    DiskWipeReport report;
+
+    FakeDevice discarding;
+    EXPECT_EQ(wiper.Wipe(discarding.Op(), size, RANGE, WIPE_DISCARD, report), E_OK);
+    EXPECT_TRUE(discarding.Covers(size));
+
+    FakeDevice refusing(EOPNOTSUPP);
+    EXPECT_EQ(wiper.Wipe(refusing.Op(), size, RANGE, WIPE_DISCARD, report), E_NOT_SUPPORT);
+    EXPECT_TRUE(refusing.Covers(0));
+    EXPECT_EQ(report.bytes, 0u);
+
+    FakeDevice zeroing;
+    EXPECT_EQ(wiper.Wipe(zeroing.Op(), size, RANGE, WIPE_ZEROOUT, report), E_NOT_SUPPORT);
+    EXPECT_TRUE(zeroing.Covers(0));
+
+    DiskWiper unlimited(4, size);
+    EXPECT_EQ(unlimited.Wipe(refusing.Op(), size, RANGE, WIPE_DISCARD, report), E_OK);
+    EXPECT_TRUE(refusing.Covers(size));
+}
+
+/**
+ * @tc.name: DiskWiperTest_Error_001
+ * @tc.desc: Verify a range failing in both modes fails the wipe and stops the other threads.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskWiperTest, DiskWiperTest_Error_001, TestSize.Level1)
+{
+    const uint64_t size = 1000 * RANGE;
+    DiskWiper wiper(4);
+    DiskWipeReport report;
+    auto op = [](DiskWipeMode mode, uint64_t offset, uint64_t length) { return offset == 10 * RANGE ? EIO : 0; };
+    EXPECT_EQ(wiper.Wipe(op, size, RANGE, WIPE_DISCARD, report), E_ERR);
+    EXPECT_LT(report.bytes, size);
+    EXPECT_EQ(wiper.Wipe(op, size, 0, WIPE_DISCARD, report), E_ERR);
+}
+
+/**
+ * @tc.name: DiskWiperTest_Cancel_001
+ * @tc.desc: Verify a cancelled wipe returns after the ranges in flight and reports the cancel.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskWiperTest, DiskWiperTest_Cancel_001, TestSize.Level1)
+{
+    const uint64_t size = 1000 * RANGE;
+    FakeDevice device(0, std::chrono::milliseconds(2));
+    DiskWiper wiper(4);
+    std::thread canceller([&wiper] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        wiper.Cancel();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    DiskWipeReport report;
+    EXPECT_EQ(wiper.Wipe(device.Op(), size, RANGE, WIPE_DISCARD, report), E_CANCELED);
+    canceller.join();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+    EXPECT_TRUE(report.cancelled);
+    EXPECT_GT(report.bytes, 0);
+    EXPECT_LT(report.bytes, size);
+}
+
+/**
+ * @tc.name: DiskWiperTest_WipeDevice_001
+ * @tc.desc: Verify a path that is not a block device is refused.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskWiperTest, DiskWiperTest_WipeDevice_001, TestSize.Level1)
+{
+    DiskWiper wiper;
+    DiskWipeReport report;
+    EXPECT_EQ(wiper.WipeDevice("/dev/null", "/sys/block/none", report), E_ERR);
+    EXPECT_EQ(wiper.WipeDevice("/dev/block/none", "/sys/block/none", report), E_ERR);
+}
+
+/**
+ * @tc.name: DiskWiperTest_Benchmark_001
+ * @tc.desc: Compare wiping ranges of fixed latency on one thread and on the default thread count.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(DiskWiperTest, DiskWiperTest_Benchmark_001, TestSize.Level3)
+{
+    const uint64_t size = 64 * RANGE;
+    auto run = [size](uint32_t threads) {
+        FakeDevice device(0, std::chrono::milliseconds(2));
+        DiskWiper wiper(threads);
+        DiskWipeReport report;
+        EXPECT_EQ(wiper.Wipe(device.Op(), size, RANGE, WIPE_DISCARD, report), E_OK);
+        return report.elapsedUs;
+    };
+
+    int64_t serialUs = run(1);
+    int64_t parallelUs = run(DISK_WIPE_THREADS);
+    GTEST_LOG_(INFO) << "wipe of 64 ranges at 2 ms each: 1 thread " << serialUs << " us, " << DISK_WIPE_THREADS
+                     << " threads " << parallelUs << " us";
+    EXPECT_LT(parallelUs * 2, serialUs);
+}
+} // namespace StorageDaemon
+} // namespace OHOS
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "disk/partition_table.h"
+#include "storage_service_errno.h"
+#include "utils/file_utils.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+const std::string IMAGE_PATH = "/data/partition_table_test.img";
+const std::string SGDISK_PATH = "/system/bin/sgdisk";
+constexpr uint64_t IMAGE_SECTORS = 64 * 1024;
+constexpr uint32_t GPT_ENTRIES = 128;
+constexpr uint32_t GPT_ARRAY_SECTORS = GPT_ENTRIES * 128 / DEFAULT_SECTOR_SIZE;
+constexpr int32_t PARSE_LOOPS = 1000;
+constexpr int32_t SGDISK_LOOPS = 20;
+constexpr uint8_t BASIC_DATA_GUID[GPT_GUID_LEN] = {
+    0xA2, 0xA0, 0xD0, 0xEB, 0xE5, 0xB9, 0x33, 0x44, 0x87, 0xC0, 0x68, 0xB6, 0xB7, 0x26, 0x99, 0xC7
+};
+
+struct TestPart {
+    uint32_t slot;
+    uint8_t type;
+    uint64_t start;
+    uint64_t sectors;
+};
+
+template<typename T>
+void Put(std::vector<uint8_t> &buf, size_t offset, T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++) {
+        buf[offset + i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8));
+    }
+}
+
+/* Builds partition tables by hand, independently of the parser under test */
+class DiskImage {
+public:
+    DiskImage()
+    {
+        fd_ = open(IMAGE_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        EXPECT_GE(fd_, 0);
+        EXPECT_EQ(ftruncate(fd_, IMAGE_SECTORS * DEFAULT_SECTOR_SIZE), 0);
+    }
+    ~DiskImage()
+    {
+        close(fd_);
+        unlink(IMAGE_PATH.c_str());
+    }
+
+    void WriteMbr(const std::vector<TestPart> &parts, uint64_t lba = 0, uint64_t base = 0)
+    {
+        std::vector<uint8_t> sector(DEFAULT_SECTOR_SIZE, 0);
+        for (auto &part : parts) {
+            size_t offset = 446 + part.slot * 16;
+            sector[offset + 4] = part.type;
+            Put<uint32_t>(sector, offset + 8, static_cast<uint32_t>(part.start - base));
+            Put<uint32_t>(sector, offset + 12, static_cast<uint32_t>(part.sectors));
+        }
+        Put<uint16_t>(sector, 510, 0xAA55);
+        Write(lba, sector);
+    }
+
+    void WriteGpt(const std::vector<TestPart> &parts)
+    {
+        std::vector<uint8_t> array(GPT_ENTRIES * 128, 0);
+        for (auto &part : parts) {
+            size_t offset = part.slot * 128;
+            std::copy(BASIC_DATA_GUID, BASIC_DATA_GUID + GPT_GUID_LEN, array.begin() + offset);
+            array[offset + 16] = static_cast<uint8_t>(part.slot + 1);
+            Put<uint64_t>(array, offset + 32, part.start);
+            Put<uint64_t>(array, offset + 40, part.start + part.sectors - 1);
+        }
+        uint64_t last = IMAGE_SECTORS - 1;
+        WriteGptCopy(1, last, 2, array);
+        WriteGptCopy(last, 1, last - GPT_ARRAY_SECTORS, array);
+    }
+
+    void Corrupt(uint64_t lba)
+    {
+        std::vector<uint8_t> sector(DEFAULT_SECTOR_SIZE, 0x5A);
+        Write(lba, sector);
+    }
+
+    int32_t Fd() const
+    {
+        return fd_;
+    }
+
+private:
+    void WriteGptCopy(uint64_t lba, uint64_t alternate, uint64_t entryLba, const std::vector<uint8_t> &array)
+    {
+        std::vector<uint8_t> header(DEFAULT_SECTOR_SIZE, 0);
+        std::copy_n("EFI PART", 8, header.begin());
+        Put<uint32_t>(header, 8, 0x00010000);
+        Put<uint32_t>(header, 12, 92);
+        Put<uint64_t>(header, 24, lba);
+        Put<uint64_t>(header, 32, alternate);
+        Put<uint64_t>(header, 40, 2 + GPT_ARRAY_SECTORS);
+        Put<uint64_t>(header, 48, IMAGE_SECTORS - 2 - GPT_ARRAY_SECTORS);
+        Put<uint64_t>(header, 72, entryLba);
+        Put<uint32_t>(header, 80, GPT_ENTRIES);
+        Put<uint32_t>(header, 84, 128);
+        Put<uint32_t>(header, 88, PartitionCrc32(array.data(), array.size()));
+        Put<uint32_t>(header, 16, PartitionCrc32(header.data(), 92));
+        Write(lba, header);
+        Write(entryLba, array);
+    }
+
+    void Write(uint64_t lba, const std::vector<uint8_t> &buf)
+    {
+        ASSERT_EQ(pwrite(fd_, buf.data(), buf.size(), lba * DEFAULT_SECTOR_SIZE), static_cast<ssize_t>(buf.size()));
+    }
+
+    int32_t fd_ { -1 };
+};
+
+int32_t Parse(const DiskImage &image, PartitionTable &table)
+{
+    return ReadPartitionTable(image.Fd(), IMAGE_SECTORS * DEFAULT_SECTOR_SIZE, DEFAULT_SECTOR_SIZE, table);
+}
+
+std::vector<uint32_t> Indexes(const PartitionTable &table)
+{
+    std::vector<uint32_t> indexes;
+    for (auto &entry : table.entries) {
+        indexes.push_back(entry.index);
+    }
+    return indexes;
+}
+}
+
+class PartitionTableTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: PartitionTableTest_Crc32_001
+ * @tc.desc: Verify PartitionCrc32 against the standard check value.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_Crc32_001, TestSize.Level1)
+{
+    EXPECT_EQ(PartitionCrc32("123456789", 9), 0xCBF43926);
+    EXPECT_EQ(PartitionCrc32("", 0), 0);
+}
+
+/**
+ * @tc.name: PartitionTableTest_Gpt_001
+ * @tc.desc: Verify GPT partitions behind a protective MBR keep their slot numbers.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_Gpt_001, TestSize.Level1)
+{
+    DiskImage image;
+    image.WriteMbr({ { 0, 0xEE, 1, IMAGE_SECTORS - 1 } });
+    image.WriteGpt({ { 0, 0, 2048, 8192 }, { 2, 0, 16384, 4096 } });
+
+    PartitionTable table;
+    ASSERT_EQ(Parse(image, table), E_OK);
+    EXPECT_EQ(table.type, TABLE_GPT);
+    ASSERT_EQ(Indexes(table), std::vector<uint32_t>({ 1, 3 }));
+    EXPECT_EQ(table.entries[0].startLba, 2048);
+    EXPECT_EQ(table.entries[0].sectors, 8192);
+    EXPECT_EQ(table.entries[1].startLba, 16384);
+    EXPECT_EQ(table.entries[1].typeGuid[0], BASIC_DATA_GUID[0]);
+}
+
+/**
+ * @tc.name: PartitionTableTest_Gpt_002
+ * @tc.desc: Verify a corrupted primary GPT falls back to the backup, and losing both leaves no table.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_Gpt_002, TestSize.Level1)
+{
+    DiskImage image;
+    image.WriteMbr({ { 0, 0xEE, 1, IMAGE_SECTORS - 1 } });
+    image.WriteGpt({ { 1, 0, 2048, 8192 } });
+    image.Corrupt(2);
+
+    PartitionTable table;
+    ASSERT_EQ(Parse(image, table), E_OK);
+    EXPECT_EQ(table.type, TABLE_GPT);
+    EXPECT_EQ(Indexes(table), std::vector<uint32_t>({ 2 }));
+
+    image.Corrupt(IMAGE_SECTORS - 1);
+    ASSERT_EQ(Parse(image, table), E_OK);
+    EXPECT_EQ(table.type, TABLE_NONE);
+    EXPECT_TRUE(table.entries.empty());
+}
+
+/**
+ * @tc.name: PartitionTableTest_Gpt_003
+ * @tc.desc: Verify a hybrid MBR is read through its GPT, like the kernel does.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_Gpt_003, TestSize.Level1)
+{
+    DiskImage image;
+    image.WriteMbr({ { 0, 0xEE, 1, 2047 }, { 1, 0x0C, 2048, 8192 } });
+    image.WriteGpt({ { 0, 0, 2048, 8192 }, { 1, 0, 10240, 8192 } });
+
+    PartitionTable table;
+    ASSERT_EQ(Parse(image, table), E_OK);
+    EXPECT_EQ(table.type, TABLE_GPT);
+    EXPECT_EQ(Indexes(table), std::vector<uint32_t>({ 1, 2 }));
+}
+
+/**
+ * @tc.name: PartitionTableTest_Mbr_001
+ * @tc.desc: Verify MBR primaries keep their slot numbers and logical partitions start at 5.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_Mbr_001, TestSize.Level1)
+{
+    DiskImage image;
+    constexpr uint64_t extStart = 20480;
+    constexpr uint64_t nextEbr = 30720;
+    image.WriteMbr({ { 0, 0x0C, 2048, 8192 }, { 2, 0x0F, extStart, 20480 } });
+    image.WriteMbr({ { 0, 0x07, extStart + 2048, 4096 }, { 1, 0x05, nextEbr, 8192 } }, extStart, extStart);
+    image.WriteMbr({ { 0, 0x83, nextEbr + 2048, 4096 } }, nextEbr, nextEbr);
+
+    PartitionTable table;
+    ASSERT_EQ(Parse(image, table), E_OK);
+    EXPECT_EQ(table.type, TABLE_MBR);
+    ASSERT_EQ(Indexes(table), std::vector<uint32_t>({ 1, 5, 6 }));
+    EXPECT_EQ(table.entries[0].mbrType, 0x0C);
+    EXPECT_EQ(table.entries[1].startLba, extStart + 2048);
+    EXPECT_EQ(table.entries[2].startLba, nextEbr + 2048);
+    EXPECT_EQ(table.entries[2].mbrType, 0x83);
+}
+
+/**
+ * @tc.name: PartitionTableTest_None_001
+ * @tc.desc: Verify a blank disk has no table and a missing device is an error.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_None_001, TestSize.Level1)
+{
+    DiskImage image;
+    PartitionTable table;
+    EXPECT_EQ(ReadPartitionTable(IMAGE_PATH, table), E_OK);
+    EXPECT_EQ(table.type, TABLE_NONE);
+    EXPECT_TRUE(table.entries.empty());
+
+    EXPECT_EQ(ReadPartitionTable("/data/partition_table_test.missing", table), E_ERR);
+}
+
+/**
+ * @tc.name: PartitionTableTest_Write_001
+ * @tc.desc: Verify repartitioning a GPT disk leaves one FAT32 MBR partition and no GPT at either end.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_Write_001, TestSize.Level1)
+{
+    DiskImage image;
+    image.WriteMbr({ { 0, 0xEE, 1, IMAGE_SECTORS - 1 } });
+    image.WriteGpt({ { 0, 0, 2048, 8192 }, { 1, 0, 10240, 8192 } });
+
+    ASSERT_EQ(WriteSinglePartitionTable(IMAGE_PATH, MBR_TYPE_FAT32_LBA), E_OK);
+    PartitionTable table;
+    ASSERT_EQ(Parse(image, table), E_OK);
+    EXPECT_EQ(table.type, TABLE_MBR);
+    ASSERT_EQ(Indexes(table), std::vector<uint32_t>({ 1 }));
+    EXPECT_EQ(table.entries[0].mbrType, MBR_TYPE_FAT32_LBA);
+    EXPECT_EQ(table.entries[0].startLba, 2048);
+    EXPECT_EQ(table.entries[0].sectors, IMAGE_SECTORS - 2048 - 1 - GPT_ARRAY_SECTORS);
+
+    std::vector<uint8_t> sector(DEFAULT_SECTOR_SIZE, 0xFF);
+    for (uint64_t lba : { static_cast<uint64_t>(1), IMAGE_SECTORS - 1 }) {
+        ASSERT_EQ(pread(image.Fd(), sector.data(), sector.size(), lba * DEFAULT_SECTOR_SIZE),
+            static_cast<ssize_t>(sector.size()));
+        EXPECT_EQ(std::count(sector.begin(), sector.end(), 0), static_cast<ssize_t>(sector.size()));
+    }
+}
+
+/**
+ * @tc.name: PartitionTableTest_Write_002
+ * @tc.desc: Verify disks too small to hold the layout or with odd sector sizes are refused.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_Write_002, TestSize.Level1)
+{
+    DiskImage image;
+    EXPECT_EQ(WriteSinglePartitionTable(image.Fd(), 1024 * 1024, DEFAULT_SECTOR_SIZE, MBR_TYPE_FAT32_LBA), E_ERR);
+    EXPECT_EQ(WriteSinglePartitionTable(image.Fd(), IMAGE_SECTORS * DEFAULT_SECTOR_SIZE, 520, MBR_TYPE_FAT32_LBA),
+        E_ERR);
+    EXPECT_EQ(WriteSinglePartitionTable("/data/partition_table_test.missing", MBR_TYPE_FAT32_LBA), E_ERR);
+}
+
+/**
+ * @tc.name: PartitionTableTest_Diff_001
+ * @tc.desc: Verify only partitions whose index, extent or type changed are reported as removed and added.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_Diff_001, TestSize.Level1)
+{
+    auto entry = [](uint32_t index, uint64_t start, uint64_t sectors, uint8_t type) {
+        PartitionEntry part;
+        part.index = index;
+        part.startLba = start;
+        part.sectors = sectors;
+        part.mbrType = type;
+        return part;
+    };
+    std::vector<PartitionEntry> before = {
+        entry(1, 2048, 8192, MBR_TYPE_FAT32_LBA), entry(2, 10240, 8192, 0x07), entry(3, 18432, 8192, 0x83),
+    };
+    std::vector<size_t> removed;
+    std::vector<size_t> added;
+    DiffPartitionEntries(before, before, removed, added);
+    EXPECT_TRUE(removed.empty());
+    EXPECT_TRUE(added.empty());
+
+    /* 1 unchanged, 2 grown, 3 retyped, 4 new */
+    std::vector<PartitionEntry> after = {
+        entry(4, 40960, 8192, 0x07), entry(1, 2048, 8192, MBR_TYPE_FAT32_LBA), entry(2, 10240, 16384, 0x07),
+        entry(3, 18432, 8192, 0x07),
+    };
+    DiffPartitionEntries(before, after, removed, added);
+    EXPECT_EQ(removed, std::vector<size_t>({ 1, 2 }));
+    EXPECT_EQ(added, std::vector<size_t>({ 0, 2, 3 }));
+
+    PartitionEntry gpt = entry(1, 2048, 8192, 0);
+    PartitionEntry retyped = gpt;
+    retyped.typeGuid[0] = 0xA2;
+    EXPECT_FALSE(SamePartition(gpt, retyped));
+    DiffPartitionEntries({ gpt }, {}, removed, added);
+    EXPECT_EQ(removed, std::vector<size_t>({ 0 }));
+    EXPECT_TRUE(added.empty());
+}
+
+/**
+ * @tc.name: PartitionTableTest_Benchmark_001
+ * @tc.desc: Compare the native parser against forking sgdisk --ohos-dump on the same image.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(PartitionTableTest, PartitionTableTest_Benchmark_001, TestSize.Level3)
+{
+    DiskImage image;
+    image.WriteMbr({ { 0, 0xEE, 1, IMAGE_SECTORS - 1 } });
+    image.WriteGpt({ { 0, 0, 2048, 8192 }, { 1, 0, 10240, 8192 } });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < PARSE_LOOPS; i++) {
+        PartitionTable table;
+        ASSERT_EQ(ReadPartitionTable(IMAGE_PATH, table), E_OK);
+        ASSERT_EQ(table.entries.size(), 2);
+    }
+    auto nativeCost = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    GTEST_LOG_(INFO) << "native parser " << nativeCost / PARSE_LOOPS << " us/disk";
+
+    if (access(SGDISK_PATH.c_str(), X_OK) != 0) {
+        GTEST_LOG_(INFO) << "sgdisk not present, skip the comparison";
+        return;
+    }
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < SGDISK_LOOPS; i++) {
+        std::vector<std::string> cmd = { SGDISK_PATH, "--ohos-dump", IMAGE_PATH };
+        std::vector<std::string> output;
+        EXPECT_EQ(ForkExec(cmd, &output), E_OK);
+    }
+    auto sgdiskCost = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    GTEST_LOG_(INFO) << "sgdisk --ohos-dump " << sgdiskCost / SGDISK_LOOPS << " us/disk";
+}
+} // StorageDaemon
+} // OHOS
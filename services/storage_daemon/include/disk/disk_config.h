@@ -24,8 +24,10 @@ class DiskConfig {
 public:
     DiskConfig(const std::string &sysPattern, const std::string &lable, int flag);
     ~DiskConfig();
-    bool IsMatch(std::string &sysPattern);
+    bool IsMatch(const std::string &sysPattern) const;
     int GetFlag() const;
+    const std::string &GetSysPattern() const;
+    const std::string &GetLabel() const;
 private:
     std::string sysPattern_;
     std::string label_;
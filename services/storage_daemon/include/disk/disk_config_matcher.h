@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_DAEMON_DISK_CONFIG_MATCHER_H
+#define OHOS_STORAGE_DAEMON_DISK_CONFIG_MATCHER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "disk/disk_config.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+/*
+ * The sysPattern globs of all disk configs compiled into one prefix trie.
+ * Each pattern is stored under its literal head (the part before the first
+ * '*', '?', '[' or '\'), so a lookup walks the device path once and only
+ * runs fnmatch on the glob tail of the patterns whose head matched. The
+ * result is the same as trying DiskConfig::IsMatch in the order the configs
+ * were added.
+ */
+class DiskConfigMatcher {
+public:
+    DiskConfigMatcher();
+    void Add(const std::shared_ptr<DiskConfig> &config);
+    /* First added config matching devPath, nullptr if none */
+    std::shared_ptr<DiskConfig> Match(const std::string &devPath) const;
+    size_t Size() const;
+
+private:
+    struct Rule {
+        std::shared_ptr<DiskConfig> config;
+        size_t headLen;
+        bool literal;
+    };
+    struct Node {
+        /* Sorted by character */
+        std::vector<std::pair<char, uint32_t>> next;
+        /* Indexes into rules_, ascending */
+        std::vector<uint32_t> rules;
+    };
+
+    uint32_t Child(uint32_t node, char c) const;
+    bool RuleMatch(const Rule &rule, const std::string &devPath) const;
+
+    std::vector<Node> nodes_;
+    std::vector<Rule> rules_;
+};
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_DISK_CONFIG_MATCHER_H
@@ -17,10 +17,17 @@
 #define OHOS_STORAGE_DAEMON_DISK_INFO_H
 
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <sys/types.h>
 
+#include "disk/disk_wiper.h"
+#include "disk/partition_table.h"
+
 namespace OHOS {
 namespace StorageDaemon {
 const int sInital = 0;
@@ -41,8 +48,16 @@ public:
     int Destroy();
     void ReadMetadata();
     int ReadPartition();
+    /* Rereads the table and only destroys or creates the volumes whose partition changed */
+    int Rescan();
     int CreateVolume(dev_t dev);
-    int Partition();
+    /*
+     * With wipe the whole disk is discarded before the new table is written. A
+     * large disk that takes no discards is only zeroed out with allowZeroOut.
+     */
+    int Partition(bool wipe = false, bool allowZeroOut = false);
+    /* Stops a wipe in progress, the partition table is still written and Partition returns E_CANCELED */
+    int CancelWipe();
     dev_t GetDevice() const;
     std::string GetId() const;
     std::string GetDevPath() const;
@@ -63,6 +78,16 @@ private:
     dev_t device_ {};
     unsigned int flags_ {};
     std::list<std::string> volumeId_;
+    /* Partition each volume of volumeId_ was created from, keyed by volume id */
+    std::map<std::string, PartitionEntry> partitions_;
+    /* Guards wiper_, which is only set while a wipe runs */
+    std::mutex wipeLock_;
+    std::shared_ptr<DiskWiper> wiper_;
+
+    int Wipe(bool allowZeroOut);
+    int ReadPartitionEntries(std::vector<PartitionEntry> &entries);
+    int CreatePartitionVolume(const PartitionEntry &entry);
+    int DestroyVolumes(const std::vector<std::string> &volumeIds);
 };
 } // STORAGE_DAEMON
 } // OHOS
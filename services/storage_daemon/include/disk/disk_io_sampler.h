@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_DAEMON_DISK_IO_SAMPLER_H
+#define OHOS_STORAGE_DAEMON_DISK_IO_SAMPLER_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "disk_io_stats.h"
+#include "utils/sysfs_reader.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+constexpr uint32_t DISK_IO_RING_SIZE = 60;
+constexpr std::chrono::milliseconds DISK_IO_SAMPLE_INTERVAL { 1000 };
+
+/* Cumulative counters of /sys/block/<dev>/stat plus the current inflight file */
+struct DiskIoSample {
+    int64_t timeMs;
+    uint64_t readIos;
+    uint64_t readSectors;
+    uint64_t readTicks;
+    uint64_t writeIos;
+    uint64_t writeSectors;
+    uint64_t writeTicks;
+    uint64_t ioTicks;
+    uint32_t inflightRead;
+    uint32_t inflightWrite;
+};
+
+bool ParseDiskStat(const std::string &stat, DiskIoSample &sample);
+bool ParseDiskInflight(const std::string &inflight, DiskIoSample &sample);
+/* Rates and latencies between two samples of the same disk */
+void DeriveDiskIoStats(const DiskIoSample &first, const DiskIoSample &last, StorageManager::DiskIoStats &stats);
+
+/*
+ * Periodically samples the stat and inflight attributes of the known disks
+ * into a fixed ring per disk. Each round costs two openat + pread per disk
+ * on directories kept open between rounds; queries derive the figures over
+ * the whole ring, so they cover the last DISK_IO_RING_SIZE intervals.
+ */
+class DiskIoSampler {
+public:
+    /* Known disks as (disk id, sysfs path) pairs */
+    using DiskSource = std::function<std::vector<std::pair<std::string, std::string>>()>;
+
+    explicit DiskIoSampler(DiskSource source, std::chrono::milliseconds interval = DISK_IO_SAMPLE_INTERVAL);
+    ~DiskIoSampler();
+    /* Starts the sampling thread with empty rings, does nothing if it already runs */
+    void Start();
+    /* Joins the sampling thread, the rings stay queryable; must not race Start */
+    void Stop();
+    void SampleOnce();
+    int32_t Query(const std::string &diskId, StorageManager::DiskIoStats &stats);
+
+private:
+    struct DiskRing {
+        std::string sysPath;
+        std::unique_ptr<SysfsDir> dir;
+        std::array<DiskIoSample, DISK_IO_RING_SIZE> samples;
+        uint32_t head { 0 };
+        uint32_t count { 0 };
+    };
+
+    void Run();
+    static void Push(DiskRing &ring, const DiskIoSample &sample);
+
+    DiskSource source_;
+    std::chrono::milliseconds interval_;
+    std::mutex lock_;
+    std::condition_variable cond_;
+    std::map<std::string, DiskRing> disks_;
+    std::thread thread_;
+    bool running_ { false };
+};
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_DISK_IO_SAMPLER_H
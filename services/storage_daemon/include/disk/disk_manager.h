@@ -16,20 +16,36 @@
 #ifndef OHOS_STORAGE_DAEMON_DISK_MANAGER_H
 #define OHOS_STORAGE_DAEMON_DISK_MANAGER_H
 
-#include <list>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include <cstring>
 #include <nocopyable.h>
 
 #include <sys/types.h>
 
 #include "disk/disk_config.h"
+#include "disk/disk_config_matcher.h"
 #include "disk/disk_info.h"
+#include "disk/disk_io_sampler.h"
+#include "disk/disk_registry.h"
+#include "utils/strand_executor.h"
 #include "netlink/netlink_data.h"
 
 namespace OHOS {
 namespace StorageDaemon {
+constexpr uint32_t DISK_STRAND_THREADS = 4;
+
+/* What a resync changes: known disks gone from sysfs, and an add uevent for each new one */
+struct DiskResyncPlan {
+    std::vector<dev_t> removed;
+    std::map<dev_t, std::string> added;
+};
+
+/* Diffs the whole disks under sysBlockPath against the known devices, fails if it cannot be read */
+int32_t PlanDiskResync(const std::string &sysBlockPath, const std::vector<dev_t> &known, DiskResyncPlan &plan);
+
 class DiskManager final {
 public:
     static DiskManager* Instance(void);
@@ -40,17 +56,29 @@ public:
     void ChangeDisk(dev_t device);
     std::shared_ptr<DiskInfo> GetDisk(dev_t device);
     void HandleDiskEvent(NetlinkData *data);
-    int32_t HandlePartition(std::string diskId);
+    int32_t HandlePartition(std::string diskId, bool wipe = false, bool allowZeroOut = false);
+    int32_t CancelWipe(const std::string &diskId);
     void AddDiskConfig(std::shared_ptr<DiskConfig> &diskConfig);
     void ReplayUevent();
+    void Resync();
     std::shared_ptr<DiskInfo> MatchConfig(NetlinkData *data);
+    int32_t GetDiskIoStats(const std::string &diskId, StorageManager::DiskIoStats &stats);
 
 private:
-    DiskManager() = default;
+    DiskManager();
+    std::shared_ptr<DiskInfo> MatchConfig(const std::string &sysPath, const std::string &devPath, dev_t device);
+    void AddDisk(const std::string &sysPath, const std::string &devPath, dev_t device);
+    void UpdateIoSampler();
 
+    /* Guards configs_ */
     std::mutex lock_;
-    std::list<std::shared_ptr<DiskInfo>> disk_;
-    std::list<std::shared_ptr<DiskConfig>> diskConfig_;
+    DiskRegistry disks_;
+    /* Work on a disk runs on the strand of its dev_t: ordered per disk, parallel across disks */
+    StrandExecutor strands_ { DISK_STRAND_THREADS };
+    /* Serializes starting and stopping ioSampler_, which only runs while disks are known */
+    std::mutex samplerLock_;
+    DiskIoSampler ioSampler_;
+    DiskConfigMatcher configs_;
     static DiskManager* instance_;
 
     DISALLOW_COPY_AND_MOVE(DiskManager);
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OHOS_STORAGE_DAEMON_DISK_REGISTRY_H
+#define OHOS_STORAGE_DAEMON_DISK_REGISTRY_H
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "disk/disk_info.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+/*
+ * Known disks indexed by device number and by disk id. Lookups share the
+ * lock and only Add/Remove take it exclusively, so readers never wait for
+ * the slow work (scanning, volume teardown) done around those calls.
+ */
+class DiskRegistry {
+public:
+    /* Returns false if a disk with the same device number is already registered */
+    bool Add(const std::shared_ptr<DiskInfo> &disk);
+    std::shared_ptr<DiskInfo> Remove(dev_t device);
+    std::shared_ptr<DiskInfo> Find(dev_t device) const;
+    std::shared_ptr<DiskInfo> FindById(const std::string &id) const;
+    std::vector<std::shared_ptr<DiskInfo>> Snapshot() const;
+    size_t Size() const;
+
+private:
+    mutable std::shared_mutex lock_;
+    std::map<dev_t, std::shared_ptr<DiskInfo>> byDevice_;
+    std::unordered_map<std::string, std::shared_ptr<DiskInfo>> byId_;
+};
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_DISK_REGISTRY_H
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_DAEMON_DISK_WIPER_H
+#define OHOS_STORAGE_DAEMON_DISK_WIPER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace OHOS {
+namespace StorageDaemon {
+constexpr uint32_t DISK_WIPE_THREADS = 4;
+/* Largest range handed to one ioctl, it bounds how long a cancel takes to land */
+constexpr uint64_t DISK_WIPE_RANGE_BYTES = 256ULL << 20;
+/* Largest device zeroed out by default, beyond it zeroing a slow card can take hours */
+constexpr uint64_t DISK_WIPE_ZEROOUT_MAX_BYTES = 1ULL << 30;
+
+enum DiskWipeMode {
+    WIPE_DISCARD,
+    WIPE_ZEROOUT,
+};
+
+struct DiskWipeReport {
+    DiskWipeMode mode { WIPE_DISCARD };
+    uint64_t bytes { 0 };
+    uint32_t ranges { 0 };
+    int64_t elapsedUs { 0 };
+    bool cancelled { false };
+};
+
+/*
+ * Wipes a whole device by splitting it into ranges that a few threads pull
+ * from a shared cursor. Ranges are discarded with BLKDISCARD, bounded by the
+ * queue's discard_max_bytes; when the device does not take discards the job
+ * switches to BLKZEROOUT for the remaining ranges and retries the failed one.
+ * A device larger than zeroOutLimit is never zeroed out, the wipe fails with
+ * E_NOT_SUPPORT instead.
+ */
+class DiskWiper {
+public:
+    /* Wipes [offset, offset + length) in the given mode, returns 0 or an errno */
+    using RangeOp = std::function<int32_t(DiskWipeMode mode, uint64_t offset, uint64_t length)>;
+    /* Called from the wiping threads after each range */
+    using Progress = std::function<void(uint64_t done, uint64_t total)>;
+
+    explicit DiskWiper(uint32_t threads = DISK_WIPE_THREADS, uint64_t zeroOutLimit = DISK_WIPE_ZEROOUT_MAX_BYTES);
+    ~DiskWiper() = default;
+    int32_t WipeDevice(const std::string &devPath, const std::string &sysPath, DiskWipeReport &report,
+        const Progress &progress = nullptr);
+    int32_t Wipe(const RangeOp &op, uint64_t size, uint64_t rangeBytes, DiskWipeMode mode, DiskWipeReport &report,
+        const Progress &progress = nullptr);
+    /* Safe from any thread, the ranges already issued still complete and the wipe returns E_CANCELED */
+    void Cancel();
+
+private:
+    uint32_t threads_;
+    uint64_t zeroOutLimit_;
+    std::atomic<bool> cancelled_ { false };
+};
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_DISK_WIPER_H
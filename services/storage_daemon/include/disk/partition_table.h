@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OHOS_STORAGE_DAEMON_PARTITION_TABLE_H
+#define OHOS_STORAGE_DAEMON_PARTITION_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace StorageDaemon {
+constexpr uint32_t DEFAULT_SECTOR_SIZE = 512;
+constexpr size_t GPT_GUID_LEN = 16;
+constexpr uint8_t MBR_TYPE_FAT32_LBA = 0x0C;
+
+enum PartitionTableType {
+    TABLE_NONE,
+    TABLE_MBR,
+    TABLE_GPT,
+};
+
+/* index is the kernel's partition number, the device minor is the disk's plus index */
+struct PartitionEntry {
+    uint32_t index { 0 };
+    uint64_t startLba { 0 };
+    uint64_t sectors { 0 };
+    uint8_t mbrType { 0 };
+    std::array<uint8_t, GPT_GUID_LEN> typeGuid {};
+};
+
+struct PartitionTable {
+    PartitionTableType type { TABLE_NONE };
+    uint32_t sectorSize { DEFAULT_SECTOR_SIZE };
+    std::vector<PartitionEntry> entries;
+};
+
+/*
+ * Reads the partition table the way the kernel does: GPT only behind a
+ * protective or hybrid MBR, falling back to the backup header when the
+ * primary one fails its CRC, otherwise MBR primaries plus the logical
+ * partitions chained from the first extended one. A disk without a
+ * recognised table is E_OK with TABLE_NONE.
+ */
+int32_t ReadPartitionTable(const std::string &devPath, PartitionTable &table);
+int32_t ReadPartitionTable(int32_t fd, uint64_t diskSize, uint32_t sectorSize, PartitionTable &table);
+
+/*
+ * Replaces whatever table the disk had with an MBR holding one partition of
+ * mbrType from the first MiB to just short of where a backup GPT would sit.
+ * The GPT areas at both ends are zeroed, writes use O_DIRECT when the device
+ * allows it, and the kernel is asked to reread the table with BLKRRPART.
+ */
+int32_t WriteSinglePartitionTable(const std::string &devPath, uint8_t mbrType);
+int32_t WriteSinglePartitionTable(int32_t fd, uint64_t diskSize, uint32_t sectorSize, uint8_t mbrType);
+
+/* Same index, extent and type, so a volume on one still matches the other */
+bool SamePartition(const PartitionEntry &a, const PartitionEntry &b);
+
+/*
+ * Compares two reads of a disk's table. removed gets the positions in before
+ * with no identical entry in after, added the positions in after with none
+ * in before; a partition that moved or changed type shows up in both.
+ */
+void DiffPartitionEntries(const std::vector<PartitionEntry> &before, const std::vector<PartitionEntry> &after,
+    std::vector<size_t> &removed, std::vector<size_t> &added);
+
+/* CRC32 as used by GPT headers and entry arrays */
+uint32_t PartitionCrc32(const void *data, size_t len);
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_PARTITION_TABLE_H
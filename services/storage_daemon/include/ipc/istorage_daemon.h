@@ -17,6 +17,8 @@
 #define OHOS_STORAGE_DAEMON_ISTORAGE_DAEMON_H
 
 #include <string>
+#include "disk_io_stats.h"
+#include "media_benchmark_result.h"
 #include "iremote_broker.h"
 
 namespace OHOS {
@@ -45,6 +47,11 @@ public:
         ACTIVE_USER_KEY,
         INACTIVE_USER_KEY,
         UPDATE_KEY_CONTEXT,
+
+        GET_DISK_IO_STATS,
+        BENCHMARK_VOLUME,
+        CANCEL_BENCHMARK,
+        CANCEL_WIPE,
     };
 
     enum {
@@ -52,6 +59,18 @@ public:
         CRYPTO_FLAG_EL2,
     };
 
+    /*
+     * Or-ed into the type of Partition, the low bits stay with the table type.
+     * The table is written even when the wipe does not finish: Partition then
+     * returns E_CANCELED after CancelWipe, E_NOT_SUPPORT when zeroing out was
+     * needed but not allowed, and E_ERR when the wipe failed.
+     */
+    enum {
+        PARTITION_FLAG_WIPE = 1 << 8,
+        /* Lets the wipe zero out a large disk that takes no discards, this can take hours */
+        PARTITION_FLAG_ZEROOUT = 1 << 9,
+    };
+
     virtual int32_t Shutdown() = 0;
 
     virtual int32_t Mount(std::string volId, uint32_t flags) = 0;
@@ -59,6 +78,11 @@ public:
     virtual int32_t Check(std::string volId) = 0;
     virtual int32_t Format(std::string volId, std::string fsType) = 0;
     virtual int32_t Partition(std::string diskId, int32_t type) = 0;
+    virtual int32_t GetDiskIoStats(std::string diskId, StorageManager::DiskIoStats &stats) = 0;
+    virtual int32_t BenchmarkVolume(std::string volId, uint32_t budgetMs,
+        StorageManager::MediaBenchmarkResult &result) = 0;
+    virtual int32_t CancelBenchmark(std::string volId) = 0;
+    virtual int32_t CancelWipe(std::string diskId) = 0;
 
     virtual int32_t StartUser(int32_t userId) = 0;
     virtual int32_t StopUser(int32_t userId) = 0;
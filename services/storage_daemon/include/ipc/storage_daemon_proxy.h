@@ -31,6 +31,11 @@ public:
     virtual int32_t Check(std::string volId) override;
     virtual int32_t Format(std::string volId, std::string fsType) override;
     virtual int32_t Partition(std::string diskId, int32_t type) override;
+    virtual int32_t GetDiskIoStats(std::string diskId, StorageManager::DiskIoStats &stats) override;
+    virtual int32_t BenchmarkVolume(std::string volId, uint32_t budgetMs,
+        StorageManager::MediaBenchmarkResult &result) override;
+    virtual int32_t CancelBenchmark(std::string volId) override;
+    virtual int32_t CancelWipe(std::string diskId) override;
 
     virtual int32_t StartUser(int32_t userId) override;
     virtual int32_t StopUser(int32_t userId) override;
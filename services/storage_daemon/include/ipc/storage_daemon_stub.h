@@ -36,6 +36,10 @@ private:
     int32_t HandleCheck(MessageParcel &data, MessageParcel &reply);
     int32_t HandleFormat(MessageParcel &data, MessageParcel &reply);
     int32_t HandlePartition(MessageParcel &data, MessageParcel &reply);
+    int32_t HandleGetDiskIoStats(MessageParcel &data, MessageParcel &reply);
+    int32_t HandleBenchmarkVolume(MessageParcel &data, MessageParcel &reply);
+    int32_t HandleCancelBenchmark(MessageParcel &data, MessageParcel &reply);
+    int32_t HandleCancelWipe(MessageParcel &data, MessageParcel &reply);
 
     int32_t HandleStartUser(MessageParcel &data, MessageParcel &reply);
     int32_t HandleStopUser(MessageParcel &data, MessageParcel &reply);
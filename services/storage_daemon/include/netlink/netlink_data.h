@@ -16,9 +16,10 @@
 #ifndef OHOS_STORAGE_DAEMON_NETLINK_DATA_H
 #define OHOS_STORAGE_DAEMON_NETLINK_DATA_H
 
+#include <cstdint>
 #include <map>
 #include <string>
-#include <vector>
+#include <string_view>
 
 namespace OHOS {
 namespace StorageDaemon {
@@ -35,30 +36,43 @@ public:
         UNBIND,
         UNKNOWN,
     };
-    std::map<std::string, Actions> actionMaps = {
-        {"add", Actions::ADD},
-        {"remove", Actions::REMOVE},
-        {"move", Actions::MOVE},
-        {"change", Actions::CHANGE},
-        {"online", Actions::ONLINE},
-        {"offline", Actions::OFFLINE},
-        {"bind", Actions::BIND},
-        {"unbind", Actions::UNBIND}
+    enum ParamKey {
+        PARAM_ACTION,
+        PARAM_DEVPATH,
+        PARAM_SUBSYSTEM,
+        PARAM_DEVTYPE,
+        PARAM_MAJOR,
+        PARAM_MINOR,
+        PARAM_DEVNAME,
+        PARAM_PARTN,
+        PARAM_KEY_MAX,
     };
+    static const std::map<std::string, Actions> actionMaps;
 
     std::string GetSyspath();
     std::string GetDevpath();
     std::string GetSubsystem();
     Actions GetAction();
     const std::string GetParam(const std::string paramName);
+    std::string_view GetParam(ParamKey key) const;
+    int32_t GetMajor() const;
+    int32_t GetMinor() const;
     void Decode(const char *msg);
+    void Decode(const char *msg, size_t len);
+    /* Length of a raw uevent up to its terminating empty entry, at most maxLen */
+    static size_t MessageLength(const char *msg, size_t maxLen);
 
 private:
-    std::string sysPath_;
-    std::string subSystem_;
-    std::string devPath_;
-    std::vector<std::string> params_;
+    /* Views point into the decoded message, which must outlive this object */
+    std::string_view keys_[PARAM_KEY_MAX];
+    /* Other parameters are looked up in the message itself, so there is no limit on their number */
+    std::string_view msg_;
+    int32_t major_ { -1 };
+    int32_t minor_ { -1 };
     Actions action_ = Actions::UNKNOWN;
+
+    void Reset();
+    void DecodeEntry(std::string_view entry);
 };
 } // STORAGE_DAEMON
 } // OHOS
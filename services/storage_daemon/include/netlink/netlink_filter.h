@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_DAEMON_NETLINK_FILTER_H
+#define OHOS_STORAGE_DAEMON_NETLINK_FILTER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <linux/filter.h>
+
+namespace OHOS {
+namespace StorageDaemon {
+/*
+ * Kernel uevents are laid out as "action@devpath\0ACTION=action\0DEVPATH=devpath\0SUBSYSTEM=...",
+ * so SUBSYSTEM= always starts at 2 * strlen("action@devpath\0") + 15. The filter finds the first
+ * NUL, derives that offset and drops everything that is not SUBSYSTEM=block. Headers longer than
+ * UEVENT_FILTER_HEADER_MAX are passed through and left to NetlinkHandler.
+ */
+constexpr int UEVENT_FILTER_HEADER_MAX = 512;
+
+std::vector<struct sock_filter> BuildBlockUeventFilter();
+int32_t AttachBlockUeventFilter(int32_t socketFd);
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_NETLINK_FILTER_H
@@ -16,19 +16,95 @@
 #ifndef OHOS_STORAGE_DAEMON_NETLINK_HANDLER_H
 #define OHOS_STORAGE_DAEMON_NETLINK_HANDLER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "netlink_data.h"
 #include "netlink_listener.h"
+#include "uevent_coalescer.h"
+#include "utils/spsc_queue.h"
 
 namespace OHOS {
 namespace StorageDaemon {
+constexpr size_t UEVENT_QUEUE_SIZE = 64;
+
+/*
+ * A queued uevent: raw message copied off the listener ring and decoded in
+ * place. The buffer keeps its capacity between uses, so a slot only
+ * allocates again when a bigger uevent than it has held so far arrives.
+ */
+struct UeventSlot {
+    UeventSlot()
+    {
+        msg.reserve(UEVENT_MSG_LEN);
+    }
+    std::string msg;
+    NetlinkData data;
+    std::chrono::steady_clock::time_point enqueueTime;
+};
+
+/*
+ * Latency is measured from enqueue until the worker has consumed the event,
+ * process time covers each HandleEvent call. Coalesced counts events held in
+ * the settle window, dispatched counts HandleEvent calls after coalescing.
+ */
+struct UeventQueueStats {
+    uint64_t enqueued { 0 };
+    uint64_t processed { 0 };
+    uint64_t dispatched { 0 };
+    uint64_t dropped { 0 };
+    uint32_t depth { 0 };
+    uint32_t maxDepth { 0 };
+    uint64_t avgLatencyUs { 0 };
+    uint64_t maxLatencyUs { 0 };
+    uint64_t avgProcessUs { 0 };
+    uint64_t maxProcessUs { 0 };
+    uint64_t resyncs { 0 };
+    uint64_t coalesced { 0 };
+};
+
 class NetlinkHandler : public NetlinkListener {
 public:
-    explicit NetlinkHandler(int32_t listenerSocket);
-    virtual ~NetlinkHandler() = default;
+    explicit NetlinkHandler(int32_t listenerSocket, std::chrono::milliseconds settleWindow = {});
+    virtual ~NetlinkHandler();
     int32_t Start();
     int32_t Stop();
+    UeventQueueStats GetQueueStats() const;
 
 protected:
-    virtual void OnEvent(char *msg);
+    virtual void OnEvent(char *msg, size_t len);
+    virtual void OnOverflow();
+    virtual void HandleEvent(NetlinkData *data);
+    virtual void Resync();
+
+private:
+    SpscQueue<UeventSlot> queue_;
+    std::unique_ptr<std::thread> workerThread_;
+    std::mutex workerLock_;
+    std::condition_variable workerCond_;
+    std::atomic<bool> workerSleeping_ { false };
+    std::atomic<bool> workerStop_ { false };
+    std::atomic<bool> resyncPending_ { false };
+    std::atomic<uint64_t> resyncs_ { 0 };
+    std::atomic<uint64_t> coalesced_ { 0 };
+    UeventCoalescer coalescer_;
+    std::atomic<uint64_t> enqueued_ { 0 };
+    std::atomic<uint64_t> processed_ { 0 };
+    std::atomic<uint64_t> dispatched_ { 0 };
+    std::atomic<uint64_t> dropped_ { 0 };
+    std::atomic<uint32_t> maxDepth_ { 0 };
+    std::atomic<uint64_t> totalLatencyUs_ { 0 };
+    std::atomic<uint64_t> maxLatencyUs_ { 0 };
+    std::atomic<uint64_t> totalProcessUs_ { 0 };
+    std::atomic<uint64_t> maxProcessUs_ { 0 };
+    void RequestResync();
+    void WakeWorker();
+    bool WaitForEvent();
+    void DispatchEvent(NetlinkData *data);
+    void RunWorker();
 };
 } // STORAGE_DAEMON
 } // OHOS
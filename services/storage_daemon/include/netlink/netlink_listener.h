@@ -15,32 +15,65 @@
 #ifndef OHOS_STORAGE_DAEMON_NETLINK_LISTENER_H
 #define OHOS_STORAGE_DAEMON_NETLINK_LISTENER_H
 
+#include <atomic>
 #include <memory>
 #include <thread>
 
-#include <poll.h>
-
 #include "ipc/storage_daemon.h"
+#include "utils/event_reactor.h"
 
 namespace OHOS {
 namespace StorageDaemon {
+/* Receive buffer size to start with, the kernel's own uevent buffer (UEVENT_BUFFER_SIZE) */
+constexpr int32_t UEVENT_MSG_LEN = 2048;
+/* Receive buffers grow on demand up to this size, larger uevents are dropped */
+constexpr int32_t UEVENT_MSG_MAX = 64 * 1024;
+
+struct UeventRing;
+
+struct UeventStats {
+    uint64_t wakeups { 0 };
+    uint64_t messages { 0 };
+    uint64_t dropped { 0 };
+    uint32_t maxBatch { 0 };
+    uint64_t overflows { 0 };
+    uint64_t truncated { 0 };
+    uint32_t bufferSize { 0 };
+};
+
 class NetlinkListener {
 public:
     NetlinkListener(int32_t socket);
+    virtual ~NetlinkListener();
     int32_t StartListener();
     int32_t StopListener();
+    UeventStats GetStats() const;
+    /* Loop the listener thread runs, other daemon event sources may be added to it */
+    EventReactor &GetReactor();
+    /* Only for replaying recorded uevents over a local socket, kernel sockets must keep the check */
+    void SetOriginCheck(bool enabled);
 
 protected:
-    virtual void OnEvent(char *msg) = 0;
+    /* msg is NUL terminated and holds len bytes, it is only valid for the duration of the call */
+    virtual void OnEvent(char *msg, size_t len) = 0;
+    /* Called on the listener thread when uevents were lost, on ENOBUFS or an oversized message */
+    virtual void OnOverflow();
 
 private:
     int32_t socketFd_ { -1 };
-    int32_t socketPipe_[2] { -1, -1 };
+    EventReactor reactor_;
     std::unique_ptr<std::thread> socketThread_;
+    std::unique_ptr<UeventRing> ring_;
+    std::atomic<uint64_t> wakeups_ { 0 };
+    std::atomic<uint64_t> messages_ { 0 };
+    std::atomic<uint64_t> dropped_ { 0 };
+    std::atomic<uint32_t> maxBatch_ { 0 };
+    std::atomic<uint64_t> overflows_ { 0 };
+    std::atomic<uint64_t> truncated_ { 0 };
+    std::atomic<uint32_t> bufferSize_ { 0 };
+    bool originCheck_ { true };
     void RecvUeventMsg();
-    int32_t ReadMsg(int32_t fd_count, struct pollfd ufds[2]);
-    void RunListener();
-    static void EventProcess(void*);
+    void OnSocketEvent(uint32_t events);
 };
 } // STORAGE_DAEMON
 } // OHOS
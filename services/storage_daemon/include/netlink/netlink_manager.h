@@ -27,6 +27,7 @@ public:
     static NetlinkManager* Instance();
     int32_t Start();
     int32_t Stop();
+    EventReactor *GetReactor();
 
 private:
     static NetlinkManager *instance_;
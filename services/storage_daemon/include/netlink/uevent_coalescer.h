@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OHOS_STORAGE_DAEMON_UEVENT_COALESCER_H
+#define OHOS_STORAGE_DAEMON_UEVENT_COALESCER_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include <sys/types.h>
+
+#include "netlink_data.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+struct UeventCoalescerStats {
+    uint64_t pushed { 0 };
+    uint64_t emitted { 0 };
+};
+
+/*
+ * Collects disk uevents per dev_t until the device has been quiet for the
+ * settle window, then emits only the net effect of the sequence:
+ *   absent  -> present : ADD
+ *   present -> absent  : REMOVE
+ *   present -> present : REMOVE + ADD if it went away in between, else one CHANGE
+ *   absent  -> absent  : nothing
+ * Not thread safe, it is owned by the uevent worker.
+ */
+class UeventCoalescer {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Emitter = std::function<void(NetlinkData *data)>;
+
+    explicit UeventCoalescer(std::chrono::milliseconds window);
+    bool Enabled() const;
+    /* Returns false when the event is not coalesced and must be dispatched directly */
+    bool Push(NetlinkData &data, const char *msg, size_t len, Clock::time_point now);
+    void Flush(Clock::time_point now, const Emitter &emit, bool force = false);
+    bool NextDeadline(Clock::time_point &deadline) const;
+    void Clear();
+    size_t Pending() const;
+    UeventCoalescerStats GetStats() const;
+
+private:
+    struct Entry {
+        bool before { false };
+        bool after { false };
+        bool removed { false };
+        std::string add;
+        std::string remove;
+        std::string change;
+        Clock::time_point deadline;
+    };
+
+    std::chrono::milliseconds window_;
+    std::unordered_map<dev_t, Entry> pending_;
+    UeventCoalescerStats stats_;
+
+    void Emit(const std::string &msg, const Emitter &emit);
+    void EmitNetEffect(const Entry &entry, const Emitter &emit);
+};
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_UEVENT_COALESCER_H
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OHOS_STORAGE_DAEMON_UEVENT_RECORD_H
+#define OHOS_STORAGE_DAEMON_UEVENT_RECORD_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace StorageDaemon {
+/*
+ * Recorded uevent file layout, host byte order:
+ *   header : "UEVR" | uint32 version
+ *   record : uint64 nanoseconds since the first record | uint32 length | raw datagram
+ */
+constexpr uint32_t UEVENT_RECORD_VERSION = 1;
+
+struct UeventRecord {
+    uint64_t timestampNs;
+    std::string msg;
+};
+
+class UeventRecordWriter {
+public:
+    UeventRecordWriter() = default;
+    ~UeventRecordWriter();
+    int32_t Open(const std::string &path);
+    int32_t Append(uint64_t timestampNs, const char *msg, size_t len);
+    void Close();
+
+private:
+    int32_t fd_ { -1 };
+
+    UeventRecordWriter(const UeventRecordWriter &) = delete;
+    UeventRecordWriter &operator=(const UeventRecordWriter &) = delete;
+};
+
+int32_t ReadUeventRecords(const std::string &path, std::vector<UeventRecord> &records);
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_UEVENT_RECORD_H
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OHOS_STORAGE_DAEMON_UEVENT_REPLAY_H
+#define OHOS_STORAGE_DAEMON_UEVENT_REPLAY_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "netlink_handler.h"
+#include "uevent_record.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+struct UeventReplayOptions {
+    /* 1.0 keeps the recorded pacing, 0 sends back to back */
+    double speed { 0 };
+    std::chrono::milliseconds settleWindow { 0 };
+    /* Hand events to DiskManager instead of only timing them */
+    bool useDiskManager { false };
+};
+
+struct UeventReplayResult {
+    uint64_t sent { 0 };
+    uint64_t received { 0 };
+    uint64_t dispatched { 0 };
+    double seconds { 0 };
+    double eventsPerSec { 0 };
+    uint64_t p50Us { 0 };
+    uint64_t p90Us { 0 };
+    uint64_t p99Us { 0 };
+    uint64_t maxUs { 0 };
+};
+
+/*
+ * NetlinkHandler fed from a local socketpair. Every replayed message carries a
+ * REPLAYSEQ entry so the dispatch time can be matched with its send time.
+ */
+class ReplayNetlinkHandler : public NetlinkHandler {
+public:
+    ReplayNetlinkHandler(int32_t socket, size_t count, const UeventReplayOptions &options);
+    void MarkSent(size_t seq);
+    std::vector<uint64_t> TakeLatencies();
+
+protected:
+    void HandleEvent(NetlinkData *data) override;
+    void Resync() override;
+
+private:
+    bool useDiskManager_;
+    std::unique_ptr<std::atomic<int64_t>[]> sendNs_;
+    size_t count_;
+    std::mutex lock_;
+    std::vector<uint64_t> latencies_;
+};
+
+int32_t ReplayUevents(const std::vector<UeventRecord> &records, const UeventReplayOptions &options,
+    UeventReplayResult &result);
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_UEVENT_REPLAY_H
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STORAGE_DAEMON_UTILS_CHMOD_WALKER_H
+#define STORAGE_DAEMON_UTILS_CHMOD_WALKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include <sys/types.h>
+
+namespace OHOS {
+namespace StorageDaemon {
+constexpr uint32_t CHMOD_WALK_THREADS = 4;
+
+struct ChmodWalkStats {
+    uint64_t dirs { 0 };
+    uint64_t files { 0 };
+    uint64_t changed { 0 };
+    uint64_t failed { 0 };
+    int64_t elapsedUs { 0 };
+    bool cancelled { false };
+};
+
+/*
+ * Sets one mode on a whole tree with a few threads. Directories are opened
+ * with openat relative to their parent and handed to idle threads through a
+ * short queue, a busy thread descends into them itself once the queue is
+ * full. Each entry is stat()ed first and only chmod()ed when its mode
+ * differs, so walking an already fixed tree writes no inode. Symlinks are
+ * never followed.
+ */
+class ChmodWalker {
+public:
+    explicit ChmodWalker(uint32_t threads = CHMOD_WALK_THREADS);
+    ~ChmodWalker() = default;
+    /* Blocks until every entry below root, root included, is done or the walk is cancelled */
+    int32_t Walk(const std::string &root, mode_t mode, ChmodWalkStats &stats);
+    /* Safe from any thread, Walk returns once each thread finishes its current directory */
+    void Cancel();
+
+private:
+    void Worker(mode_t mode, ChmodWalkStats &stats);
+    void WalkDir(int32_t dirFd, mode_t mode, ChmodWalkStats &stats);
+    bool Offer(int32_t dirFd);
+
+    uint32_t threads_;
+    std::atomic<bool> cancelled_ { false };
+    std::mutex lock_;
+    std::condition_variable cond_;
+    std::deque<int32_t> pending_;
+    uint32_t busy_ { 0 };
+};
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // STORAGE_DAEMON_UTILS_CHMOD_WALKER_H
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef STORAGE_DAEMON_UTILS_EVENT_REACTOR_H
+#define STORAGE_DAEMON_UTILS_EVENT_REACTOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace OHOS {
+namespace StorageDaemon {
+/*
+ * epoll based event loop. Run() blocks without any timeout until a registered
+ * fd is ready or Stop() is called, so an idle daemon is never woken up.
+ * Sources (netlink, timerfd, mountinfo, inotify...) may be added or removed
+ * from any thread, including from inside a callback.
+ */
+class EventReactor {
+public:
+    using Callback = std::function<void(uint32_t events)>;
+
+    EventReactor() = default;
+    ~EventReactor();
+    int32_t Init();
+    int32_t AddSource(int32_t fd, uint32_t events, Callback callback);
+    int32_t RemoveSource(int32_t fd);
+    int32_t Run();
+    void Stop();
+    uint64_t GetWakeups() const;
+
+private:
+    int32_t epollFd_ { -1 };
+    int32_t stopFd_ { -1 };
+    std::mutex lock_;
+    std::map<int32_t, std::shared_ptr<Callback>> sources_;
+    std::atomic<uint64_t> wakeups_ { 0 };
+
+    EventReactor(const EventReactor &) = delete;
+    EventReactor &operator=(const EventReactor &) = delete;
+};
+} // namespace StorageDaemon
+} // namespace OHOS
+
+#endif // STORAGE_DAEMON_UTILS_EVENT_REACTOR_H
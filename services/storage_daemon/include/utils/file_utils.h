@@ -37,7 +37,6 @@ bool PrepareDir(const std::string &path, mode_t mode, uid_t uid, gid_t gid);
 bool DestroyDir(const std::string &path);
 bool MkDirRecurse(const std::string& path, mode_t mode);
 bool RmDirRecurse(const std::string &path);
-void TravelChmod(std::string path, mode_t mode);
 int32_t Mount(const std::string &source, const std::string &target, const char *type,
               unsigned long flags, const void *data);
 int32_t UMount(const std::string &path);
@@ -45,7 +44,6 @@ int32_t UMount2(const std::string &path, int flag);
 void GetSubDirs(const std::string &path, std::vector<std::string> &dirList);
 void ReadDigitDir(const std::string &path, std::vector<FileList> &dirInfo);
 bool StringToUint32(const std::string &str, uint32_t &num);
-bool ReadFile(std::string path, std::string *str);
 int ForkExec(std::vector<std::string> &cmd, std::vector<std::string> *output = nullptr);
 void TraverseDirUevent(const std::string &path, bool flag);
 }
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef STORAGE_DAEMON_UTILS_SPSC_QUEUE_H
+#define STORAGE_DAEMON_UTILS_SPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace OHOS {
+namespace StorageDaemon {
+/*
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ * Slots are allocated once and filled in place: the producer writes into Reserve()
+ * and publishes it with Commit(), the consumer reads Front() and releases it with Pop().
+ */
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : capacity_(capacity), slots_(std::make_unique<T[]>(capacity)) {}
+
+    T *Reserve()
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) >= capacity_) {
+            return nullptr;
+        }
+        return &slots_[tail % capacity_];
+    }
+
+    void Commit()
+    {
+        tail_.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    T *Front()
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots_[head % capacity_];
+    }
+
+    void Pop()
+    {
+        head_.fetch_add(1, std::memory_order_release);
+    }
+
+    /*
+     * Safe from any thread. Head is read first so tail can only have moved on
+     * past it; from a third thread both may have moved meanwhile, hence the clamp.
+     */
+    size_t Size() const
+    {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return std::min(tail - head, capacity_);
+    }
+
+    bool Empty() const
+    {
+        return Size() == 0;
+    }
+
+    size_t Capacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    const size_t capacity_;
+    std::unique_ptr<T[]> slots_;
+    alignas(64) std::atomic<size_t> head_ { 0 };
+    alignas(64) std::atomic<size_t> tail_ { 0 };
+};
+} // namespace StorageDaemon
+} // namespace OHOS
+
+#endif // STORAGE_DAEMON_UTILS_SPSC_QUEUE_H
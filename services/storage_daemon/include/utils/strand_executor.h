@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef STORAGE_DAEMON_UTILS_STRAND_EXECUTOR_H
+#define STORAGE_DAEMON_UTILS_STRAND_EXECUTOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace OHOS {
+namespace StorageDaemon {
+/*
+ * Small thread pool running tasks in strands. Tasks posted with the same key
+ * run one at a time in posting order, tasks of different keys run in
+ * parallel. The threads are started on the first Post.
+ */
+class StrandExecutor {
+public:
+    using Task = std::function<void()>;
+
+    explicit StrandExecutor(uint32_t threads);
+    ~StrandExecutor();
+    /* Returns false once stopped, the task is then dropped */
+    bool Post(uint64_t key, Task task);
+    /* Blocks until every task posted so far has run */
+    void WaitIdle();
+    /* Runs the tasks already posted, then joins the threads */
+    void Stop();
+
+private:
+    void Run();
+
+    uint32_t threadCount_;
+    std::vector<std::thread> threads_;
+    std::mutex lock_;
+    std::condition_variable workCond_;
+    std::condition_variable idleCond_;
+    /* The task at the front of a strand stays queued while it runs */
+    std::unordered_map<uint64_t, std::deque<Task>> strands_;
+    std::deque<uint64_t> ready_;
+    size_t pending_ { 0 };
+    bool stop_ { false };
+
+    StrandExecutor(const StrandExecutor &) = delete;
+    StrandExecutor &operator=(const StrandExecutor &) = delete;
+};
+} // namespace StorageDaemon
+} // namespace OHOS
+
+#endif // STORAGE_DAEMON_UTILS_STRAND_EXECUTOR_H
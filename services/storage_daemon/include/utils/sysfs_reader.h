@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STORAGE_DAEMON_UTILS_SYSFS_READER_H
+#define STORAGE_DAEMON_UTILS_SYSFS_READER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace StorageDaemon {
+/* A sysfs attribute never exceeds one page */
+constexpr size_t SYSFS_ATTR_MAX = 4096;
+
+struct SysfsAttr {
+    /* Path relative to the directory */
+    const char *name;
+    std::string value;
+    int32_t err;
+};
+
+/*
+ * Reads attributes relative to an open sysfs directory with openat + pread
+ * into a stack buffer. Values have surrounding whitespace (the trailing
+ * newline) trimmed. Nothing is logged, callers decide what a missing
+ * attribute means.
+ */
+class SysfsDir {
+public:
+    explicit SysfsDir(const std::string &path);
+    ~SysfsDir();
+    bool IsOpen() const;
+    /* Still owned by the SysfsDir, duplicate it to outlive it */
+    int32_t Fd() const;
+    int32_t Read(const char *name, std::string &value) const;
+    /* Accepts decimal, 0x-prefixed hex and octal like strtoll with base 0 */
+    int32_t ReadInt(const char *name, int64_t &value) const;
+    /* Reads every attribute, sets each err, returns how many were read */
+    size_t ReadAll(std::vector<SysfsAttr> &attrs) const;
+
+private:
+    int32_t dirFd_;
+
+    SysfsDir(const SysfsDir &) = delete;
+    SysfsDir &operator=(const SysfsDir &) = delete;
+};
+
+/* One-off read of an absolute attribute path */
+int32_t ReadSysfsAttr(const std::string &path, std::string &value);
+int32_t ReadSysfsInt(const std::string &path, int64_t &value);
+} // namespace StorageDaemon
+} // namespace OHOS
+
+#endif // STORAGE_DAEMON_UTILS_SYSFS_READER_H
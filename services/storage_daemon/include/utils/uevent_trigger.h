@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef STORAGE_DAEMON_UTILS_UEVENT_TRIGGER_H
+#define STORAGE_DAEMON_UTILS_UEVENT_TRIGGER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace OHOS {
+namespace StorageDaemon {
+enum UeventWalkAction : uint32_t {
+    WALK_SKIP = 0,
+    WALK_TRIGGER = 1 << 0,
+    WALK_DESCEND = 1 << 1,
+};
+
+/*
+ * Decides what to do with a directory or symlink found under the walked root.
+ * devPath is the entry's path with symlinks resolved and any leading "/sys"
+ * removed, depth is 1 for direct children of the root. Called concurrently.
+ */
+using UeventWalkFilter = std::function<uint32_t(const std::string &devPath, int32_t depth)>;
+
+struct UeventWalkStats {
+    uint32_t visited { 0 };
+    uint32_t triggered { 0 };
+    uint32_t failed { 0 };
+    int64_t elapsedUs { 0 };
+};
+
+/*
+ * Writes "add" into the uevent file of every entry the filter selects. The
+ * tree is walked iteratively with openat/getdents64 and the work is spread
+ * over up to `threads` threads.
+ */
+int32_t TriggerUeventTree(const std::string &root, const UeventWalkFilter &filter, uint32_t threads,
+    UeventWalkStats &stats);
+} // namespace StorageDaemon
+} // namespace OHOS
+
+#endif // STORAGE_DAEMON_UTILS_UEVENT_TRIGGER_H
@@ -19,6 +19,9 @@
 #include <vector>
 #include <sys/types.h>
 #include <map>
+#include <memory>
+#include <thread>
+#include "utils/chmod_walker.h"
 #include "volume/volume_info.h"
 
 namespace OHOS {
@@ -26,7 +29,7 @@ namespace StorageDaemon {
 class ExternalVolumeInfo : public VolumeInfo {
 public:
     ExternalVolumeInfo() = default;
-    virtual ~ExternalVolumeInfo() = default;
+    virtual ~ExternalVolumeInfo();
 
     int32_t GetFsType();
     std::string GetFsUuid();
@@ -45,7 +48,12 @@ private:
     std::string fsLabel_;
     std::string fsUuid_;
     std::string fsType_;
+    /* Flags of the volume say it was not unmounted cleanly, also set when they could not be read */
+    bool fsDirty_ { true };
     dev_t device_;
+    /* Fixes the modes below an ext mount root while the volume is already in use */
+    std::shared_ptr<ChmodWalker> chmodWalker_;
+    std::thread chmodThread_;
 
     const std::string devPathDir_ = "/dev/block/%s";
     std::vector<std::string> supportMountType_ = { "ext2", "ext3", "ext4", "ntfs", "exfat", "vfat" };
@@ -55,6 +63,8 @@ private:
 
     int32_t ReadMetadata();
     std::string GetBlkidData(const std::string type);
+    void StartChmodWalk(const std::string &path, mode_t mode);
+    void StopChmodWalk();
 };
 } // STORAGE_DAEMON
 } // OHOS
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_DAEMON_FS_CHECKER_H
+#define OHOS_STORAGE_DAEMON_FS_CHECKER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace StorageDaemon {
+/* Exit status of a checker that could not be started */
+constexpr int32_t FS_CHECKER_MISSING = 127;
+/* Extra fsck_msdos runs while it keeps reporting it changed the volume */
+constexpr int32_t FS_CHECK_VFAT_RECHECKS = 3;
+
+/* Percent of the check done, 0 when it starts and 100 when it ends */
+using FsCheckProgress = std::function<void(uint32_t percent)>;
+
+/*
+ * Repairs a volume with the checker of its type: e2fsck for ext2/3/4,
+ * fsck_msdos for vfat and fsck.exfat for exfat. E_OK when the volume is
+ * consistent afterwards, E_NOT_SUPPORT when the type has no checker or the
+ * checker is not on the device.
+ */
+int32_t CheckFilesystem(const std::string &devPath, const std::string &type, const FsCheckProgress &progress);
+
+/* Runs cmd and hands each line it prints to onLine, returns its exit status or E_ERR */
+int32_t RunChecker(const std::vector<std::string> &cmd, const std::function<void(const std::string &)> &onLine);
+
+/* Percent done from an "e2fsck -C 1" progress line, false for any other line */
+bool ParseE2fsckProgress(const std::string &line, uint32_t &percent);
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_FS_CHECKER_H
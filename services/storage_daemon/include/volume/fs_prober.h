@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_DAEMON_FS_PROBER_H
+#define OHOS_STORAGE_DAEMON_FS_PROBER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace StorageDaemon {
+/* Bytes read up front, enough for the boot sector and the ext and f2fs superblocks */
+constexpr size_t FS_PROBE_HEAD_BYTES = 4096;
+
+/* Fields named and formatted as blkid prints them, type is empty when nothing was recognised */
+struct FsProbeResult {
+    std::string type;
+    std::string uuid;
+    std::string label;
+    /* Not cleanly unmounted or errors recorded, by the flags the format keeps for that */
+    bool dirty { false };
+};
+
+/* Fills buf with length bytes at offset, false if they cannot be read */
+using FsProbeReader = std::function<bool(uint64_t offset, size_t length, std::vector<uint8_t> &buf)>;
+
+/*
+ * Identifies vfat, exfat, ntfs, ext2/3/4 and f2fs from their superblocks in
+ * one pass. The head of the volume is read once; only the labels that live
+ * in a root directory or the MFT, and the FAT dirty bits, cost one more
+ * read. Every field taken from the volume is bounds checked, so any content
+ * is safe to probe. A volume that is none of these is E_OK with an empty type.
+ */
+int32_t ProbeFilesystem(const FsProbeReader &reader, FsProbeResult &result);
+int32_t ProbeFilesystem(const std::string &devPath, FsProbeResult &result);
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_FS_PROBER_H
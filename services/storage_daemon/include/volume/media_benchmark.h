@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_DAEMON_MEDIA_BENCHMARK_H
+#define OHOS_STORAGE_DAEMON_MEDIA_BENCHMARK_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "media_benchmark_result.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+constexpr std::chrono::milliseconds MEDIA_BENCHMARK_BUDGET { 20000 };
+constexpr std::chrono::milliseconds MEDIA_BENCHMARK_MAX_BUDGET { 120000 };
+
+struct MediaBenchmarkOptions {
+    /* Wall time of the whole run, split evenly over the four tests */
+    std::chrono::milliseconds budget { MEDIA_BENCHMARK_BUDGET };
+    /* Upper bound of the temp file, the sequential write stops there */
+    uint64_t fileSize { 256ULL << 20 };
+    uint32_t seqBlockSize { 1U << 20 };
+    uint32_t randBlockSize { 4096 };
+};
+
+/*
+ * Measures sequential and random read/write speed inside one directory,
+ * normally the mount point of a removable volume. The test file is opened
+ * with O_DIRECT, or O_DSYNC plus dropping the page cache before reads when
+ * the filesystem does not take O_DIRECT, and it is unlinked as soon as it is
+ * open so nothing is left behind, even if the daemon dies mid-run.
+ */
+class MediaBenchmark {
+public:
+    MediaBenchmark(const std::string &dir, const MediaBenchmarkOptions &options);
+    ~MediaBenchmark() = default;
+    /* Blocks for at most the budget; a cancelled run still reports what it measured */
+    int32_t Run(StorageManager::MediaBenchmarkResult &result);
+    /* Safe from any thread, the running test stops after its current I/O and a later Run returns at once */
+    void Cancel();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Phase {
+        uint64_t ops { 0 };
+        uint64_t bytes { 0 };
+        double seconds { 0 };
+    };
+
+    int32_t OpenTestFile(const char *buf, int32_t &fd, bool &direct);
+    int32_t Sequential(int32_t fd, bool write, uint64_t size, char *buf, Phase &phase);
+    int32_t Random(int32_t fd, bool write, uint64_t span, char *buf, Phase &phase);
+    Clock::time_point PhaseDeadline(const Clock::time_point &start) const;
+
+    std::string dir_;
+    MediaBenchmarkOptions options_;
+    std::atomic<bool> cancelled_ { false };
+};
+
+/* Space separated speed and application performance classes reached by the measured figures */
+std::string ClassifyMediaSpeed(const StorageManager::MediaBenchmarkResult &result);
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_MEDIA_BENCHMARK_H
@@ -18,14 +18,25 @@
 
 #include <string>
 #include <unordered_set>
+#include <vector>
 #include <sys/types.h>
 
 namespace OHOS {
 namespace StorageDaemon {
+constexpr uint32_t PROCESS_SCAN_THREADS = 4;
+
+/*
+ * Finds the processes holding anything on the filesystem mounted at path:
+ * cwd, root, exe, an open fd or a mapped file. Holders are matched on the
+ * st_dev of the mount, so files reached through another path or a bind
+ * mount count as well. The pids of /proc are spread over a few threads, all
+ * lookups are relative to a /proc dirfd and a pid stops at its first match.
+ */
 class Process {
 public:
-    Process(std::string path);
+    explicit Process(std::string path, uint32_t threads = PROCESS_SCAN_THREADS);
 
+    /* E_ERR without touching pids_ if path is not the root of a mount */
     int32_t UpdatePidByPath();
     void KillProcess(int signal);
     std::unordered_set<pid_t> GetPids();
@@ -33,14 +44,13 @@ public:
 
 private:
     std::string path_;
+    uint32_t threads_;
     std::unordered_set<pid_t> pids_;
 
-    std::string Readlink(std::string path);
-    bool CheckSubDir(std::string line);
-
-    bool CheckMaps(std::string pidPath);
-    bool CheckSymlink(std::string path);
-    bool CheckFds(std::string pidPath);
+    static bool HoldsDevice(int32_t procFd, pid_t pid, dev_t dev, std::vector<char> &buf);
+    static bool CheckLinks(int32_t pidFd, dev_t dev);
+    static bool CheckFds(int32_t pidFd, dev_t dev);
+    static bool CheckMaps(int32_t pidFd, dev_t dev, std::vector<char> &buf);
 };
 } // STORAGE_DAEMON
 } // OHOS
@@ -16,6 +16,7 @@
 #ifndef OHOS_STORAGE_DAEMON_VOLUME_INFO_H
 #define OHOS_STORAGE_DAEMON_VOLUME_INFO_H
 
+#include <atomic>
 #include <string>
 #include <sys/types.h>
 
@@ -64,7 +65,8 @@ private:
     std::string id_;
     std::string diskId_;
     VolumeType type_;
-    VolumeState mountState_;
+    /* Changed on the volume's scheduler strand only, read from any thread */
+    std::atomic<VolumeState> mountState_ { UNMOUNTED };
     uint32_t mountFlags_;
     int32_t userIdOwner_;
     std::string mountPath_;
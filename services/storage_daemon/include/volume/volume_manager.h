@@ -21,7 +21,12 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
+#include "media_benchmark_result.h"
+#include "volume/media_benchmark.h"
 #include "volume/volume_info.h"
+#include "volume/volume_op_scheduler.h"
 
 namespace OHOS {
 namespace StorageDaemon {
@@ -32,18 +37,30 @@ public:
 
     std::string CreateVolume(const std::string diskId, dev_t device);
     int32_t DestroyVolume(const std::string volId);
+    /* Destroys the volumes side by side, each on its own strand, and waits for all of them */
+    void DestroyVolumes(const std::vector<std::string> &volIds, std::vector<int32_t> &results);
 
+    /* Queues the check and returns, a failed check fails the mount queued after it */
     int32_t Check(const std::string volId);
+    /* Queues the mount and returns, the result is reported through NotifyVolumeMounted */
     int32_t Mount(const std::string volId, uint32_t flags);
     int32_t UMount(const std::string volId);
     int32_t Format(const std::string volId, const std::string fsType);
+    /* Speed test of a mounted volume, one at a time per volume; budgetMs 0 takes the default */
+    int32_t Benchmark(const std::string volId, uint32_t budgetMs, StorageManager::MediaBenchmarkResult &result);
+    int32_t CancelBenchmark(const std::string volId);
 
 private:
     VolumeManager() = default;
     DISALLOW_COPY_AND_MOVE(VolumeManager);
 
     static VolumeManager* instance_;
+    /* Guards volumes_ and benchmarks_ only, volume operations run outside it so disks can be handled in parallel */
+    std::mutex lock_;
     std::map<std::string, std::shared_ptr<VolumeInfo>> volumes_;
+    std::map<std::string, std::shared_ptr<MediaBenchmark>> benchmarks_;
+    /* Check, mount, unmount, format, benchmark and destroy of a volume run here in request order */
+    VolumeOpScheduler ops_;
 
     std::shared_ptr<VolumeInfo> GetVolume(const std::string volId);
 };
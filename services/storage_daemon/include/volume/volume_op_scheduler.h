@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_STORAGE_DAEMON_VOLUME_OP_SCHEDULER_H
+#define OHOS_STORAGE_DAEMON_VOLUME_OP_SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "utils/strand_executor.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+constexpr uint32_t VOLUME_OP_THREADS = 4;
+
+/*
+ * Runs volume operations on a worker pool. The operations of one volume
+ * run one at a time in the order they were queued, so check, mount and
+ * unmount never race on its state; different volumes are handled in
+ * parallel.
+ */
+class VolumeOpScheduler {
+public:
+    using Op = std::function<int32_t()>;
+    using Done = std::function<void(int32_t err)>;
+
+    explicit VolumeOpScheduler(uint32_t threads = VOLUME_OP_THREADS);
+    /* Queues op behind the earlier ops of volId, done gets its result on the worker; false once stopped */
+    bool Post(const std::string &volId, Op op, Done done = nullptr);
+    /* Queues op like Post and waits for its result, never call it from inside an op */
+    int32_t Run(const std::string &volId, Op op);
+    /* Blocks until every op queued so far has run */
+    void WaitIdle();
+    /* Runs the ops already queued, later ones are refused */
+    void Stop();
+
+private:
+    StrandExecutor strands_;
+};
+} // STORAGE_DAEMON
+} // OHOS
+
+#endif // OHOS_STORAGE_DAEMON_VOLUME_OP_SCHEDULER_H
@@ -55,7 +55,29 @@ int32_t StorageDaemon::Format(std::string volId, std::string fsType)
 int32_t StorageDaemon::Partition(std::string diskId, int32_t type)
 {
     LOGI("Handle Partition");
-    return DiskManager::Instance()->HandlePartition(diskId);
+    return DiskManager::Instance()->HandlePartition(diskId, (type & PARTITION_FLAG_WIPE) != 0,
+        (type & PARTITION_FLAG_ZEROOUT) != 0);
+}
+
+int32_t StorageDaemon::GetDiskIoStats(std::string diskId, StorageManager::DiskIoStats &stats)
+{
+    return DiskManager::Instance()->GetDiskIoStats(diskId, stats);
+}
+
+int32_t StorageDaemon::BenchmarkVolume(std::string volId, uint32_t budgetMs,
+    StorageManager::MediaBenchmarkResult &result)
+{
+    return VolumeManager::Instance()->Benchmark(volId, budgetMs, result);
+}
+
+int32_t StorageDaemon::CancelBenchmark(std::string volId)
+{
+    return VolumeManager::Instance()->CancelBenchmark(volId);
+}
+
+int32_t StorageDaemon::CancelWipe(std::string diskId)
+{
+    return DiskManager::Instance()->CancelWipe(diskId);
 }
 
 int32_t StorageDaemon::PrepareUserDirs(int32_t userId, uint32_t flags)
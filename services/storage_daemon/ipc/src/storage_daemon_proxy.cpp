@@ -146,6 +146,95 @@ int32_t StorageDaemonProxy::Partition(std::string diskId, int32_t type)
     return reply.ReadInt32();
 }
 
+int32_t StorageDaemonProxy::GetDiskIoStats(std::string diskId, StorageManager::DiskIoStats &stats)
+{
+    MessageParcel data, reply;
+    MessageOption option(MessageOption::TF_SYNC);
+    if (!data.WriteInterfaceToken(StorageDaemonProxy::GetDescriptor())) {
+        return E_IPC_ERROR;
+    }
+
+    if (!data.WriteString(diskId)) {
+        return E_IPC_ERROR;
+    }
+
+    int err = Remote()->SendRequest(GET_DISK_IO_STATS, data, reply, option);
+    if (err != E_OK) {
+        return E_IPC_ERROR;
+    }
+
+    err = reply.ReadInt32();
+    if (err == E_OK) {
+        stats = *StorageManager::DiskIoStats::Unmarshalling(reply);
+    }
+    return err;
+}
+
+int32_t StorageDaemonProxy::BenchmarkVolume(std::string volId, uint32_t budgetMs,
+    StorageManager::MediaBenchmarkResult &result)
+{
+    MessageParcel data, reply;
+    MessageOption option(MessageOption::TF_SYNC);
+    if (!data.WriteInterfaceToken(StorageDaemonProxy::GetDescriptor())) {
+        return E_IPC_ERROR;
+    }
+
+    if (!data.WriteString(volId) || !data.WriteUint32(budgetMs)) {
+        return E_IPC_ERROR;
+    }
+
+    int err = Remote()->SendRequest(BENCHMARK_VOLUME, data, reply, option);
+    if (err != E_OK) {
+        return E_IPC_ERROR;
+    }
+
+    err = reply.ReadInt32();
+    if (err == E_OK) {
+        result = *StorageManager::MediaBenchmarkResult::Unmarshalling(reply);
+    }
+    return err;
+}
+
+int32_t StorageDaemonProxy::CancelBenchmark(std::string volId)
+{
+    MessageParcel data, reply;
+    MessageOption option(MessageOption::TF_SYNC);
+    if (!data.WriteInterfaceToken(StorageDaemonProxy::GetDescriptor())) {
+        return E_IPC_ERROR;
+    }
+
+    if (!data.WriteString(volId)) {
+        return E_IPC_ERROR;
+    }
+
+    int err = Remote()->SendRequest(CANCEL_BENCHMARK, data, reply, option);
+    if (err != E_OK) {
+        return E_IPC_ERROR;
+    }
+
+    return reply.ReadInt32();
+}
+
+int32_t StorageDaemonProxy::CancelWipe(std::string diskId)
+{
+    MessageParcel data, reply;
+    MessageOption option(MessageOption::TF_SYNC);
+    if (!data.WriteInterfaceToken(StorageDaemonProxy::GetDescriptor())) {
+        return E_IPC_ERROR;
+    }
+
+    if (!data.WriteString(diskId)) {
+        return E_IPC_ERROR;
+    }
+
+    int err = Remote()->SendRequest(CANCEL_WIPE, data, reply, option);
+    if (err != E_OK) {
+        return E_IPC_ERROR;
+    }
+
+    return reply.ReadInt32();
+}
+
 int32_t StorageDaemonProxy::PrepareUserDirs(int32_t userId, uint32_t flags)
 {
     MessageParcel data, reply;
@@ -92,6 +92,18 @@ int32_t StorageDaemonStub::OnRemoteRequest(uint32_t code, MessageParcel &data,
         case PARTITION:
             err = HandlePartition(data, reply);
             break;
+        case GET_DISK_IO_STATS:
+            err = HandleGetDiskIoStats(data, reply);
+            break;
+        case BENCHMARK_VOLUME:
+            err = HandleBenchmarkVolume(data, reply);
+            break;
+        case CANCEL_BENCHMARK:
+            err = HandleCancelBenchmark(data, reply);
+            break;
+        case CANCEL_WIPE:
+            err = HandleCancelWipe(data, reply);
+            break;
         case FORMAT:
             err = HandleFormat(data, reply);
             break;
@@ -210,6 +222,63 @@ int32_t StorageDaemonStub::HandlePartition(MessageParcel &data, MessageParcel &r
     return E_OK;
 }
 
+int32_t StorageDaemonStub::HandleGetDiskIoStats(MessageParcel &data, MessageParcel &reply)
+{
+    std::string diskId = data.ReadString();
+
+    StorageManager::DiskIoStats stats;
+    int err = GetDiskIoStats(diskId, stats);
+    if (!reply.WriteInt32(err)) {
+        return  E_IPC_ERROR;
+    }
+    if (err == E_OK && !stats.Marshalling(reply)) {
+        return  E_IPC_ERROR;
+    }
+
+    return E_OK;
+}
+
+int32_t StorageDaemonStub::HandleBenchmarkVolume(MessageParcel &data, MessageParcel &reply)
+{
+    std::string volId = data.ReadString();
+    uint32_t budgetMs = data.ReadUint32();
+
+    StorageManager::MediaBenchmarkResult result;
+    int err = BenchmarkVolume(volId, budgetMs, result);
+    if (!reply.WriteInt32(err)) {
+        return  E_IPC_ERROR;
+    }
+    if (err == E_OK && !result.Marshalling(reply)) {
+        return  E_IPC_ERROR;
+    }
+
+    return E_OK;
+}
+
+int32_t StorageDaemonStub::HandleCancelBenchmark(MessageParcel &data, MessageParcel &reply)
+{
+    std::string volId = data.ReadString();
+
+    int err = CancelBenchmark(volId);
+    if (!reply.WriteInt32(err)) {
+        return  E_IPC_ERROR;
+    }
+
+    return E_OK;
+}
+
+int32_t StorageDaemonStub::HandleCancelWipe(MessageParcel &data, MessageParcel &reply)
+{
+    std::string diskId = data.ReadString();
+
+    int err = CancelWipe(diskId);
+    if (!reply.WriteInt32(err)) {
+        return  E_IPC_ERROR;
+    }
+
+    return E_OK;
+}
+
 int32_t StorageDaemonStub::HandlePrepareUserDirs(MessageParcel &data, MessageParcel &reply)
 {
     int32_t userId = data.ReadInt32();
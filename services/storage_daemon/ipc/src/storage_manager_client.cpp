@@ -99,9 +99,11 @@ int32_t StorageManagerClient::NotifyVolumeMounted(std::shared_ptr<VolumeInfo> vo
         return E_IPC_ERROR;
     }
 
+    /* Mounts complete asynchronously, a failed one is reported with an empty path */
     std::shared_ptr<ExternalVolumeInfo> info = std::static_pointer_cast<ExternalVolumeInfo>(volumeInfo);
+    std::string path = info->GetState() == MOUNTED ? info->GetMountPath() : "";
     storageManager_->NotifyVolumeMounted(info->GetVolumeId(), info->GetFsType(), info->GetFsUuid(),
-                                         info->GetMountPath(), info->GetFsLabel());
+                                         path, info->GetFsLabel());
 
     return E_OK;
 }
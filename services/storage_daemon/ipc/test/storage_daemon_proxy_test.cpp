@@ -66,6 +66,75 @@ HWTEST_F(StorageDaemonProxyTest, StorageDaemonProxyTest_Shutdown_001, TestSize.L
     GTEST_LOG_(INFO) << "StorageDaemonProxyTest_Shutdown_001 end";
 }
 
+/**
+ * @tc.name: StorageDaemonProxyTest_GetDiskIoStats_001
+ * @tc.desc: Verify the GetDiskIoStats function.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(StorageDaemonProxyTest, StorageDaemonProxyTest_GetDiskIoStats_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "StorageDaemonProxyTest_GetDiskIoStats_001 start";
+
+    EXPECT_CALL(*mock_, SendRequest(testing::_, testing::_, testing::_, testing::_))
+        .Times(1)
+        .WillOnce(testing::Invoke(mock_.GetRefPtr(), &StorageDaemonServiceMock::InvokeSendRequest));
+
+    StorageManager::DiskIoStats stats;
+    int32_t ret = proxy_->GetDiskIoStats("disk-8-0", stats);
+    ASSERT_TRUE(ret == E_OK);
+    ASSERT_TRUE(IStorageDaemon::GET_DISK_IO_STATS == mock_->code_);
+
+    GTEST_LOG_(INFO) << "StorageDaemonProxyTest_GetDiskIoStats_001 end";
+}
+
+/**
+ * @tc.name: StorageDaemonProxyTest_BenchmarkVolume_001
+ * @tc.desc: Verify the BenchmarkVolume and CancelBenchmark functions.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(StorageDaemonProxyTest, StorageDaemonProxyTest_BenchmarkVolume_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "StorageDaemonProxyTest_BenchmarkVolume_001 start";
+
+    EXPECT_CALL(*mock_, SendRequest(testing::_, testing::_, testing::_, testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke(mock_.GetRefPtr(), &StorageDaemonServiceMock::InvokeSendRequest));
+
+    StorageManager::MediaBenchmarkResult result;
+    int32_t ret = proxy_->BenchmarkVolume("vol-8-1", 1000, result);
+    ASSERT_TRUE(ret == E_OK);
+    ASSERT_TRUE(IStorageDaemon::BENCHMARK_VOLUME == mock_->code_);
+
+    ret = proxy_->CancelBenchmark("vol-8-1");
+    ASSERT_TRUE(ret == E_OK);
+    ASSERT_TRUE(IStorageDaemon::CANCEL_BENCHMARK == mock_->code_);
+
+    GTEST_LOG_(INFO) << "StorageDaemonProxyTest_BenchmarkVolume_001 end";
+}
+
+/**
+ * @tc.name: StorageDaemonProxyTest_CancelWipe_001
+ * @tc.desc: Verify the CancelWipe function.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(StorageDaemonProxyTest, StorageDaemonProxyTest_CancelWipe_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "StorageDaemonProxyTest_CancelWipe_001 start";
+
+    EXPECT_CALL(*mock_, SendRequest(testing::_, testing::_, testing::_, testing::_))
+        .Times(1)
+        .WillOnce(testing::Invoke(mock_.GetRefPtr(), &StorageDaemonServiceMock::InvokeSendRequest));
+
+    int32_t ret = proxy_->CancelWipe("disk-8-0");
+    ASSERT_TRUE(ret == E_OK);
+    ASSERT_TRUE(IStorageDaemon::CANCEL_WIPE == mock_->code_);
+
+    GTEST_LOG_(INFO) << "StorageDaemonProxyTest_CancelWipe_001 end";
+}
+
 /**
  * @tc.name: StorageDaemonProxyTest_PrepareUserDirs_001
  * @tc.desc: Verify the PrepareUserDirs function.
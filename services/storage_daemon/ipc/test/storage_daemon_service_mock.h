@@ -64,6 +64,29 @@ public:
         return E_OK;
     }
 
+    virtual int32_t GetDiskIoStats(std::string diskId, StorageManager::DiskIoStats &stats) override
+    {
+        stats.diskId_ = diskId;
+        return E_OK;
+    }
+
+    virtual int32_t BenchmarkVolume(std::string volId, uint32_t budgetMs,
+        StorageManager::MediaBenchmarkResult &result) override
+    {
+        result.volumeId_ = volId;
+        return E_OK;
+    }
+
+    virtual int32_t CancelBenchmark(std::string volId) override
+    {
+        return E_OK;
+    }
+
+    virtual int32_t CancelWipe(std::string diskId) override
+    {
+        return E_OK;
+    }
+
     virtual int32_t StartUser(int32_t userId) override
     {
         return E_OK;
@@ -30,6 +30,10 @@ public:
     MOCK_METHOD1(Check, int32_t(std::string));
     MOCK_METHOD2(Format, int32_t(std::string, std::string));
     MOCK_METHOD2(Partition, int32_t(std::string, int32_t));
+    MOCK_METHOD2(GetDiskIoStats, int32_t(std::string, StorageManager::DiskIoStats &));
+    MOCK_METHOD3(BenchmarkVolume, int32_t(std::string, uint32_t, StorageManager::MediaBenchmarkResult &));
+    MOCK_METHOD1(CancelBenchmark, int32_t(std::string));
+    MOCK_METHOD1(CancelWipe, int32_t(std::string));
 
     MOCK_METHOD1(StartUser, int32_t(int32_t));
     MOCK_METHOD1(StopUser, int32_t(int32_t));
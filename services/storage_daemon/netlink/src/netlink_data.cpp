@@ -14,58 +14,168 @@
  */
 #include "netlink/netlink_data.h"
 
+#include <charconv>
+#include <cstring>
+
 #include "ipc/storage_daemon.h"
 #include "storage_service_errno.h"
 #include "storage_service_log.h"
 
-constexpr int ACTION_PRE_LEN = 7;
-constexpr int DEVPATH_PRE_LEN = 8;
-constexpr int SUBSYSTEM_PRE_LEN = 10;
-constexpr int NL_PARAMS_MAX = 128;
-
 namespace OHOS {
 namespace StorageDaemon {
-void NetlinkData::Decode(const char *msg)
+namespace {
+struct KeyEntry {
+    std::string_view name;
+    NetlinkData::ParamKey key;
+};
+
+constexpr KeyEntry KEY_TABLE[] = {
+    {"ACTION", NetlinkData::PARAM_ACTION},
+    {"DEVPATH", NetlinkData::PARAM_DEVPATH},
+    {"SUBSYSTEM", NetlinkData::PARAM_SUBSYSTEM},
+    {"DEVTYPE", NetlinkData::PARAM_DEVTYPE},
+    {"MAJOR", NetlinkData::PARAM_MAJOR},
+    {"MINOR", NetlinkData::PARAM_MINOR},
+    {"DEVNAME", NetlinkData::PARAM_DEVNAME},
+    {"PARTN", NetlinkData::PARAM_PARTN},
+};
+
+struct ActionEntry {
+    std::string_view name;
+    NetlinkData::Actions action;
+};
+
+constexpr ActionEntry ACTION_TABLE[] = {
+    {"add", NetlinkData::Actions::ADD},
+    {"remove", NetlinkData::Actions::REMOVE},
+    {"move", NetlinkData::Actions::MOVE},
+    {"change", NetlinkData::Actions::CHANGE},
+    {"online", NetlinkData::Actions::ONLINE},
+    {"offline", NetlinkData::Actions::OFFLINE},
+    {"bind", NetlinkData::Actions::BIND},
+    {"unbind", NetlinkData::Actions::UNBIND},
+};
+
+int32_t ParseNumber(std::string_view value)
 {
-    int32_t paramIdx = 0;
+    int32_t number = -1;
+    auto res = std::from_chars(value.data(), value.data() + value.size(), number);
+    if (res.ec != std::errc() || res.ptr != value.data() + value.size() || number < 0) {
+        return -1;
+    }
+    return number;
+}
+} // namespace
 
-    while (*msg) {
-        if (!strncmp(msg, "ACTION=", ACTION_PRE_LEN)) {
-            msg += ACTION_PRE_LEN;
-            auto iter = actionMaps.find(msg);
-            if (iter != actionMaps.end()) {
-                action_ = iter->second;
-            }
-        } else if (!strncmp(msg, "DEVPATH=", DEVPATH_PRE_LEN)) {
-            msg += DEVPATH_PRE_LEN;
-            devPath_ = strdup(msg);
-            sysPath_ = "/sys";
-            sysPath_ += devPath_;
-        } else if (!strncmp(msg, "SUBSYSTEM=", SUBSYSTEM_PRE_LEN)) {
-            msg += SUBSYSTEM_PRE_LEN;
-            subSystem_ = strdup(msg);
-        } else if (paramIdx < NL_PARAMS_MAX) {
-            params_.push_back(strdup(msg));
-            ++paramIdx;
+const std::map<std::string, NetlinkData::Actions> NetlinkData::actionMaps = {
+    {"add", Actions::ADD},
+    {"remove", Actions::REMOVE},
+    {"move", Actions::MOVE},
+    {"change", Actions::CHANGE},
+    {"online", Actions::ONLINE},
+    {"offline", Actions::OFFLINE},
+    {"bind", Actions::BIND},
+    {"unbind", Actions::UNBIND}
+};
+
+void NetlinkData::Reset()
+{
+    for (auto &key : keys_) {
+        key = std::string_view();
+    }
+    msg_ = std::string_view();
+    major_ = -1;
+    minor_ = -1;
+    action_ = Actions::UNKNOWN;
+}
+
+void NetlinkData::DecodeEntry(std::string_view entry)
+{
+    size_t sep = entry.find('=');
+    if (sep == std::string_view::npos) {
+        return;
+    }
+    std::string_view name = entry.substr(0, sep);
+    for (const auto &item : KEY_TABLE) {
+        if (item.name != name) {
+            continue;
         }
-        while (*msg++);
+        std::string_view value = entry.substr(sep + 1);
+        keys_[item.key] = value;
+        switch (item.key) {
+            case PARAM_ACTION:
+                for (const auto &act : ACTION_TABLE) {
+                    if (act.name == value) {
+                        action_ = act.action;
+                        break;
+                    }
+                }
+                break;
+            case PARAM_MAJOR:
+                major_ = ParseNumber(value);
+                break;
+            case PARAM_MINOR:
+                minor_ = ParseNumber(value);
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+}
+
+void NetlinkData::Decode(const char *msg)
+{
+    Reset();
+    const char *start = msg;
+    while (*msg) {
+        size_t len = strlen(msg);
+        DecodeEntry(std::string_view(msg, len));
+        msg += len + 1;
+    }
+    msg_ = std::string_view(start, msg - start);
+}
+
+void NetlinkData::Decode(const char *msg, size_t len)
+{
+    Reset();
+    msg_ = std::string_view(msg, len);
+    const char *end = msg + len;
+    while (msg < end && *msg) {
+        auto next = static_cast<const char *>(memchr(msg, '\0', end - msg));
+        size_t entryLen = (next == nullptr) ? static_cast<size_t>(end - msg) : static_cast<size_t>(next - msg);
+        DecodeEntry(std::string_view(msg, entryLen));
+        msg += entryLen + 1;
     }
-    return;
+}
+
+size_t NetlinkData::MessageLength(const char *msg, size_t maxLen)
+{
+    size_t len = 0;
+    while (len < maxLen && msg[len] != '\0') {
+        len += strnlen(msg + len, maxLen - len) + 1;
+    }
+    return (len > maxLen) ? maxLen : len;
 }
 
 std::string NetlinkData::GetSyspath()
 {
-    return sysPath_.empty() ? "" : sysPath_;
+    if (keys_[PARAM_DEVPATH].empty()) {
+        return "";
+    }
+    std::string sysPath = "/sys";
+    sysPath.append(keys_[PARAM_DEVPATH]);
+    return sysPath;
 }
 
 std::string NetlinkData::GetDevpath()
 {
-    return devPath_.empty() ? "" : devPath_;
+    return std::string(keys_[PARAM_DEVPATH]);
 }
 
 std::string NetlinkData::GetSubsystem()
 {
-    return subSystem_.empty() ? "" : subSystem_;
+    return std::string(keys_[PARAM_SUBSYSTEM]);
 }
 
 NetlinkData::Actions NetlinkData::GetAction()
@@ -73,20 +183,39 @@ NetlinkData::Actions NetlinkData::GetAction()
     return action_;
 }
 
+int32_t NetlinkData::GetMajor() const
+{
+    return major_;
+}
+
+int32_t NetlinkData::GetMinor() const
+{
+    return minor_;
+}
+
+std::string_view NetlinkData::GetParam(ParamKey key) const
+{
+    if (key < 0 || key >= PARAM_KEY_MAX) {
+        return std::string_view();
+    }
+    return keys_[key];
+}
+
 const std::string NetlinkData::GetParam(const std::string paramName)
 {
     size_t len = paramName.size();
+    std::string_view rest = msg_;
 
-    std::vector<std::string>::iterator iter;
-    for (iter = params_.begin(); iter != params_.end(); ++iter) {
-        const char *ptr = iter->c_str() + len;
-        if (strncmp(iter->c_str(), paramName.c_str(), len) == 0 && *ptr == '=') {
-            return ++ptr;
+    while (!rest.empty() && rest.front() != '\0') {
+        size_t end = rest.find('\0');
+        std::string_view param = rest.substr(0, end);
+        if (param.size() > len && param.compare(0, len, paramName) == 0 && param[len] == '=') {
+            return std::string(param.substr(len + 1));
         }
+        rest.remove_prefix((end == std::string_view::npos) ? rest.size() : end + 1);
     }
 
     return "";
 }
 } // StorageDaemon
 } // OHOS
-
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "netlink/netlink_filter.h"
+
+#include <cerrno>
+
+#include <sys/socket.h>
+
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr uint32_t FILTER_ACCEPT = 0xffffffff;
+constexpr uint32_t FILTER_REJECT = 0;
+constexpr uint32_t SUBSYSTEM_OFFSET_BASE = 15;
+
+/* "SUBSYSTEM=block\0" as the big-endian words loaded by BPF_W */
+constexpr uint32_t SUBSYSTEM_BLOCK_WORDS[] = { 0x53554253, 0x59535445, 0x4d3d626c, 0x6f636b00 };
+constexpr uint32_t WORD_SIZE = 4;
+} // namespace
+
+std::vector<struct sock_filter> BuildBlockUeventFilter()
+{
+    std::vector<struct sock_filter> prog;
+    const uint32_t wordCount = sizeof(SUBSYSTEM_BLOCK_WORDS) / sizeof(SUBSYSTEM_BLOCK_WORDS[0]);
+    const uint32_t matchStart = UEVENT_FILTER_HEADER_MAX * 4 + 1;
+
+    /* Per header position: if byte i is NUL, X = offset of SUBSYSTEM= and jump to the match block */
+    for (uint32_t i = 0; i < UEVENT_FILTER_HEADER_MAX; i++) {
+        prog.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, i));
+        prog.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, 2));
+        prog.push_back(BPF_STMT(BPF_LDX | BPF_W | BPF_IMM, 2 * (i + 1) + SUBSYSTEM_OFFSET_BASE));
+        uint32_t here = static_cast<uint32_t>(prog.size());
+        prog.push_back(BPF_STMT(BPF_JMP | BPF_JA, matchStart - here - 1));
+    }
+    prog.push_back(BPF_STMT(BPF_RET | BPF_K, FILTER_ACCEPT));
+
+    for (uint32_t i = 0; i < wordCount; i++) {
+        uint8_t toReject = static_cast<uint8_t>((wordCount - i - 1) * 2 + 1);
+        prog.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_IND, i * WORD_SIZE));
+        prog.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, SUBSYSTEM_BLOCK_WORDS[i], 0, toReject));
+    }
+    prog.push_back(BPF_STMT(BPF_RET | BPF_K, FILTER_ACCEPT));
+    prog.push_back(BPF_STMT(BPF_RET | BPF_K, FILTER_REJECT));
+
+    return prog;
+}
+
+int32_t AttachBlockUeventFilter(int32_t socketFd)
+{
+    std::vector<struct sock_filter> prog = BuildBlockUeventFilter();
+    struct sock_fprog fprog = {
+        .len = static_cast<unsigned short>(prog.size()),
+        .filter = prog.data(),
+    };
+
+    if (setsockopt(socketFd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) != 0) {
+        LOGE("Set SO_ATTACH_FILTER failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+
+    LOGI("Block uevent filter attached, %{public}zu instructions", prog.size());
+    return E_OK;
+}
+} // StorageDaemon
+} // OHOS
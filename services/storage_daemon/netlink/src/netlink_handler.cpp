@@ -14,32 +14,208 @@
  */
 #include "netlink/netlink_handler.h"
 
-#include "netlink/netlink_data.h"
+#include <cstring>
+#include <string_view>
+
+#include "securec.h"
 #include "storage_service_errno.h"
 #include "storage_service_log.h"
 #include "disk/disk_manager.h"
 
 namespace OHOS {
 namespace StorageDaemon {
-NetlinkHandler::NetlinkHandler(int32_t socket) : NetlinkListener(socket) {}
+constexpr uint64_t UEVENT_SLOW_LATENCY_US = 1000000;
+constexpr std::string_view UEVENT_SUBSYSTEM_KEY = "SUBSYSTEM=";
+
+/* Checks the raw entries, so events of other subsystems never take or overflow a queue slot */
+static bool IsBlockUevent(const char *msg, size_t len)
+{
+    for (size_t pos = 0; pos < len;) {
+        std::string_view entry(msg + pos, strnlen(msg + pos, len - pos));
+        if (entry.empty()) {
+            break;
+        }
+        if (entry.compare(0, UEVENT_SUBSYSTEM_KEY.size(), UEVENT_SUBSYSTEM_KEY) == 0) {
+            return entry.substr(UEVENT_SUBSYSTEM_KEY.size()) == "block";
+        }
+        pos += entry.size() + 1;
+    }
+    return false;
+}
+
+template<typename T>
+static void UpdateMax(std::atomic<T> &target, T value)
+{
+    T cur = target.load(std::memory_order_relaxed);
+    while (value > cur && !target.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+}
+
+NetlinkHandler::NetlinkHandler(int32_t socket, std::chrono::milliseconds settleWindow)
+    : NetlinkListener(socket), queue_(UEVENT_QUEUE_SIZE), coalescer_(settleWindow) {}
+
+NetlinkHandler::~NetlinkHandler()
+{
+    if (workerThread_ != nullptr) {
+        workerStop_ = true;
+        WakeWorker();
+        workerThread_->join();
+    }
+}
 
 int32_t NetlinkHandler::Start()
 {
+    if (workerThread_ == nullptr) {
+        workerStop_ = false;
+        workerThread_ = std::make_unique<std::thread>(&NetlinkHandler::RunWorker, this);
+    }
     return this->StartListener();
 }
 
 int32_t NetlinkHandler::Stop()
 {
-    return this->StopListener();
+    int32_t ret = this->StopListener();
+
+    if (workerThread_ != nullptr) {
+        workerStop_ = true;
+        WakeWorker();
+        workerThread_->join();
+        workerThread_ = nullptr;
+    }
+    return ret;
+}
+
+UeventQueueStats NetlinkHandler::GetQueueStats() const
+{
+    UeventQueueStats stats;
+
+    stats.enqueued = enqueued_.load();
+    stats.processed = processed_.load();
+    stats.dropped = dropped_.load();
+    stats.depth = static_cast<uint32_t>(queue_.Size());
+    stats.maxDepth = maxDepth_.load();
+    stats.avgLatencyUs = (stats.processed == 0) ? 0 : totalLatencyUs_.load() / stats.processed;
+    stats.maxLatencyUs = maxLatencyUs_.load();
+    stats.dispatched = dispatched_.load();
+    stats.avgProcessUs = (stats.dispatched == 0) ? 0 : totalProcessUs_.load() / stats.dispatched;
+    stats.maxProcessUs = maxProcessUs_.load();
+    stats.resyncs = resyncs_.load();
+    stats.coalesced = coalesced_.load();
+    return stats;
+}
+
+void NetlinkHandler::OnEvent(char *msg, size_t len)
+{
+    len = NetlinkData::MessageLength(msg, len);
+    if (!IsBlockUevent(msg, len)) {
+        return;
+    }
+
+    UeventSlot *slot = queue_.Reserve();
+    if (slot == nullptr) {
+        dropped_++;
+        LOGE("Uevent queue full, event dropped");
+        RequestResync();
+        return;
+    }
+
+    slot->msg.assign(msg, len);
+    slot->data.Decode(slot->msg.data(), slot->msg.size());
+
+    slot->enqueueTime = std::chrono::steady_clock::now();
+    queue_.Commit();
+    enqueued_++;
+    UpdateMax(maxDepth_, static_cast<uint32_t>(queue_.Size()));
+    WakeWorker();
+}
+
+void NetlinkHandler::OnOverflow()
+{
+    RequestResync();
+}
+
+void NetlinkHandler::HandleEvent(NetlinkData *data)
+{
+    DiskManager::Instance()->HandleDiskEvent(data);
+}
+
+void NetlinkHandler::Resync()
+{
+    DiskManager::Instance()->Resync();
+}
+
+void NetlinkHandler::RequestResync()
+{
+    resyncPending_ = true;
+    WakeWorker();
 }
 
-void NetlinkHandler::OnEvent(char *msg)
+void NetlinkHandler::WakeWorker()
 {
-    auto nlData = std::make_unique<NetlinkData>();
+    if (workerSleeping_.load()) {
+        std::lock_guard<std::mutex> lock(workerLock_);
+        workerCond_.notify_one();
+    }
+}
+
+bool NetlinkHandler::WaitForEvent()
+{
+    auto ready = [this] { return workerStop_.load() || resyncPending_.load() || !queue_.Empty(); };
+    std::unique_lock<std::mutex> lock(workerLock_);
+    workerSleeping_ = true;
+    /* Pairs with the seq_cst Commit() so either we see the new slot or the producer sees us asleep */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    UeventCoalescer::Clock::time_point deadline;
+    if (coalescer_.NextDeadline(deadline)) {
+        workerCond_.wait_until(lock, deadline, ready);
+    } else {
+        workerCond_.wait(lock, ready);
+    }
+    workerSleeping_ = false;
+    return !workerStop_.load();
+}
+
+void NetlinkHandler::DispatchEvent(NetlinkData *data)
+{
+    auto start = std::chrono::steady_clock::now();
+    HandleEvent(data);
+    uint64_t processUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    dispatched_++;
+    totalProcessUs_ += processUs;
+    UpdateMax(maxProcessUs_, processUs);
+}
+
+void NetlinkHandler::RunWorker()
+{
+    auto emit = [this](NetlinkData *data) { DispatchEvent(data); };
+    while (WaitForEvent()) {
+        UeventSlot *slot = nullptr;
+        while ((slot = queue_.Front()) != nullptr) {
+            auto now = std::chrono::steady_clock::now();
+            if (coalescer_.Push(slot->data, slot->msg.data(), slot->msg.size(), now)) {
+                coalesced_++;
+            } else {
+                DispatchEvent(&slot->data);
+            }
+            uint64_t latencyUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - slot->enqueueTime).count());
+            queue_.Pop();
+
+            processed_++;
+            totalLatencyUs_ += latencyUs;
+            UpdateMax(maxLatencyUs_, latencyUs);
+            if (latencyUs > UEVENT_SLOW_LATENCY_US) {
+                LOGW("Slow uevent, latency %{public}llu us", static_cast<unsigned long long>(latencyUs));
+            }
+        }
 
-    nlData->Decode(msg);
-    if (strcmp(nlData->GetSubsystem().c_str(), "block") == 0) {
-        DiskManager::Instance()->HandleDiskEvent(nlData.get());
+        /* Resync after draining so it observes the state left by every event queued before the loss */
+        if (resyncPending_.exchange(false)) {
+            coalescer_.Clear();
+            Resync();
+            resyncs_++;
+        }
+        coalescer_.Flush(std::chrono::steady_clock::now(), emit);
     }
 }
 } // StorageDaemon
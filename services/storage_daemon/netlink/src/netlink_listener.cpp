@@ -14,11 +14,13 @@
  */
 #include "netlink/netlink_listener.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <memory>
 #include <iostream>
+#include <vector>
 
-#include <sys/socket.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <linux/netlink.h>
@@ -27,149 +29,236 @@
 #include "storage_service_errno.h"
 #include "storage_service_log.h"
 
-constexpr int POLL_IDLE_TIME = 1000;
-constexpr int UEVENT_MSG_LEN = 1024;
+constexpr int UEVENT_BATCH_SIZE = 32;
 
 namespace OHOS {
 namespace StorageDaemon {
-ssize_t UeventKernelMulticastRecv(int32_t socket, char *buffer, size_t length)
+/*
+ * Preallocated message slots drained by a single recvmmsg call. The message
+ * buffers live in one block that is reused across batches and only grows
+ * when a larger uevent shows up.
+ */
+struct UeventRing {
+    struct mmsghdr hdrs[UEVENT_BATCH_SIZE];
+    struct iovec iovs[UEVENT_BATCH_SIZE];
+    struct sockaddr_nl addrs[UEVENT_BATCH_SIZE];
+    char control[UEVENT_BATCH_SIZE][CMSG_SPACE(sizeof(struct ucred))];
+    std::vector<char> msgs;
+    size_t msgLen { 0 };
+
+    char *Msg(int32_t i)
+    {
+        return msgs.data() + static_cast<size_t>(i) * (msgLen + 1);
+    }
+};
+
+/* Returns false if len is over UEVENT_MSG_MAX, the buffers are grown as far as allowed anyway */
+static bool GrowUeventRing(UeventRing &ring, size_t len)
+{
+    size_t msgLen = (ring.msgLen == 0) ? UEVENT_MSG_LEN : ring.msgLen;
+    while (msgLen < len && msgLen < static_cast<size_t>(UEVENT_MSG_MAX)) {
+        msgLen *= 2;
+    }
+    if (msgLen != ring.msgLen) {
+        ring.msgs.resize(UEVENT_BATCH_SIZE * (msgLen + 1));
+        ring.msgLen = msgLen;
+        LOGI("Uevent receive buffer is %{public}zu bytes", msgLen);
+    }
+    return len <= msgLen;
+}
+
+static void ResetUeventRing(UeventRing &ring)
 {
-    struct iovec iov = { buffer, length };
-    struct sockaddr_nl addr;
-    char control[CMSG_SPACE(sizeof(struct ucred))];
-    struct msghdr hdr = {
-        .msg_name = &addr,
-        .msg_namelen = sizeof(addr),
-        .msg_iov = &iov,
-        .msg_iovlen = 1,
-        .msg_control = control,
-        .msg_controllen = sizeof(control),
-        .msg_flags = 0,
-    };
-    struct cmsghdr *cmsg;
-
-    ssize_t n = recvmsg(socket, &hdr, 0);
-    if (n <= 0) {
-        LOGE("Recvmsg failed, errno %{public}d", errno);
-        return n;
+    for (int32_t i = 0; i < UEVENT_BATCH_SIZE; i++) {
+        ring.iovs[i].iov_base = ring.Msg(i);
+        ring.iovs[i].iov_len = ring.msgLen;
+
+        struct msghdr &hdr = ring.hdrs[i].msg_hdr;
+        hdr.msg_name = &ring.addrs[i];
+        hdr.msg_namelen = sizeof(ring.addrs[i]);
+        hdr.msg_iov = &ring.iovs[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = ring.control[i];
+        hdr.msg_controllen = sizeof(ring.control[i]);
+        hdr.msg_flags = 0;
+        ring.hdrs[i].msg_len = 0;
     }
+}
 
+static bool CheckUeventOrigin(const struct msghdr &hdr, const struct sockaddr_nl &addr)
+{
     if (addr.nl_groups == 0 || addr.nl_pid != 0) {
         LOGE("Groups or pid check failed");
-        return E_ERR;
+        return false;
+    }
+
+    bool credChecked = false;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+        cmsg = CMSG_NXTHDR(const_cast<struct msghdr *>(&hdr), cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_CREDENTIALS) {
+            continue;
+        }
+        struct ucred cred;
+        if (memcpy_s(&cred, sizeof(cred), CMSG_DATA(cmsg), sizeof(struct ucred)) != EOK || cred.uid != 0) {
+            LOGE("Uid check failed");
+            return false;
+        }
+        credChecked = true;
     }
 
-    cmsg = CMSG_FIRSTHDR(&hdr);
-    if (cmsg == nullptr || cmsg->cmsg_type != SCM_CREDENTIALS) {
+    if (!credChecked) {
         LOGE("SCM_CREDENTIALS check failed");
-        return E_ERR;
+        return false;
     }
+    return true;
+}
 
-    struct ucred cred;
-    if (memcpy_s(&cred, sizeof(cred), CMSG_DATA(cmsg), sizeof(struct ucred)) != EOK || cred.uid != 0) {
-        LOGE("Uid check failed");
-        return E_ERR;
+/* Size of the datagram at the head of the queue, without consuming it */
+static ssize_t UeventPeekLen(int32_t socket)
+{
+    ssize_t len = TEMP_FAILURE_RETRY(recv(socket, nullptr, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT));
+    if (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+        LOGE("Peek uevent failed, errno %{public}d", errno);
     }
+    return len;
+}
 
+int32_t UeventKernelMulticastRecv(int32_t socket, UeventRing &ring)
+{
+    ResetUeventRing(ring);
+
+    /* MSG_TRUNC makes msg_len the full datagram size, so oversized uevents can be told apart */
+    int32_t n = TEMP_FAILURE_RETRY(recvmmsg(socket, ring.hdrs, UEVENT_BATCH_SIZE, MSG_DONTWAIT | MSG_TRUNC, nullptr));
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+        LOGE("Recvmmsg failed, errno %{public}d", errno);
+    }
     return n;
 }
 
 void NetlinkListener::RecvUeventMsg()
 {
-    auto msg = std::make_unique<char[]>(UEVENT_MSG_LEN + 1);
-    ssize_t count;
+    uint32_t received = 0;
+    uint32_t dropped = 0;
+    uint32_t truncated = 0;
+    bool overflow = false;
 
     while (1) {
-        count = UeventKernelMulticastRecv(socketFd_, msg.get(), UEVENT_MSG_LEN);
-        if (count <= 0) {
-            (void)memset_s(msg.get(), UEVENT_MSG_LEN + 1, 0, UEVENT_MSG_LEN + 1);
-            break;
+        /*
+         * Size the batch by the head datagram so a large uevent grows the
+         * buffers before it is read. One further down the same batch can
+         * still be cut, then it is counted and the disks are resynced.
+         */
+        ssize_t next = UeventPeekLen(socketFd_);
+        int32_t count = -1;
+        if (next >= 0) {
+            (void)GrowUeventRing(*ring_, static_cast<size_t>(next));
+            count = UeventKernelMulticastRecv(socketFd_, *ring_);
         }
-        if (count >= UEVENT_MSG_LEN) {
+        if (count < 0 && errno == ENOBUFS) {
+            /* The kernel reports the overrun once and keeps the queued messages, keep draining */
+            overflow = true;
             continue;
         }
-
-        msg.get()[count] = '\0';
-        OnEvent(msg.get());
-    }
-}
-
-int32_t NetlinkListener::ReadMsg(int32_t fd_count, struct pollfd ufds[2])
-{
-    int32_t i;
-    for (i = 0; i < fd_count; i++) {
-        if (ufds[i].revents == 0) {
-            continue;
+        if (count <= 0) {
+            break;
         }
 
-        if (ufds[i].fd == socketPipe_[0]) {
-            int32_t msg;
-            if (read(socketPipe_[0], &msg, 1) < 0) {
-                LOGE("Read socket pipe failed");
-                return E_ERR;
-            }
-            if (msg == 0) {
-                LOGI("Stop listener");
-                return E_ERR;
-            }
-        } else if (ufds[i].fd == socketFd_) {
-            if ((static_cast<uint32_t>(ufds[i].revents) & POLLIN)) {
-                RecvUeventMsg();
+        size_t maxLen = 0;
+        for (int32_t i = 0; i < count; i++) {
+            const struct msghdr &hdr = ring_->hdrs[i].msg_hdr;
+            uint32_t len = ring_->hdrs[i].msg_len;
+            if (originCheck_ && !CheckUeventOrigin(hdr, ring_->addrs[i])) {
+                dropped++;
                 continue;
             }
-            if ((static_cast<uint32_t>(ufds[i].revents)) & (POLLERR | POLLHUP)) {
-                LOGE("POLLERR | POLLHUP");
-                return E_ERR;
+            if (len > ring_->msgLen) {
+                maxLen = std::max(maxLen, static_cast<size_t>(len));
+                truncated++;
+                continue;
             }
-        }
-    }
-    return E_OK;
-}
-
-void NetlinkListener::RunListener()
-{
-    struct pollfd ufds[2];
-    int32_t idle_time = POLL_IDLE_TIME;
 
-    while (1) {
-        int32_t fd_count = 0;
-
-        ufds[fd_count].fd = socketPipe_[0];
-        ufds[fd_count].events = POLLIN;
-        ufds[fd_count].revents = 0;
-        fd_count++;
-
-        if (socketFd_ > -1) {
-            ufds[fd_count].fd = socketFd_;
-            ufds[fd_count].events = POLLIN;
-            ufds[fd_count].revents = 0;
-            fd_count++;
+            char *msg = ring_->Msg(i);
+            msg[len] = '\0';
+            OnEvent(msg, len);
+        }
+        received += static_cast<uint32_t>(count);
+        if (maxLen > 0) {
+            /* Only grow between batches, the headers still point into the old block until here */
+            (void)GrowUeventRing(*ring_, maxLen);
         }
 
-        int32_t n = poll(ufds, fd_count, idle_time);
-        if (n < 0) {
-            if (errno == EAGAIN || errno == EINTR) {
-                continue;
-            }
+        if (count < UEVENT_BATCH_SIZE) {
             break;
-        } else if (!n) {
-            continue;
         }
+    }
 
-        if (ReadMsg(fd_count, ufds) != 0) {
-            return;
-        }
+    wakeups_++;
+    messages_ += received;
+    dropped_ += dropped + truncated;
+    truncated_ += truncated;
+    bufferSize_ = static_cast<uint32_t>(ring_->msgLen);
+    if (received > maxBatch_) {
+        maxBatch_ = received;
     }
+    if (dropped > 0) {
+        LOGW("Dropped %{public}u of %{public}u uevents", dropped, received);
+    }
+    if (truncated > 0) {
+        LOGW("Lost %{public}u oversized uevents, buffer now %{public}zu bytes", truncated, ring_->msgLen);
+        overflow = true;
+    }
+    if (overflow) {
+        overflows_++;
+        LOGW("Uevent socket overflowed");
+        OnOverflow();
+    }
+}
+
+void NetlinkListener::OnOverflow() {}
+
+UeventStats NetlinkListener::GetStats() const
+{
+    UeventStats stats;
+    stats.wakeups = wakeups_;
+    stats.messages = messages_;
+    stats.dropped = dropped_;
+    stats.maxBatch = maxBatch_;
+    stats.overflows = overflows_;
+    stats.truncated = truncated_;
+    stats.bufferSize = bufferSize_;
+    return stats;
 }
 
-void NetlinkListener::EventProcess(void *object)
+void NetlinkListener::OnSocketEvent(uint32_t events)
 {
-    if (object == nullptr) {
+    if (events & static_cast<uint32_t>(EPOLLIN)) {
+        RecvUeventMsg();
+    }
+    if (events & static_cast<uint32_t>(EPOLLHUP)) {
+        LOGE("EPOLLHUP on uevent socket");
+        reactor_.Stop();
         return;
     }
-
-    NetlinkListener* me = reinterpret_cast<NetlinkListener *>(object);
-    me->RunListener();
+    if (events & static_cast<uint32_t>(EPOLLERR)) {
+        /*
+         * A receive queue overrun raises EPOLLERR with ENOBUFS, the socket
+         * itself is still fine. The error reads 0 when the receive above
+         * already took it.
+         */
+        int32_t err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(socketFd_, SOL_SOCKET, SO_ERROR, &err, &len) != 0) {
+            err = errno;
+        }
+        if (err == ENOBUFS) {
+            overflows_++;
+            LOGW("Uevent socket overflowed");
+            OnOverflow();
+        } else if (err != 0) {
+            LOGE("EPOLLERR on uevent socket, errno %{public}d", err);
+            reactor_.Stop();
+        }
+    }
 }
 
 int32_t NetlinkListener::StartListener()
@@ -178,40 +267,48 @@ int32_t NetlinkListener::StartListener()
         return E_ERR;
     }
 
-    if (pipe(socketPipe_) == -1) {
-        LOGE("Pipe error");
-        return E_ERR;
+    if (ring_ == nullptr) {
+        ring_ = std::make_unique<UeventRing>();
+        (void)GrowUeventRing(*ring_, UEVENT_MSG_LEN);
+        bufferSize_ = static_cast<uint32_t>(ring_->msgLen);
     }
-    socketThread_ = std::make_unique<std::thread>(&NetlinkListener::EventProcess, this);
-    if (socketThread_ == nullptr) {
-        close(socketPipe_[0]);
-        close(socketPipe_[1]);
-        socketPipe_[0] = socketPipe_[1] = -1;
+
+    if (reactor_.Init() != E_OK ||
+        reactor_.AddSource(socketFd_, EPOLLIN, [this](uint32_t events) { OnSocketEvent(events); }) != E_OK) {
+        LOGE("Register uevent socket failed");
         return E_ERR;
     }
-
+    socketThread_ = std::make_unique<std::thread>([this] { reactor_.Run(); });
     return E_OK;
 }
 
 int32_t NetlinkListener::StopListener()
 {
-    int32_t msg = 0;
-    write(socketPipe_[1], &msg, 1);
-
+    reactor_.Stop();
     if (socketThread_ != nullptr && socketThread_->joinable()) {
         socketThread_->join();
     }
+    socketThread_ = nullptr;
+    (void)reactor_.RemoveSource(socketFd_);
+    LOGI("Stop listener");
+    return E_OK;
+}
 
-    close(socketPipe_[0]);
-    close(socketPipe_[1]);
-    socketPipe_[0] = socketPipe_[1] = -1;
+void NetlinkListener::SetOriginCheck(bool enabled)
+{
+    originCheck_ = enabled;
+}
 
-    return E_OK;
+EventReactor &NetlinkListener::GetReactor()
+{
+    return reactor_;
 }
 
 NetlinkListener::NetlinkListener(int32_t socket)
 {
     socketFd_ = socket;
 }
+
+NetlinkListener::~NetlinkListener() = default;
 } // StorageDaemon
 } // OHOS
@@ -15,6 +15,7 @@
 #include "netlink/netlink_manager.h"
 
 #include <cerrno>
+#include <charconv>
 #include <iostream>
 
 #include <unistd.h>
@@ -22,6 +23,8 @@
 #include <sys/socket.h>
 #include <linux/netlink.h>
 
+#include "netlink/netlink_filter.h"
+#include "parameter.h"
 #include "storage_service_errno.h"
 #include "storage_service_log.h"
 #include "securec.h"
@@ -30,6 +33,37 @@ namespace OHOS {
 namespace StorageDaemon {
 NetlinkManager* NetlinkManager::instance_ = nullptr;
 
+const std::string UEVENT_FILTER_PARAM = "persist.storage_daemon.uevent_filter";
+const int32_t UEVENT_FILTER_VAL_LEN = 6;
+
+const std::string UEVENT_SETTLE_PARAM = "persist.storage_daemon.uevent_settle_ms";
+const int32_t UEVENT_SETTLE_DEFAULT_MS = 200;
+const int32_t UEVENT_SETTLE_MAX_MS = 5000;
+const int32_t UEVENT_SETTLE_VAL_LEN = 8;
+
+static std::chrono::milliseconds UeventSettleWindow()
+{
+    char value[UEVENT_SETTLE_VAL_LEN + 1] = {"200"};
+    int32_t settleMs = UEVENT_SETTLE_DEFAULT_MS;
+    if (GetParameter(UEVENT_SETTLE_PARAM.c_str(), "200", value, UEVENT_SETTLE_VAL_LEN) > 0) {
+        int32_t parsed = 0;
+        auto res = std::from_chars(value, value + strnlen(value, UEVENT_SETTLE_VAL_LEN), parsed);
+        if (res.ec == std::errc() && parsed >= 0 && parsed <= UEVENT_SETTLE_MAX_MS) {
+            settleMs = parsed;
+        }
+    }
+    LOGI("Uevent settle window %{public}d ms", settleMs);
+    return std::chrono::milliseconds(settleMs);
+}
+
+static bool UeventFilterEnabled()
+{
+    char value[UEVENT_FILTER_VAL_LEN + 1] = {"true"};
+    int ret = GetParameter(UEVENT_FILTER_PARAM.c_str(), "true", value, UEVENT_FILTER_VAL_LEN);
+    LOGI("GetParameter uevent filter %{public}s, ret %{public}d", value, ret);
+    return strncmp(value, "false", UEVENT_FILTER_VAL_LEN) != 0;
+}
+
 NetlinkManager* NetlinkManager::Instance()
 {
     if (instance_ == nullptr) {
@@ -68,13 +102,17 @@ int32_t NetlinkManager::Start()
         return E_ERR;
     }
 
+    if (UeventFilterEnabled() && AttachBlockUeventFilter(socketFd_) != E_OK) {
+        LOGW("Block uevent filter not attached, filtering in userspace only");
+    }
+
     if (bind(socketFd_, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
         LOGE("Socket bind failed, errno %{public}d", errno);
         close(socketFd_);
         return E_ERR;
     }
 
-    nlHandler_ = new NetlinkHandler(socketFd_);
+    nlHandler_ = new NetlinkHandler(socketFd_, UeventSettleWindow());
     if (nlHandler_->Start()) {
         close(socketFd_);
         return E_ERR;
@@ -96,5 +134,10 @@ int32_t NetlinkManager::Stop()
 
     return ret;
 }
+
+EventReactor *NetlinkManager::GetReactor()
+{
+    return (nlHandler_ == nullptr) ? nullptr : &nlHandler_->GetReactor();
+}
 } // StorageDaemon
 } // OHOS
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "netlink/uevent_coalescer.h"
+
+#include <sys/sysmacros.h>
+
+namespace OHOS {
+namespace StorageDaemon {
+UeventCoalescer::UeventCoalescer(std::chrono::milliseconds window) : window_(window) {}
+
+bool UeventCoalescer::Enabled() const
+{
+    return window_.count() > 0;
+}
+
+bool UeventCoalescer::Push(NetlinkData &data, const char *msg, size_t len, Clock::time_point now)
+{
+    if (!Enabled() || data.GetParam(NetlinkData::PARAM_DEVTYPE) != "disk" ||
+        data.GetMajor() < 0 || data.GetMinor() < 0) {
+        return false;
+    }
+
+    NetlinkData::Actions action = data.GetAction();
+    if (action != NetlinkData::Actions::ADD && action != NetlinkData::Actions::REMOVE &&
+        action != NetlinkData::Actions::CHANGE) {
+        return false;
+    }
+
+    dev_t device = makedev(static_cast<unsigned int>(data.GetMajor()), static_cast<unsigned int>(data.GetMinor()));
+    auto it = pending_.find(device);
+    if (it == pending_.end()) {
+        it = pending_.emplace(device, Entry()).first;
+        it->second.before = (action != NetlinkData::Actions::ADD);
+        it->second.after = it->second.before;
+    }
+
+    Entry &entry = it->second;
+    switch (action) {
+        case NetlinkData::Actions::ADD:
+            entry.after = true;
+            entry.add.assign(msg, len);
+            break;
+        case NetlinkData::Actions::REMOVE:
+            entry.after = false;
+            entry.removed = true;
+            entry.remove.assign(msg, len);
+            break;
+        default:
+            entry.change.assign(msg, len);
+            break;
+    }
+    entry.deadline = now + window_;
+    stats_.pushed++;
+    return true;
+}
+
+void UeventCoalescer::Emit(const std::string &msg, const Emitter &emit)
+{
+    if (msg.empty()) {
+        return;
+    }
+    NetlinkData data;
+    data.Decode(msg.data(), msg.size());
+    emit(&data);
+    stats_.emitted++;
+}
+
+void UeventCoalescer::EmitNetEffect(const Entry &entry, const Emitter &emit)
+{
+    if (!entry.before && entry.after) {
+        Emit(entry.add, emit);
+    } else if (entry.before && !entry.after) {
+        Emit(entry.remove, emit);
+    } else if (entry.before && entry.after) {
+        if (entry.removed) {
+            Emit(entry.remove, emit);
+            Emit(entry.add, emit);
+        } else {
+            Emit(entry.change, emit);
+        }
+    }
+}
+
+void UeventCoalescer::Flush(Clock::time_point now, const Emitter &emit, bool force)
+{
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        if (!force && it->second.deadline > now) {
+            it++;
+            continue;
+        }
+        Entry entry = std::move(it->second);
+        it = pending_.erase(it);
+        EmitNetEffect(entry, emit);
+    }
+}
+
+bool UeventCoalescer::NextDeadline(Clock::time_point &deadline) const
+{
+    if (pending_.empty()) {
+        return false;
+    }
+    deadline = Clock::time_point::max();
+    for (const auto &item : pending_) {
+        if (item.second.deadline < deadline) {
+            deadline = item.second.deadline;
+        }
+    }
+    return true;
+}
+
+void UeventCoalescer::Clear()
+{
+    pending_.clear();
+}
+
+size_t UeventCoalescer::Pending() const
+{
+    return pending_.size();
+}
+
+UeventCoalescerStats UeventCoalescer::GetStats() const
+{
+    return stats_;
+}
+} // StorageDaemon
+} // OHOS
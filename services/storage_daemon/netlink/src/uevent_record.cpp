@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "netlink/uevent_record.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "netlink/netlink_listener.h"
+#include "securec.h"
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+constexpr char UEVENT_RECORD_MAGIC[] = { 'U', 'E', 'V', 'R' };
+
+struct UeventRecordHeader {
+    char magic[sizeof(UEVENT_RECORD_MAGIC)];
+    uint32_t version;
+};
+
+struct UeventRecordEntry {
+    uint64_t timestampNs;
+    uint32_t len;
+} __attribute__((packed));
+
+static bool ReadFull(int32_t fd, void *buf, size_t len)
+{
+    auto p = static_cast<char *>(buf);
+    while (len > 0) {
+        ssize_t n = TEMP_FAILURE_RETRY(read(fd, p, len));
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+UeventRecordWriter::~UeventRecordWriter()
+{
+    Close();
+}
+
+int32_t UeventRecordWriter::Open(const std::string &path)
+{
+    Close();
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd_ < 0) {
+        LOGE("Open record file failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+
+    UeventRecordHeader header;
+    (void)memcpy_s(header.magic, sizeof(header.magic), UEVENT_RECORD_MAGIC, sizeof(UEVENT_RECORD_MAGIC));
+    header.version = UEVENT_RECORD_VERSION;
+    if (write(fd_, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+        LOGE("Write record header failed, errno %{public}d", errno);
+        Close();
+        return E_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UeventRecordWriter::Append(uint64_t timestampNs, const char *msg, size_t len)
+{
+    if (fd_ < 0 || len > UEVENT_MSG_MAX) {
+        return E_ERR;
+    }
+
+    UeventRecordEntry entry = { timestampNs, static_cast<uint32_t>(len) };
+    struct iovec iov[] = {
+        { &entry, sizeof(entry) },
+        { const_cast<char *>(msg), len },
+    };
+    ssize_t expect = static_cast<ssize_t>(sizeof(entry) + len);
+    if (TEMP_FAILURE_RETRY(writev(fd_, iov, sizeof(iov) / sizeof(iov[0]))) != expect) {
+        LOGE("Write uevent record failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+    return E_OK;
+}
+
+void UeventRecordWriter::Close()
+{
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+int32_t ReadUeventRecords(const std::string &path, std::vector<UeventRecord> &records)
+{
+    int32_t fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGE("Open record file failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+
+    UeventRecordHeader header;
+    if (!ReadFull(fd, &header, sizeof(header)) ||
+        memcmp(header.magic, UEVENT_RECORD_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != UEVENT_RECORD_VERSION) {
+        LOGE("Invalid uevent record file");
+        close(fd);
+        return E_ERR;
+    }
+
+    int32_t ret = E_OK;
+    UeventRecordEntry entry;
+    while (ReadFull(fd, &entry, sizeof(entry))) {
+        if (entry.len > UEVENT_MSG_MAX) {
+            ret = E_ERR;
+            break;
+        }
+        UeventRecord record = { entry.timestampNs, std::string(entry.len, '\0') };
+        if (!ReadFull(fd, record.msg.data(), entry.len)) {
+            ret = E_ERR;
+            break;
+        }
+        records.push_back(std::move(record));
+    }
+    close(fd);
+    if (ret != E_OK) {
+        LOGE("Truncated uevent record file, %{public}zu records read", records.size());
+    }
+    return ret;
+}
+} // StorageDaemon
+} // OHOS
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "netlink/uevent_replay.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+constexpr int32_t REPLAY_SOCKET_BUF = 4 * 1024 * 1024;
+constexpr int32_t REPLAY_DRAIN_TIMEOUT_MS = 10000;
+constexpr int32_t REPLAY_POLL_MS = 1;
+constexpr uint64_t NS_PER_US = 1000;
+constexpr int32_t PERCENT_50 = 50;
+constexpr int32_t PERCENT_90 = 90;
+constexpr int32_t PERCENT_99 = 99;
+constexpr int32_t PERCENT_ALL = 100;
+const std::string REPLAY_SEQ_KEY = "REPLAYSEQ";
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ReplayNetlinkHandler::ReplayNetlinkHandler(int32_t socket, size_t count, const UeventReplayOptions &options)
+    : NetlinkHandler(socket, options.settleWindow), useDiskManager_(options.useDiskManager),
+      sendNs_(std::make_unique<std::atomic<int64_t>[]>(count)), count_(count)
+{
+    SetOriginCheck(false);
+    latencies_.reserve(count);
+}
+
+void ReplayNetlinkHandler::MarkSent(size_t seq)
+{
+    if (seq < count_) {
+        sendNs_[seq].store(NowNs(), std::memory_order_release);
+    }
+}
+
+std::vector<uint64_t> ReplayNetlinkHandler::TakeLatencies()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return std::move(latencies_);
+}
+
+void ReplayNetlinkHandler::HandleEvent(NetlinkData *data)
+{
+    if (useDiskManager_) {
+        NetlinkHandler::HandleEvent(data);
+    }
+
+    std::string seqStr = data->GetParam(REPLAY_SEQ_KEY);
+    size_t seq = 0;
+    auto res = std::from_chars(seqStr.data(), seqStr.data() + seqStr.size(), seq);
+    if (res.ec != std::errc() || seq >= count_) {
+        return;
+    }
+    int64_t latencyNs = NowNs() - sendNs_[seq].load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(lock_);
+    latencies_.push_back(static_cast<uint64_t>(latencyNs) / NS_PER_US);
+}
+
+void ReplayNetlinkHandler::Resync()
+{
+    if (useDiskManager_) {
+        NetlinkHandler::Resync();
+    }
+}
+
+static uint64_t Percentile(const std::vector<uint64_t> &sorted, int32_t percent)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = (sorted.size() - 1) * static_cast<size_t>(percent) / PERCENT_ALL;
+    return sorted[index];
+}
+
+/* Waits until the listener has read every datagram and the worker has consumed them */
+static bool WaitDrained(ReplayNetlinkHandler &handler, uint64_t sent, std::chrono::steady_clock::time_point &drainedAt)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(REPLAY_DRAIN_TIMEOUT_MS);
+    while (std::chrono::steady_clock::now() < deadline) {
+        UeventStats stats = handler.GetStats();
+        UeventQueueStats queue = handler.GetQueueStats();
+        if (stats.messages >= sent && queue.processed >= queue.enqueued) {
+            drainedAt = std::chrono::steady_clock::now();
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(REPLAY_POLL_MS));
+    }
+    drainedAt = std::chrono::steady_clock::now();
+    return false;
+}
+
+static std::string TagReplaySeq(const std::string &msg, size_t seq)
+{
+    std::string tagged = msg.substr(0, NetlinkData::MessageLength(msg.data(), msg.size()));
+    std::string tag = REPLAY_SEQ_KEY + "=" + std::to_string(seq);
+    if (tagged.size() + tag.size() + 1 < static_cast<size_t>(UEVENT_MSG_MAX)) {
+        tagged += tag;
+        tagged.push_back('\0');
+    }
+    return tagged;
+}
+
+int32_t ReplayUevents(const std::vector<UeventRecord> &records, const UeventReplayOptions &options,
+    UeventReplayResult &result)
+{
+    int32_t sv[2] = { -1, -1 };
+    if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, sv) != 0) {
+        LOGE("socketpair failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+    int32_t sz = REPLAY_SOCKET_BUF;
+    (void)setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sz, sizeof(sz));
+    (void)setsockopt(sv[1], SOL_SOCKET, SO_RCVBUF, &sz, sizeof(sz));
+
+    std::vector<std::string> msgs;
+    msgs.reserve(records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        msgs.push_back(TagReplaySeq(records[i].msg, i));
+    }
+
+    ReplayNetlinkHandler handler(sv[1], records.size(), options);
+    if (handler.Start() != E_OK) {
+        close(sv[0]);
+        close(sv[1]);
+        return E_ERR;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t firstNs = records.empty() ? 0 : records.front().timestampNs;
+    for (size_t i = 0; i < msgs.size(); i++) {
+        if (options.speed > 0) {
+            auto offset = std::chrono::nanoseconds(
+                static_cast<int64_t>((records[i].timestampNs - firstNs) / options.speed));
+            std::this_thread::sleep_until(start + offset);
+        }
+        handler.MarkSent(i);
+        if (TEMP_FAILURE_RETRY(send(sv[0], msgs[i].data(), msgs[i].size(), 0)) < 0) {
+            LOGE("Replay send failed, errno %{public}d", errno);
+            break;
+        }
+        result.sent++;
+    }
+
+    std::chrono::steady_clock::time_point drainedAt;
+    bool drained = WaitDrained(handler, result.sent, drainedAt);
+    /* Coalesced events are only dispatched once their window has passed */
+    std::this_thread::sleep_for(options.settleWindow * 2);
+    handler.Stop();
+    close(sv[0]);
+    close(sv[1]);
+
+    std::vector<uint64_t> latencies = handler.TakeLatencies();
+    std::sort(latencies.begin(), latencies.end());
+    result.received = handler.GetStats().messages;
+    result.dispatched = handler.GetQueueStats().dispatched;
+    result.seconds = std::chrono::duration<double>(drainedAt - start).count();
+    result.eventsPerSec = (result.seconds > 0) ? static_cast<double>(result.received) / result.seconds : 0;
+    result.p50Us = Percentile(latencies, PERCENT_50);
+    result.p90Us = Percentile(latencies, PERCENT_90);
+    result.p99Us = Percentile(latencies, PERCENT_99);
+    result.maxUs = Percentile(latencies, PERCENT_ALL);
+    return drained ? E_OK : E_ERR;
+}
+} // StorageDaemon
+} // OHOS
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "netlink/netlink_data.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr int32_t BENCHMARK_LOOPS = 100000;
+const char DISK_EVENT[] = "add@/devices/platform/fe2b0000.dwmmc/mmc_host/mmc1/mmc1:aaaa/block/mmcblk1\0"
+    "ACTION=add\0DEVPATH=/devices/platform/fe2b0000.dwmmc/mmc_host/mmc1/mmc1:aaaa/block/mmcblk1\0"
+    "SUBSYSTEM=block\0MAJOR=179\0MINOR=8\0DEVNAME=mmcblk1\0DEVTYPE=disk\0SEQNUM=2345\0";
+
+std::string Duplicate(const char *msg)
+{
+    char *copy = strdup(msg);
+    std::string result(copy);
+    free(copy);
+    return result;
+}
+
+/* The decoder as it was before string_view slots, kept here as the benchmark baseline */
+class LegacyNetlinkData {
+public:
+    void Decode(const char *msg)
+    {
+        while (*msg) {
+            if (!strncmp(msg, "DEVPATH=", strlen("DEVPATH="))) {
+                msg += strlen("DEVPATH=");
+                devPath_ = Duplicate(msg);
+                sysPath_ = "/sys";
+                sysPath_ += devPath_;
+            } else if (!strncmp(msg, "SUBSYSTEM=", strlen("SUBSYSTEM="))) {
+                msg += strlen("SUBSYSTEM=");
+                subSystem_ = Duplicate(msg);
+            } else if (strncmp(msg, "ACTION=", strlen("ACTION="))) {
+                params_.push_back(Duplicate(msg));
+            }
+            while (*msg++);
+        }
+    }
+
+    const std::string GetParam(const std::string paramName)
+    {
+        size_t len = paramName.size();
+        for (auto iter = params_.begin(); iter != params_.end(); ++iter) {
+            const char *ptr = iter->c_str() + len;
+            if (strncmp(iter->c_str(), paramName.c_str(), len) == 0 && *ptr == '=') {
+                return ++ptr;
+            }
+        }
+        return "";
+    }
+
+    std::string subSystem_;
+
+private:
+    std::string sysPath_;
+    std::string devPath_;
+    std::vector<std::string> params_;
+};
+} // namespace
+
+using namespace testing::ext;
+
+class NetlinkDataBenchmarkTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: NetlinkDataBenchmarkTest_Decode_001
+ * @tc.desc: Compare the indexed decoder against the legacy strdup based decoder on a disk ADD event.
+ * @tc.type: PERF
+ */
+HWTEST_F(NetlinkDataBenchmarkTest, NetlinkDataBenchmarkTest_Decode_001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "NetlinkDataBenchmarkTest_Decode_001 start";
+
+    uint64_t legacySum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < BENCHMARK_LOOPS; i++) {
+        LegacyNetlinkData data;
+        data.Decode(DISK_EVENT);
+        if (data.subSystem_ == "block" && data.GetParam("DEVTYPE") == "disk") {
+            legacySum += static_cast<uint64_t>(std::stoi(data.GetParam("MAJOR")) + std::stoi(data.GetParam("MINOR")));
+        }
+    }
+    auto legacyCost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    uint64_t indexedSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < BENCHMARK_LOOPS; i++) {
+        NetlinkData data;
+        data.Decode(DISK_EVENT);
+        if (data.GetParam(NetlinkData::PARAM_SUBSYSTEM) == "block" &&
+            data.GetParam(NetlinkData::PARAM_DEVTYPE) == "disk") {
+            indexedSum += static_cast<uint64_t>(data.GetMajor() + data.GetMinor());
+        }
+    }
+    auto indexedCost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(legacySum, indexedSum);
+    GTEST_LOG_(INFO) << "legacy decode " << legacyCost / BENCHMARK_LOOPS << " ns/event, indexed decode "
+                     << indexedCost / BENCHMARK_LOOPS << " ns/event";
+
+    GTEST_LOG_(INFO) << "NetlinkDataBenchmarkTest_Decode_001 end";
+}
+} // STORAGE_DAEMON
+} // OHOS
@@ -12,6 +12,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include "netlink/netlink_data.h"
@@ -24,6 +26,9 @@ namespace {
     const char* DEVPATH_TEST = "DEVPATH=/dev/test\0ACTION=add\0";
     const char* SUBSYSTEM_TEST = "SUBSYSTEM=ABCABC\0ACTION=add\0";
     const char* PARAM_TEST = "ParamName=test\0ACTION=add\0";
+    const char* DISK_TEST = "add@/devices/platform/fe2b0000.dwmmc/block/mmcblk1\0ACTION=add\0"
+        "DEVPATH=/devices/platform/fe2b0000.dwmmc/block/mmcblk1\0SUBSYSTEM=block\0MAJOR=179\0MINOR=8\0"
+        "DEVNAME=mmcblk1\0DEVTYPE=disk\0SEQNUM=1064\0";
 }
 using namespace testing::ext;
 
@@ -153,5 +158,79 @@ HWTEST_F(NetlinkDataTest, NetlinkDataTest_GetParam_002, TestSize.Level1)
 
     GTEST_LOG_(INFO) << "NetlinkDataTest_GetParam_002 end";
 }
+
+/**
+ * @tc.name: NetlinkDataTest_GetParam_003
+ * @tc.desc: Verify the indexed GetParam function and the parsed MAJOR/MINOR.
+ * @tc.type: FUNC
+ */
+HWTEST_F(NetlinkDataTest, NetlinkDataTest_GetParam_003, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkDataTest_GetParam_003 start";
+
+    NetlinkData netlinkData;
+    netlinkData.Decode(DISK_TEST);
+    EXPECT_TRUE(netlinkData.GetAction() == NetlinkData::Actions::ADD);
+    EXPECT_TRUE(netlinkData.GetParam(NetlinkData::PARAM_SUBSYSTEM) == "block");
+    EXPECT_TRUE(netlinkData.GetParam(NetlinkData::PARAM_DEVTYPE) == "disk");
+    EXPECT_TRUE(netlinkData.GetParam(NetlinkData::PARAM_DEVNAME) == "mmcblk1");
+    EXPECT_TRUE(netlinkData.GetParam(NetlinkData::PARAM_PARTN).empty());
+    EXPECT_EQ(netlinkData.GetMajor(), 179);
+    EXPECT_EQ(netlinkData.GetMinor(), 8);
+    EXPECT_TRUE(netlinkData.GetParam("SEQNUM").compare("1064") == 0);
+
+    netlinkData.Decode(PARAM_TEST);
+    EXPECT_EQ(netlinkData.GetMajor(), -1) << "state is reset between Decode calls";
+    EXPECT_TRUE(netlinkData.GetParam(NetlinkData::PARAM_DEVTYPE).empty());
+
+    GTEST_LOG_(INFO) << "NetlinkDataTest_GetParam_003 end";
+}
+
+/**
+ * @tc.name: NetlinkDataTest_Decode_005
+ * @tc.desc: Verify the length bounded Decode function.
+ * @tc.type: FUNC
+ */
+HWTEST_F(NetlinkDataTest, NetlinkDataTest_Decode_005, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkDataTest_Decode_005 start";
+
+    const char msg[] = { 'M', 'A', 'J', 'O', 'R', '=', '8', '\0', 'M', 'I', 'N', 'O', 'R', '=', '1', '6' };
+    NetlinkData netlinkData;
+    netlinkData.Decode(msg, sizeof(msg));
+    EXPECT_EQ(netlinkData.GetMajor(), 8);
+    EXPECT_EQ(netlinkData.GetMinor(), 16);
+
+    GTEST_LOG_(INFO) << "NetlinkDataTest_Decode_005 end";
+}
+
+/**
+ * @tc.name: NetlinkDataTest_GetParam_004
+ * @tc.desc: Verify GetParam finds parameters of a uevent with a long environment.
+ * @tc.type: FUNC
+ */
+HWTEST_F(NetlinkDataTest, NetlinkDataTest_GetParam_004, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkDataTest_GetParam_004 start";
+
+    constexpr int32_t paramCount = 300;
+    std::string msg("ACTION=add");
+    msg.push_back('\0');
+    for (int32_t i = 0; i < paramCount; i++) {
+        msg += "DEVLINK" + std::to_string(i) + "=/dev/block/by-id/link" + std::to_string(i);
+        msg.push_back('\0');
+    }
+    msg += "ID_FS_TYPE=exfat";
+    msg.push_back('\0');
+
+    NetlinkData netlinkData;
+    netlinkData.Decode(msg.data(), msg.size());
+    EXPECT_TRUE(netlinkData.GetAction() == NetlinkData::Actions::ADD);
+    EXPECT_EQ(netlinkData.GetParam("DEVLINK299"), "/dev/block/by-id/link299");
+    EXPECT_EQ(netlinkData.GetParam("ID_FS_TYPE"), "exfat");
+    EXPECT_EQ(netlinkData.GetParam("DEVLINK"), "");
+
+    GTEST_LOG_(INFO) << "NetlinkDataTest_GetParam_004 end";
+}
 } // STORAGE_DAEMON
 } // OHOS
\ No newline at end of file
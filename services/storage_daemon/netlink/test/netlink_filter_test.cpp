@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include <sys/socket.h>
+
+#include <gtest/gtest.h>
+
+#include "netlink/netlink_filter.h"
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr int32_t UEVENT_BUF_LEN = 1024;
+
+struct RecordedUevent {
+    std::string msg;
+    bool isBlock;
+};
+
+RecordedUevent MakeUevent(const std::string &action, const std::string &devPath, const std::string &subsystem,
+    const std::vector<std::string> &extras)
+{
+    std::string msg = action + "@" + devPath;
+    msg.push_back('\0');
+    msg += "ACTION=" + action;
+    msg.push_back('\0');
+    msg += "DEVPATH=" + devPath;
+    msg.push_back('\0');
+    msg += "SUBSYSTEM=" + subsystem;
+    msg.push_back('\0');
+    for (auto &extra : extras) {
+        msg += extra;
+        msg.push_back('\0');
+    }
+    return { msg, subsystem == "block" };
+}
+
+/* A boot-time uevent mix as seen on a development board */
+std::vector<RecordedUevent> RecordedUevents()
+{
+    return {
+        MakeUevent("change", "/devices/platform/battery/power_supply/battery", "power_supply",
+            { "POWER_SUPPLY_CAPACITY=87" }),
+        MakeUevent("add", "/devices/virtual/net/wlan0", "net", { "INTERFACE=wlan0" }),
+        MakeUevent("add", "/devices/platform/fe2b0000.dwmmc/mmc_host/mmc1/mmc1:aaaa/block/mmcblk1", "block",
+            { "MAJOR=179", "MINOR=8", "DEVNAME=mmcblk1", "DEVTYPE=disk" }),
+        MakeUevent("add", "/devices/platform/fe2b0000.dwmmc/mmc_host/mmc1/mmc1:aaaa/block/mmcblk1/mmcblk1p1", "block",
+            { "MAJOR=179", "MINOR=9", "DEVNAME=mmcblk1p1", "DEVTYPE=partition", "PARTN=1" }),
+        MakeUevent("change", "/devices/virtual/thermal/thermal_zone0", "thermal", { "TEMP=45000" }),
+        MakeUevent("add", "/devices/platform/ff5d0000.i2c/i2c-0/0-0010/input/input2", "input", { "PRODUCT=18/0/0/0" }),
+        MakeUevent("add", "/devices/platform/usbhost/fd000000.dwc3/xhci-hcd.0.auto/usb3/3-1", "usb",
+            { "DEVTYPE=usb_device" }),
+        MakeUevent("add", "/devices/virtual/block/loop0", "block",
+            { "MAJOR=7", "MINOR=0", "DEVNAME=loop0", "DEVTYPE=disk" }),
+        MakeUevent("remove", "/devices/virtual/misc/blocker", "misc", { "MINOR=60" }),
+        MakeUevent("add", "/devices/virtual/bdi/7:0", "bdi", {}),
+    };
+}
+} // namespace
+
+using namespace testing::ext;
+
+class NetlinkFilterTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: NetlinkFilterTest_BuildBlockUeventFilter_001
+ * @tc.desc: Verify the filter program fits the classic BPF instruction limit.
+ * @tc.type: FUNC
+ */
+HWTEST_F(NetlinkFilterTest, NetlinkFilterTest_BuildBlockUeventFilter_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkFilterTest_BuildBlockUeventFilter_001 start";
+
+    auto prog = BuildBlockUeventFilter();
+    EXPECT_FALSE(prog.empty());
+    EXPECT_LE(prog.size(), static_cast<size_t>(BPF_MAXINSNS));
+
+    GTEST_LOG_(INFO) << "NetlinkFilterTest_BuildBlockUeventFilter_001 end";
+}
+
+/**
+ * @tc.name: NetlinkFilterTest_Replay_001
+ * @tc.desc: Replay recorded uevents through a filtered socket and count the wakeups avoided.
+ * @tc.type: FUNC
+ */
+HWTEST_F(NetlinkFilterTest, NetlinkFilterTest_Replay_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkFilterTest_Replay_001 start";
+
+    int32_t fds[2] = { -1, -1 };
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds), 0);
+    ASSERT_EQ(AttachBlockUeventFilter(fds[1]), E_OK);
+
+    auto uevents = RecordedUevents();
+    int32_t blockCount = 0;
+    for (auto &uevent : uevents) {
+        ASSERT_EQ(send(fds[0], uevent.msg.data(), uevent.msg.size(), 0), static_cast<ssize_t>(uevent.msg.size()));
+        blockCount += uevent.isBlock ? 1 : 0;
+    }
+
+    char buf[UEVENT_BUF_LEN];
+    int32_t received = 0;
+    while (true) {
+        ssize_t n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+        if (n <= 0) {
+            break;
+        }
+        received++;
+        EXPECT_NE(memmem(buf, n, "SUBSYSTEM=block", strlen("SUBSYSTEM=block")), nullptr);
+    }
+
+    EXPECT_EQ(received, blockCount);
+    GTEST_LOG_(INFO) << "replayed " << uevents.size() << " uevents, delivered " << received
+                     << ", wakeups avoided " << uevents.size() - received;
+
+    (void)close(fds[0]);
+    (void)close(fds[1]);
+    GTEST_LOG_(INFO) << "NetlinkFilterTest_Replay_001 end";
+}
+
+/**
+ * @tc.name: NetlinkFilterTest_Replay_002
+ * @tc.desc: Verify uevents with a header longer than the filter window are left to userspace.
+ * @tc.type: FUNC
+ */
+HWTEST_F(NetlinkFilterTest, NetlinkFilterTest_Replay_002, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkFilterTest_Replay_002 start";
+
+    int32_t fds[2] = { -1, -1 };
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds), 0);
+    ASSERT_EQ(AttachBlockUeventFilter(fds[1]), E_OK);
+
+    std::string devPath = "/devices/" + std::string(UEVENT_FILTER_HEADER_MAX, 'a');
+    auto uevent = MakeUevent("add", devPath, "net", {});
+    ASSERT_EQ(send(fds[0], uevent.msg.data(), uevent.msg.size(), 0), static_cast<ssize_t>(uevent.msg.size()));
+
+    char buf[UEVENT_BUF_LEN * 2];
+    EXPECT_GT(recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT), 0);
+
+    (void)close(fds[0]);
+    (void)close(fds[1]);
+    GTEST_LOG_(INFO) << "NetlinkFilterTest_Replay_002 end";
+}
+} // STORAGE_DAEMON
+} // OHOS
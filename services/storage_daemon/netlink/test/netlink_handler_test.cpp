@@ -13,7 +13,10 @@
  * limitations under the License.
  */
 #include <fcntl.h>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unistd.h>
 
 #include <sys/socket.h>
@@ -29,6 +32,74 @@ namespace OHOS {
 namespace StorageDaemon {
 using namespace testing::ext;
 int32_t StartSocket(int32_t& socketFd);
+
+class BlockingNetlinkHandler : public NetlinkHandler {
+public:
+    explicit BlockingNetlinkHandler(int32_t socket, std::chrono::milliseconds window = {})
+        : NetlinkHandler(socket, window) {}
+    void Inject(const std::string &msg)
+    {
+        std::string buf = msg;
+        OnEvent(buf.data(), buf.size());
+    }
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock(gateLock_);
+        released_ = true;
+        gate_.notify_all();
+    }
+    void Overflow()
+    {
+        OnOverflow();
+    }
+    uint32_t Handled() const
+    {
+        return handled_.load();
+    }
+    uint32_t Resynced() const
+    {
+        return resynced_.load();
+    }
+
+protected:
+    void HandleEvent(NetlinkData *data) override
+    {
+        std::unique_lock<std::mutex> lock(gateLock_);
+        gate_.wait(lock, [this] { return released_; });
+        handled_++;
+    }
+    void Resync() override
+    {
+        resynced_++;
+    }
+
+private:
+    std::mutex gateLock_;
+    std::condition_variable gate_;
+    bool released_ { false };
+    std::atomic<uint32_t> handled_ { 0 };
+    std::atomic<uint32_t> resynced_ { 0 };
+};
+
+static void WaitFor(const std::function<bool()> &cond)
+{
+    for (int32_t i = 0; i < 100 && !cond(); i++) {
+        usleep(10000);
+    }
+}
+
+static std::string MakeUevent(const std::string &subsystem, int32_t minor, const std::string &action = "add")
+{
+    std::string msg = action + "@/devices/virtual/block/loop" + std::to_string(minor);
+    msg.push_back('\0');
+    for (const std::string &entry : { "ACTION=" + action, "SUBSYSTEM=" + subsystem,
+        std::string("MAJOR=7"), "MINOR=" + std::to_string(minor), std::string("DEVTYPE=disk") }) {
+        msg += entry;
+        msg.push_back('\0');
+    }
+    return msg;
+}
+
 class NetlinkHandlerTest : public testing::Test {
 public:
     static void SetUpTestCase(void) {};
@@ -88,6 +159,126 @@ HWTEST_F(NetlinkHandlerTest, NetlinkHandlerTest_Start_Stop_001, TestSize.Level1)
     GTEST_LOG_(INFO) << "NetlinkHandlerTest_Start_Stop_001 end";
 }
 
+/**
+ * @tc.name: NetlinkHandlerTest_Queue_001
+ * @tc.desc: Verify uevents are queued off the receive thread while the worker is busy, and drained afterwards.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(NetlinkHandlerTest, NetlinkHandlerTest_Queue_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkHandlerTest_Queue_001 start";
+
+    const int32_t count = 8;
+    BlockingNetlinkHandler handler(-1);
+    EXPECT_TRUE(handler.Start() == E_ERR);
+    for (int32_t i = 0; i < count; i++) {
+        handler.Inject(MakeUevent("block", i));
+        handler.Inject(MakeUevent("net", i));
+    }
+
+    UeventQueueStats stats = handler.GetQueueStats();
+    EXPECT_EQ(stats.enqueued, static_cast<uint64_t>(count));
+    EXPECT_GE(stats.maxDepth, static_cast<uint32_t>(count - 1));
+    EXPECT_EQ(stats.dropped, 0u);
+
+    handler.Release();
+    WaitFor([&handler, count] { return handler.Handled() >= static_cast<uint32_t>(count); });
+    EXPECT_EQ(handler.Handled(), static_cast<uint32_t>(count));
+    EXPECT_EQ(handler.Resynced(), 0u);
+    handler.Stop();
+
+    stats = handler.GetQueueStats();
+    EXPECT_EQ(stats.processed, static_cast<uint64_t>(count));
+    EXPECT_EQ(stats.depth, 0u);
+    EXPECT_GT(stats.maxLatencyUs, 0u);
+    GTEST_LOG_(INFO) << "NetlinkHandlerTest_Queue_001 end";
+}
+
+/**
+ * @tc.name: NetlinkHandlerTest_Queue_002
+ * @tc.desc: Verify a full queue drops and counts block events instead of blocking, ignores others, then resyncs.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(NetlinkHandlerTest, NetlinkHandlerTest_Queue_002, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkHandlerTest_Queue_002 start";
+
+    const int32_t extra = 5;
+    BlockingNetlinkHandler handler(-1);
+    EXPECT_TRUE(handler.Start() == E_ERR);
+    for (int32_t i = 0; i < static_cast<int32_t>(UEVENT_QUEUE_SIZE) + extra; i++) {
+        handler.Inject(MakeUevent("block", i));
+    }
+
+    UeventQueueStats stats = handler.GetQueueStats();
+    EXPECT_GE(stats.dropped, static_cast<uint64_t>(extra - 1));
+    EXPECT_EQ(stats.enqueued + stats.dropped, UEVENT_QUEUE_SIZE + extra);
+    for (int32_t i = 0; i < extra; i++) {
+        handler.Inject(MakeUevent("net", i));
+    }
+    EXPECT_EQ(handler.GetQueueStats().dropped, stats.dropped);
+    EXPECT_EQ(handler.GetQueueStats().depth, UEVENT_QUEUE_SIZE);
+
+    handler.Release();
+    WaitFor([&handler] { return handler.Resynced() > 0; });
+    EXPECT_EQ(handler.Resynced(), 1u);
+    EXPECT_EQ(handler.Handled(), static_cast<uint32_t>(stats.enqueued));
+    handler.Stop();
+    GTEST_LOG_(INFO) << "NetlinkHandlerTest_Queue_002 end";
+}
+
+/**
+ * @tc.name: NetlinkHandlerTest_Overflow_001
+ * @tc.desc: Verify a socket overflow schedules a single resync on the worker.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(NetlinkHandlerTest, NetlinkHandlerTest_Overflow_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkHandlerTest_Overflow_001 start";
+
+    BlockingNetlinkHandler handler(-1);
+    handler.Release();
+    EXPECT_TRUE(handler.Start() == E_ERR);
+    handler.Overflow();
+    WaitFor([&handler] { return handler.GetQueueStats().resyncs > 0; });
+    EXPECT_EQ(handler.Resynced(), 1u);
+    EXPECT_EQ(handler.GetQueueStats().resyncs, 1u);
+    handler.Stop();
+    GTEST_LOG_(INFO) << "NetlinkHandlerTest_Overflow_001 end";
+}
+
+/**
+ * @tc.name: NetlinkHandlerTest_Settle_001
+ * @tc.desc: Verify a flapping disk is dispatched once after the settle window.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(NetlinkHandlerTest, NetlinkHandlerTest_Settle_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkHandlerTest_Settle_001 start";
+
+    const int32_t settleMs = 50;
+    BlockingNetlinkHandler handler(-1, std::chrono::milliseconds(settleMs));
+    handler.Release();
+    EXPECT_TRUE(handler.Start() == E_ERR);
+    handler.Inject(MakeUevent("block", 0, "add"));
+    handler.Inject(MakeUevent("block", 0, "remove"));
+    handler.Inject(MakeUevent("block", 0, "add"));
+    handler.Inject(MakeUevent("block", 0, "change"));
+
+    WaitFor([&handler] { return handler.GetQueueStats().coalesced == 4; });
+    EXPECT_EQ(handler.Handled(), 0u);
+    WaitFor([&handler] { return handler.Handled() > 0; });
+    usleep(settleMs * 1000);
+    EXPECT_EQ(handler.Handled(), 1u);
+    EXPECT_EQ(handler.GetQueueStats().dispatched, 1u);
+    handler.Stop();
+    GTEST_LOG_(INFO) << "NetlinkHandlerTest_Settle_001 end";
+}
+
 int32_t StartSocket(int32_t& socketFd)
 {
     struct sockaddr_nl addr;
@@ -25,7 +25,7 @@ public:
     explicit NetlinkListenerMock(int32_t socket) : NetlinkListener(socket) {}
     virtual ~NetlinkListenerMock() {}
 
-    MOCK_METHOD1(OnEvent, void(char *));
+    MOCK_METHOD2(OnEvent, void(char *, size_t));
 };
 } // namespace StorageDaemon
 } // namespace OHOS
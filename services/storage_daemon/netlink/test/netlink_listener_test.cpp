@@ -14,7 +14,10 @@
  */
 #include <fcntl.h>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unistd.h>
+#include <vector>
 
 #include <sys/socket.h>
 #include <linux/netlink.h>
@@ -29,6 +32,47 @@ namespace OHOS {
 namespace StorageDaemon {
 using namespace testing::ext;
 int32_t StartSocket(int32_t& socketFd);
+
+class RecordingNetlinkListener : public NetlinkListener {
+public:
+    explicit RecordingNetlinkListener(int32_t socket) : NetlinkListener(socket) {}
+    std::vector<std::string> Received()
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        return received_;
+    }
+
+protected:
+    void OnEvent(char *msg, size_t len) override
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        received_.emplace_back(msg, len);
+    }
+
+private:
+    std::mutex lock_;
+    std::vector<std::string> received_;
+};
+
+static std::string MakeLargeUevent(size_t len)
+{
+    std::string msg("ACTION=change");
+    msg.push_back('\0');
+    while (msg.size() + 1 < len) {
+        msg.push_back('A' + msg.size() % 26);
+    }
+    msg.push_back('\0');
+    return msg;
+}
+
+static bool WaitMessages(NetlinkListener &listener, uint64_t count)
+{
+    for (int32_t i = 0; i < 200 && listener.GetStats().messages < count; i++) {
+        usleep(10000);
+    }
+    return listener.GetStats().messages >= count;
+}
+
 class NetlinkListenerTest : public testing::Test {
 public:
     static void SetUpTestCase(void) {};
@@ -86,6 +130,134 @@ HWTEST_F(NetlinkListenerTest, NetlinkListenerTest_StartListener_StopListener_001
     GTEST_LOG_(INFO) << "NetlinkListenerTest_StartListener_StopListener_001 end";
 }
 
+/**
+ * @tc.name: NetlinkListenerTest_GetStats_001
+ * @tc.desc: Verify the GetStats function before and after listening.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(NetlinkListenerTest, NetlinkListenerTest_GetStats_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkListenerTest_GetStats_001 start";
+    int32_t socket = 0;
+    int32_t ret = StartSocket(socket);
+    ASSERT_TRUE(ret == 0 && socket >= 0);
+
+    std::shared_ptr<NetlinkListenerMock> mock = std::make_shared<NetlinkListenerMock>(socket);
+    UeventStats stats = mock->GetStats();
+    EXPECT_EQ(stats.wakeups, 0);
+    EXPECT_EQ(stats.messages, 0);
+    EXPECT_EQ(stats.dropped, 0);
+
+    ret = mock->StartListener();
+    EXPECT_TRUE(ret == E_OK);
+    sleep(1);
+    ret = mock->StopListener();
+    EXPECT_TRUE(ret == E_OK);
+
+    stats = mock->GetStats();
+    EXPECT_TRUE(stats.messages >= stats.dropped);
+    EXPECT_TRUE(stats.maxBatch <= stats.messages);
+
+    (void)close(socket);
+    GTEST_LOG_(INFO) << "NetlinkListenerTest_GetStats_001 end";
+}
+
+/**
+ * @tc.name: NetlinkListenerTest_LargeUevent_001
+ * @tc.desc: Verify uevents larger than the initial buffer are received whole once the buffers have grown.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(NetlinkListenerTest, NetlinkListenerTest_LargeUevent_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkListenerTest_LargeUevent_001 start";
+    int32_t fds[2] = { -1, -1 };
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds), 0);
+    RecordingNetlinkListener listener(fds[1]);
+    listener.SetOriginCheck(false);
+
+    /* The head of the first batch is small, so the large one behind it is cut and lost */
+    std::string small = MakeLargeUevent(100);
+    std::string large = MakeLargeUevent(6000);
+    ASSERT_EQ(send(fds[0], small.data(), small.size(), 0), static_cast<ssize_t>(small.size()));
+    ASSERT_EQ(send(fds[0], large.data(), large.size(), 0), static_cast<ssize_t>(large.size()));
+    ASSERT_EQ(listener.StartListener(), E_OK);
+    ASSERT_TRUE(WaitMessages(listener, 2));
+    UeventStats stats = listener.GetStats();
+    EXPECT_EQ(stats.truncated, 1);
+    EXPECT_GE(stats.bufferSize, large.size());
+
+    /* Peeking a large head grows the buffers before it is read */
+    std::string larger = MakeLargeUevent(20000);
+    ASSERT_EQ(send(fds[0], larger.data(), larger.size(), 0), static_cast<ssize_t>(larger.size()));
+    ASSERT_TRUE(WaitMessages(listener, 3));
+    ASSERT_EQ(send(fds[0], large.data(), large.size(), 0), static_cast<ssize_t>(large.size()));
+    ASSERT_TRUE(WaitMessages(listener, 4));
+    EXPECT_EQ(listener.StopListener(), E_OK);
+
+    auto received = listener.Received();
+    ASSERT_EQ(received.size(), 3);
+    EXPECT_EQ(received[0], small);
+    EXPECT_EQ(received[1], larger);
+    EXPECT_EQ(received[2], large);
+    stats = listener.GetStats();
+    EXPECT_EQ(stats.truncated, 1);
+    EXPECT_GE(stats.bufferSize, larger.size());
+
+    (void)close(fds[0]);
+    (void)close(fds[1]);
+    GTEST_LOG_(INFO) << "NetlinkListenerTest_LargeUevent_001 end";
+}
+
+/**
+ * @tc.name: NetlinkListenerTest_Overflow_001
+ * @tc.desc: Verify the listener survives an overrun of a real netlink socket and keeps delivering.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(NetlinkListenerTest, NetlinkListenerTest_Overflow_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "NetlinkListenerTest_Overflow_001 start";
+    int32_t rx = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_USERSOCK);
+    int32_t tx = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_USERSOCK);
+    ASSERT_TRUE(rx >= 0 && tx >= 0);
+    struct sockaddr_nl addr;
+    (void)memset_s(&addr, sizeof(addr), 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = 1;
+    ASSERT_EQ(bind(rx, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)), 0);
+    int32_t size = 4096;
+    ASSERT_EQ(setsockopt(rx, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)), 0);
+
+    /*
+     * Broadcasts past the small receive buffer are lost and the kernel sets
+     * ENOBUFS on the socket. sendto itself fails as no kernel socket takes the
+     * unicast copy, the broadcast has gone out by then.
+     */
+    std::string msg = MakeLargeUevent(200);
+    for (int32_t i = 0; i < 100; i++) {
+        (void)sendto(tx, msg.data(), msg.size(), 0, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr));
+    }
+    RecordingNetlinkListener listener(rx);
+    listener.SetOriginCheck(false);
+    ASSERT_EQ(listener.StartListener(), E_OK);
+    ASSERT_TRUE(WaitMessages(listener, 1));
+    EXPECT_GE(listener.GetStats().overflows, 1);
+
+    uint64_t before = listener.GetStats().messages;
+    for (uint64_t i = 1; i <= 5; i++) {
+        (void)sendto(tx, msg.data(), msg.size(), 0, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr));
+        EXPECT_TRUE(WaitMessages(listener, before + i));
+    }
+    EXPECT_EQ(listener.StopListener(), E_OK);
+    EXPECT_EQ(listener.Received().back(), msg);
+
+    (void)close(tx);
+    (void)close(rx);
+    GTEST_LOG_(INFO) << "NetlinkListenerTest_Overflow_001 end";
+}
+
 int32_t StartSocket(int32_t& socketFd)
 {
     struct sockaddr_nl addr;
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "netlink/uevent_coalescer.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+using Clock = UeventCoalescer::Clock;
+using Ms = std::chrono::milliseconds;
+
+constexpr Ms SETTLE_WINDOW = Ms(200);
+
+struct TimedUevent {
+    Ms at;
+    std::string msg;
+};
+
+std::string MakeDiskUevent(const std::string &action, int32_t minor, const std::string &devType = "disk")
+{
+    std::string name = "sd" + std::string(1, static_cast<char>('a' + minor / 16));
+    std::string devPath = "/devices/platform/usbhost/xhci-hcd.0.auto/usb3/3-1/3-1:1.0/host0/block/" + name;
+    std::string msg = action + "@" + devPath;
+    msg.push_back('\0');
+    for (const std::string &entry : { "ACTION=" + action, "DEVPATH=" + devPath, std::string("SUBSYSTEM=block"),
+        std::string("MAJOR=8"), "MINOR=" + std::to_string(minor), "DEVNAME=" + name, "DEVTYPE=" + devType }) {
+        msg += entry;
+        msg.push_back('\0');
+    }
+    return msg;
+}
+
+struct Dispatched {
+    NetlinkData::Actions action;
+    int32_t minor;
+};
+
+class Replayer {
+public:
+    explicit Replayer(Ms window) : coalescer(window) {}
+
+    void Push(Clock::time_point now, const std::string &msg)
+    {
+        NetlinkData data;
+        data.Decode(msg.data(), msg.size());
+        if (!coalescer.Push(data, msg.data(), msg.size(), now)) {
+            Record(&data);
+        }
+    }
+
+    void Flush(Clock::time_point now, bool force = false)
+    {
+        coalescer.Flush(now, [this](NetlinkData *data) { Record(data); }, force);
+    }
+
+    /* Replays a timed trace, flushing whenever a settle deadline passes between two events */
+    void Replay(const std::vector<TimedUevent> &trace)
+    {
+        Clock::time_point base = Clock::now();
+        for (const auto &event : trace) {
+            Clock::time_point now = base + event.at;
+            Flush(now);
+            Push(now, event.msg);
+        }
+        Flush(base, true);
+    }
+
+    std::vector<Dispatched> out;
+    UeventCoalescer coalescer;
+
+private:
+    void Record(NetlinkData *data)
+    {
+        out.push_back({ data->GetAction(), data->GetMinor() });
+    }
+};
+
+/* Card reader with a worn contact: the same disk bounces several times within a second */
+std::vector<TimedUevent> FlappingStorm(int32_t minor, Ms start, int32_t bounces)
+{
+    std::vector<TimedUevent> trace;
+    Ms at = start;
+    for (int32_t i = 0; i < bounces; i++) {
+        trace.push_back({ at, MakeDiskUevent("add", minor) });
+        trace.push_back({ at + Ms(5), MakeDiskUevent("add", minor + 1, "partition") });
+        trace.push_back({ at + Ms(30), MakeDiskUevent("change", minor) });
+        trace.push_back({ at + Ms(60), MakeDiskUevent("remove", minor + 1, "partition") });
+        trace.push_back({ at + Ms(65), MakeDiskUevent("remove", minor) });
+        at += Ms(90);
+    }
+    trace.push_back({ at, MakeDiskUevent("add", minor) });
+    trace.push_back({ at + Ms(5), MakeDiskUevent("add", minor + 1, "partition") });
+    trace.push_back({ at + Ms(40), MakeDiskUevent("change", minor) });
+    return trace;
+}
+} // namespace
+
+using namespace testing::ext;
+
+class UeventCoalescerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: UeventCoalescerTest_NetEffect_001
+ * @tc.desc: Verify add->remove->add->change on an absent disk collapses into one add.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(UeventCoalescerTest, UeventCoalescerTest_NetEffect_001, TestSize.Level1)
+{
+    Replayer replayer(SETTLE_WINDOW);
+    replayer.Replay({
+        { Ms(0), MakeDiskUevent("add", 0) },
+        { Ms(10), MakeDiskUevent("remove", 0) },
+        { Ms(20), MakeDiskUevent("add", 0) },
+        { Ms(30), MakeDiskUevent("change", 0) },
+    });
+    ASSERT_EQ(replayer.out.size(), 1u);
+    EXPECT_EQ(replayer.out[0].action, NetlinkData::Actions::ADD);
+}
+
+/**
+ * @tc.name: UeventCoalescerTest_NetEffect_002
+ * @tc.desc: Verify the net effect table for a disk that was present or absent before the burst.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(UeventCoalescerTest, UeventCoalescerTest_NetEffect_002, TestSize.Level1)
+{
+    Replayer vanished(SETTLE_WINDOW);
+    vanished.Replay({ { Ms(0), MakeDiskUevent("add", 0) }, { Ms(10), MakeDiskUevent("remove", 0) } });
+    EXPECT_TRUE(vanished.out.empty());
+
+    Replayer unplugged(SETTLE_WINDOW);
+    unplugged.Replay({ { Ms(0), MakeDiskUevent("change", 0) }, { Ms(10), MakeDiskUevent("remove", 0) } });
+    ASSERT_EQ(unplugged.out.size(), 1u);
+    EXPECT_EQ(unplugged.out[0].action, NetlinkData::Actions::REMOVE);
+
+    Replayer replugged(SETTLE_WINDOW);
+    replugged.Replay({ { Ms(0), MakeDiskUevent("remove", 0) }, { Ms(10), MakeDiskUevent("add", 0) },
+        { Ms(20), MakeDiskUevent("change", 0) } });
+    ASSERT_EQ(replugged.out.size(), 2u);
+    EXPECT_EQ(replugged.out[0].action, NetlinkData::Actions::REMOVE);
+    EXPECT_EQ(replugged.out[1].action, NetlinkData::Actions::ADD);
+
+    Replayer changed(SETTLE_WINDOW);
+    changed.Replay({ { Ms(0), MakeDiskUevent("change", 0) }, { Ms(10), MakeDiskUevent("change", 0) },
+        { Ms(20), MakeDiskUevent("change", 0) } });
+    ASSERT_EQ(changed.out.size(), 1u);
+    EXPECT_EQ(changed.out[0].action, NetlinkData::Actions::CHANGE);
+}
+
+/**
+ * @tc.name: UeventCoalescerTest_Window_001
+ * @tc.desc: Verify events are held until the device is quiet for the window, and a zero window disables it.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(UeventCoalescerTest, UeventCoalescerTest_Window_001, TestSize.Level1)
+{
+    Replayer replayer(SETTLE_WINDOW);
+    Clock::time_point base = Clock::now();
+    replayer.Push(base, MakeDiskUevent("add", 0));
+    replayer.Push(base + Ms(150), MakeDiskUevent("change", 0));
+    replayer.Push(base, MakeDiskUevent("add", 1, "partition"));
+    EXPECT_EQ(replayer.out.size(), 1u);
+
+    Clock::time_point deadline;
+    ASSERT_TRUE(replayer.coalescer.NextDeadline(deadline));
+    EXPECT_TRUE(deadline == base + Ms(350));
+    replayer.Flush(base + Ms(300));
+    EXPECT_EQ(replayer.out.size(), 1u);
+    replayer.Flush(base + Ms(350));
+    ASSERT_EQ(replayer.out.size(), 2u);
+    EXPECT_EQ(replayer.out[1].action, NetlinkData::Actions::ADD);
+    EXPECT_EQ(replayer.coalescer.Pending(), 0u);
+
+    Replayer disabled(Ms(0));
+    disabled.Replay({ { Ms(0), MakeDiskUevent("add", 0) }, { Ms(10), MakeDiskUevent("remove", 0) } });
+    EXPECT_EQ(disabled.out.size(), 2u);
+}
+
+/**
+ * @tc.name: UeventCoalescerTest_Benchmark_001
+ * @tc.desc: Replay flapping connector storms on several readers and compare dispatches with and without coalescing.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(UeventCoalescerTest, UeventCoalescerTest_Benchmark_001, TestSize.Level1)
+{
+    const int32_t readers = 4;
+    const int32_t bounces = 8;
+    const int32_t minorStep = 16;
+    std::vector<TimedUevent> trace;
+    for (int32_t i = 0; i < readers; i++) {
+        auto storm = FlappingStorm(i * minorStep, Ms(i * 37), bounces);
+        trace.insert(trace.end(), storm.begin(), storm.end());
+    }
+    std::stable_sort(trace.begin(), trace.end(),
+        [](const TimedUevent &a, const TimedUevent &b) { return a.at < b.at; });
+
+    auto countDisk = [](const std::vector<Dispatched> &out) {
+        size_t n = 0;
+        for (auto &event : out) {
+            n += (event.minor % minorStep == 0) ? 1 : 0;
+        }
+        return n;
+    };
+
+    Replayer direct(Ms(0));
+    direct.Replay(trace);
+    Replayer coalesced(SETTLE_WINDOW);
+    auto start = Clock::now();
+    coalesced.Replay(trace);
+    auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    size_t before = countDisk(direct.out);
+    size_t after = countDisk(coalesced.out);
+    GTEST_LOG_(INFO) << "storm events " << trace.size() << ", disk dispatches " << before << " -> " << after
+                     << ", coalescer cost " << cost / static_cast<int64_t>(trace.size()) << " ns/event";
+    EXPECT_EQ(after, static_cast<size_t>(readers));
+    for (auto &event : coalesced.out) {
+        if (event.minor % minorStep == 0) {
+            EXPECT_EQ(event.action, NetlinkData::Actions::ADD);
+        }
+    }
+    EXPECT_EQ(coalesced.coalescer.GetStats().emitted, static_cast<uint64_t>(readers));
+}
+} // STORAGE_DAEMON
+} // OHOS
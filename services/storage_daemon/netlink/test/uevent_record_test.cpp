@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "netlink/uevent_record.h"
+#include "netlink/uevent_replay.h"
+#include "storage_service_errno.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+const std::string RECORD_PATH = "/data/storage_daemon_uevent_record_test.bin";
+constexpr uint64_t NS_PER_MS = 1000000;
+
+std::string MakeUevent(const std::string &action, const std::string &subsystem, int32_t minor)
+{
+    std::string devPath = "/devices/platform/usbhost/3-1/host0/block/sd" + std::string(1, 'a' + minor % 26);
+    std::string msg = action + "@" + devPath;
+    msg.push_back('\0');
+    for (const std::string &entry : { "ACTION=" + action, "DEVPATH=" + devPath, "SUBSYSTEM=" + subsystem,
+        std::string("MAJOR=8"), "MINOR=" + std::to_string(minor), std::string("DEVTYPE=disk"),
+        "SEQNUM=" + std::to_string(minor + 1000) }) {
+        msg += entry;
+        msg.push_back('\0');
+    }
+    return msg;
+}
+
+/* A card reader storm interleaved with unrelated uevents */
+std::vector<UeventRecord> Storm(int32_t rounds)
+{
+    std::vector<UeventRecord> records;
+    uint64_t ts = 0;
+    for (int32_t i = 0; i < rounds; i++) {
+        records.push_back({ ts, MakeUevent("add", "block", i) });
+        records.push_back({ ts + NS_PER_MS, MakeUevent("change", "power_supply", i) });
+        records.push_back({ ts + 2 * NS_PER_MS, MakeUevent("remove", "block", i) });
+        ts += 3 * NS_PER_MS;
+    }
+    return records;
+}
+} // namespace
+
+using namespace testing::ext;
+
+class UeventRecordTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown()
+    {
+        (void)unlink(RECORD_PATH.c_str());
+    };
+};
+
+/**
+ * @tc.name: UeventRecordTest_RoundTrip_001
+ * @tc.desc: Verify recorded uevents are read back unchanged, and a truncated file keeps its complete records.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(UeventRecordTest, UeventRecordTest_RoundTrip_001, TestSize.Level1)
+{
+    auto storm = Storm(4);
+    UeventRecordWriter writer;
+    ASSERT_EQ(writer.Open(RECORD_PATH), E_OK);
+    for (auto &record : storm) {
+        EXPECT_EQ(writer.Append(record.timestampNs, record.msg.data(), record.msg.size()), E_OK);
+    }
+    writer.Close();
+
+    std::vector<UeventRecord> loaded;
+    ASSERT_EQ(ReadUeventRecords(RECORD_PATH, loaded), E_OK);
+    ASSERT_EQ(loaded.size(), storm.size());
+    for (size_t i = 0; i < storm.size(); i++) {
+        EXPECT_EQ(loaded[i].timestampNs, storm[i].timestampNs);
+        EXPECT_EQ(loaded[i].msg, storm[i].msg);
+    }
+
+    struct stat st;
+    ASSERT_EQ(stat(RECORD_PATH.c_str(), &st), 0);
+    ASSERT_EQ(truncate(RECORD_PATH.c_str(), st.st_size - 1), 0);
+    loaded.clear();
+    EXPECT_EQ(ReadUeventRecords(RECORD_PATH, loaded), E_ERR);
+    EXPECT_EQ(loaded.size(), storm.size() - 1);
+
+    EXPECT_EQ(ReadUeventRecords("/data/storage_daemon_no_such_record.bin", loaded), E_ERR);
+}
+
+/**
+ * @tc.name: UeventRecordTest_Replay_001
+ * @tc.desc: Replay a storm through NetlinkHandler over a socketpair and report throughput and latency.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(UeventRecordTest, UeventRecordTest_Replay_001, TestSize.Level1)
+{
+    const int32_t rounds = 200;
+    auto storm = Storm(rounds);
+    UeventReplayOptions options;
+    UeventReplayResult result;
+    ASSERT_EQ(ReplayUevents(storm, options, result), E_OK);
+
+    EXPECT_EQ(result.sent, storm.size());
+    EXPECT_EQ(result.received, storm.size());
+    EXPECT_EQ(result.dispatched, static_cast<uint64_t>(2 * rounds));
+    EXPECT_GT(result.eventsPerSec, 0);
+    EXPECT_LE(result.p50Us, result.p99Us);
+    EXPECT_LE(result.p99Us, result.maxUs);
+    GTEST_LOG_(INFO) << "replayed " << result.sent << " uevents at " << result.eventsPerSec << " events/s, latency us"
+                     << " p50 " << result.p50Us << " p90 " << result.p90Us << " p99 " << result.p99Us
+                     << " max " << result.maxUs;
+}
+} // STORAGE_DAEMON
+} // OHOS
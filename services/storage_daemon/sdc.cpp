@@ -182,6 +182,63 @@ static const auto g_fscryptCmdHandler = std::map<std::string,
     {"update_key_context", UpdateKeyContext},
 };
 
+static int32_t RunBenchmark(const std::vector<std::string> &args)
+{
+    if (args.size() < 4) {
+        LOGE("Parameter nums is less than 4, please retry");
+        return -EINVAL;
+    }
+    uint32_t budgetMs = 0;
+    if (args.size() > 4 && OHOS::StorageDaemon::StringToUint32(args[4], budgetMs) == false) {
+        LOGE("Parameter input error, please retry");
+        return -EINVAL;
+    }
+    OHOS::StorageManager::MediaBenchmarkResult result;
+    int32_t ret = OHOS::StorageDaemon::StorageDaemonClient::BenchmarkVolume(args[3], budgetMs, result);
+    if (ret != 0) {
+        return ret;
+    }
+    std::cout << "volume:      " << result.volumeId_ << (result.cancelled_ ? " (cancelled)" : "") << std::endl
+              << "duration:    " << result.durationMs_ << " ms" << (result.direct_ ? "" : ", no O_DIRECT") << std::endl
+              << "seq write:   " << result.seqWriteMBps_ << " MB/s" << std::endl
+              << "seq read:    " << result.seqReadMBps_ << " MB/s" << std::endl
+              << "rand write:  " << result.randWriteIops_ << " IOPS" << std::endl
+              << "rand read:   " << result.randReadIops_ << " IOPS" << std::endl
+              << "speed class: " << result.speedClass_ << std::endl;
+    return ret;
+}
+
+static int32_t CancelBenchmark(const std::vector<std::string> &args)
+{
+    if (args.size() < 4) {
+        LOGE("Parameter nums is less than 4, please retry");
+        return -EINVAL;
+    }
+    return OHOS::StorageDaemon::StorageDaemonClient::CancelBenchmark(args[3]);
+}
+
+static const auto g_benchmarkCmdHandler = std::map<std::string,
+    std::function<int32_t(const std::vector<std::string> &)>> {
+    {"run", RunBenchmark},
+    {"cancel", CancelBenchmark},
+};
+
+static int HandleBenchmark(const std::string &cmd, const std::vector<std::string> &args)
+{
+    LOGI("benchmark cmd: %{public}s", cmd.c_str());
+
+    auto handler = g_benchmarkCmdHandler.find(cmd);
+    if (handler == g_benchmarkCmdHandler.end()) {
+        LOGE("Unknown benchmark cmd: %{public}s", cmd.c_str());
+        return -EINVAL;
+    }
+    auto ret = handler->second(args);
+    if (ret != 0) {
+        LOGE("benchmark cmd: %{public}s failed, ret: %{public}d", cmd.c_str(), ret);
+    }
+    return ret;
+}
+
 static int HandleFileCrypt(const std::string &cmd, const std::vector<std::string> &args)
 {
     LOGI("fscrypt cmd: %{public}s", cmd.c_str());
@@ -213,6 +270,8 @@ int main(int argc, char **argv)
     int ret = 0;
     if (args[1] == "filecrypt") {
         ret = HandleFileCrypt(args[2], args); // no.2 param is the cmd
+    } else if (args[1] == "benchmark" && argc > 2) {
+        ret = HandleBenchmark(args[2], args); // no.2 param is the cmd
     } else {
         LOGE("Unknown subsystem: %{public}s", args[1].c_str());
         ret = -EINVAL;
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Hotplug storm record/replay harness.
+ *   uevent_tool record <file> <seconds>
+ *   uevent_tool replay <file> [speed] [settle_ms] [disk]
+ *   uevent_tool match <file> <config>
+ * "record" stores raw kernel uevents with timestamps. "replay" pushes them
+ * through NetlinkHandler over a socketpair, with DiskManager stubbed out
+ * unless "disk" is given, and prints throughput and latency percentiles.
+ * "match" runs the DEVPATH of every recorded disk uevent through the disk
+ * config matcher and through the per-config fnmatch loop, and prints the
+ * time per lookup of both.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/netlink.h>
+
+#include "disk/disk_config.h"
+#include "disk/disk_config_matcher.h"
+#include "netlink/netlink_data.h"
+#include "netlink/netlink_listener.h"
+#include "netlink/uevent_record.h"
+#include "netlink/uevent_replay.h"
+#include "securec.h"
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+#include "utils/string_utils.h"
+
+using namespace OHOS;
+using namespace OHOS::StorageDaemon;
+
+namespace {
+constexpr int32_t RECORD_SOCKET_BUF = 4 * 1024 * 1024;
+constexpr size_t ARG_FILE = 2;
+constexpr size_t ARG_SECONDS = 3;
+constexpr size_t ARG_SPEED = 3;
+constexpr size_t ARG_SETTLE = 4;
+constexpr size_t ARG_DISK = 5;
+constexpr size_t ARG_CONFIG = 3;
+constexpr size_t CONFIG_PARAM_NUM = 6;
+constexpr int32_t MATCH_ROUNDS = 100;
+
+class RecordListener : public NetlinkListener {
+public:
+    RecordListener(int32_t socket, UeventRecordWriter &writer)
+        : NetlinkListener(socket), writer_(writer), start_(std::chrono::steady_clock::now()) {}
+    uint64_t Recorded() const
+    {
+        return recorded_;
+    }
+
+protected:
+    void OnEvent(char *msg, size_t len) override
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+        if (writer_.Append(static_cast<uint64_t>(ns.count()), msg, len) == E_OK) {
+            recorded_++;
+        }
+    }
+
+private:
+    UeventRecordWriter &writer_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t recorded_ { 0 };
+};
+
+int32_t OpenUeventSocket()
+{
+    struct sockaddr_nl addr;
+    int32_t sz = RECORD_SOCKET_BUF;
+    int32_t on = 1;
+
+    (void)memset_s(&addr, sizeof(addr), 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_pid = 0;
+    addr.nl_groups = 0xffffffff;
+
+    int32_t fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) {
+        return -1;
+    }
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &sz, sizeof(sz)) != 0) {
+        (void)setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &sz, sizeof(sz));
+    }
+    if (setsockopt(fd, SOL_SOCKET, SO_PASSCRED, &on, sizeof(on)) != 0 ||
+        bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int32_t Record(const std::vector<std::string> &args)
+{
+    if (args.size() <= ARG_SECONDS) {
+        std::cerr << "usage: uevent_tool record <file> <seconds>" << std::endl;
+        return -EINVAL;
+    }
+
+    UeventRecordWriter writer;
+    if (writer.Open(args[ARG_FILE]) != E_OK) {
+        std::cerr << "cannot create " << args[ARG_FILE] << std::endl;
+        return E_ERR;
+    }
+    int32_t fd = OpenUeventSocket();
+    if (fd < 0) {
+        std::cerr << "cannot open uevent socket, errno " << errno << std::endl;
+        return E_ERR;
+    }
+
+    RecordListener listener(fd, writer);
+    if (listener.StartListener() != E_OK) {
+        close(fd);
+        return E_ERR;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(std::atoi(args[ARG_SECONDS].c_str())));
+    listener.StopListener();
+    close(fd);
+
+    UeventStats stats = listener.GetStats();
+    std::cout << "recorded " << listener.Recorded() << " uevents, " << stats.overflows << " overflows" << std::endl;
+    return E_OK;
+}
+
+int32_t Replay(const std::vector<std::string> &args)
+{
+    if (args.size() <= ARG_FILE) {
+        std::cerr << "usage: uevent_tool replay <file> [speed] [settle_ms] [disk]" << std::endl;
+        return -EINVAL;
+    }
+
+    std::vector<UeventRecord> records;
+    if (ReadUeventRecords(args[ARG_FILE], records) != E_OK && records.empty()) {
+        std::cerr << "cannot read " << args[ARG_FILE] << std::endl;
+        return E_ERR;
+    }
+
+    UeventReplayOptions options;
+    if (args.size() > ARG_SPEED) {
+        options.speed = std::atof(args[ARG_SPEED].c_str());
+    }
+    if (args.size() > ARG_SETTLE) {
+        options.settleWindow = std::chrono::milliseconds(std::atoi(args[ARG_SETTLE].c_str()));
+    }
+    options.useDiskManager = (args.size() > ARG_DISK && args[ARG_DISK] == "disk");
+
+    UeventReplayResult result;
+    int32_t ret = ReplayUevents(records, options, result);
+    std::cout << "sent " << result.sent << ", received " << result.received << ", dispatched " << result.dispatched
+              << std::endl;
+    std::cout << "elapsed " << result.seconds << " s, " << result.eventsPerSec << " events/s" << std::endl;
+    std::cout << "latency us p50 " << result.p50Us << " p90 " << result.p90Us << " p99 " << result.p99Us
+              << " max " << result.maxUs << std::endl;
+    return ret;
+}
+
+/* Same "sysPattern <glob> label <label> flag <flag>" lines storage_daemon loads at boot */
+int32_t LoadDiskConfigs(const std::string &path, std::vector<std::shared_ptr<DiskConfig>> &configs)
+{
+    std::ifstream infile(path);
+    if (!infile) {
+        return E_ERR;
+    }
+    std::string line;
+    std::string token = " ";
+    while (std::getline(infile, line)) {
+        auto split = SplitLine(line, token);
+        if (split.size() != CONFIG_PARAM_NUM || split[0] != "sysPattern" || split[2] != "label" ||
+            split[4] != "flag") {
+            continue;
+        }
+        configs.push_back(std::make_shared<DiskConfig>(split[1], split[3], std::atoi(split[5].c_str())));
+    }
+    return E_OK;
+}
+
+template<typename F>
+double NsPerLookup(const std::vector<std::string> &paths, F match, size_t &matched)
+{
+    matched = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t round = 0; round < MATCH_ROUNDS; round++) {
+        for (auto &path : paths) {
+            matched += match(path) ? 1 : 0;
+        }
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    matched /= MATCH_ROUNDS;
+    return static_cast<double>(ns.count()) / (static_cast<double>(paths.size()) * MATCH_ROUNDS);
+}
+
+int32_t Match(const std::vector<std::string> &args)
+{
+    if (args.size() <= ARG_CONFIG) {
+        std::cerr << "usage: uevent_tool match <file> <config>" << std::endl;
+        return -EINVAL;
+    }
+
+    std::vector<UeventRecord> records;
+    std::vector<std::shared_ptr<DiskConfig>> configs;
+    if (ReadUeventRecords(args[ARG_FILE], records) != E_OK && records.empty()) {
+        std::cerr << "cannot read " << args[ARG_FILE] << std::endl;
+        return E_ERR;
+    }
+    if (LoadDiskConfigs(args[ARG_CONFIG], configs) != E_OK) {
+        std::cerr << "cannot read " << args[ARG_CONFIG] << std::endl;
+        return E_ERR;
+    }
+
+    std::vector<std::string> paths;
+    for (auto &record : records) {
+        NetlinkData data;
+        data.Decode(record.msg.data(), record.msg.size());
+        if (data.GetSubsystem() == "block" && data.GetParam(NetlinkData::PARAM_DEVTYPE) == "disk") {
+            paths.push_back(data.GetDevpath());
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "no disk uevents recorded" << std::endl;
+        return E_ERR;
+    }
+
+    DiskConfigMatcher matcher;
+    for (auto &config : configs) {
+        matcher.Add(config);
+    }
+    size_t loopMatched = 0;
+    size_t trieMatched = 0;
+    double loopNs = NsPerLookup(paths, [&configs](const std::string &path) {
+        for (auto &config : configs) {
+            if (config->IsMatch(path)) {
+                return true;
+            }
+        }
+        return false;
+    }, loopMatched);
+    double trieNs = NsPerLookup(paths, [&matcher](const std::string &path) {
+        return matcher.Match(path) != nullptr;
+    }, trieMatched);
+
+    std::cout << paths.size() << " disk uevents, " << configs.size() << " configs" << std::endl;
+    std::cout << "fnmatch loop " << loopNs << " ns/event, " << loopMatched << " matched" << std::endl;
+    std::cout << "matcher " << trieNs << " ns/event, " << trieMatched << " matched" << std::endl;
+    return loopMatched == trieMatched ? E_OK : E_ERR;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> args(argv, argv + argc);
+    if (argc < 2) {
+        std::cerr << "usage: uevent_tool <record|replay|match> <file> ..." << std::endl;
+        return -EINVAL;
+    }
+
+    if (args[1] == "record") {
+        return Record(args);
+    } else if (args[1] == "replay") {
+        return Replay(args);
+    } else if (args[1] == "match") {
+        return Match(args);
+    }
+    std::cerr << "unknown command " << args[1] << std::endl;
+    return -EINVAL;
+}
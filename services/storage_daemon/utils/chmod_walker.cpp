@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/chmod_walker.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr size_t MAX_PENDING_DIRS = 64;
+constexpr mode_t ALL_PERMS = 07777;
+constexpr int32_t DIR_OPEN_FLAGS = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+}
+
+ChmodWalker::ChmodWalker(uint32_t threads) : threads_(std::max(threads, 1U))
+{
+}
+
+void ChmodWalker::Cancel()
+{
+    cancelled_ = true;
+    std::lock_guard<std::mutex> lock(lock_);
+    cond_.notify_all();
+}
+
+bool ChmodWalker::Offer(int32_t dirFd)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    if (pending_.size() >= MAX_PENDING_DIRS) {
+        return false;
+    }
+    pending_.push_back(dirFd);
+    cond_.notify_one();
+    return true;
+}
+
+void ChmodWalker::WalkDir(int32_t dirFd, mode_t mode, ChmodWalkStats &stats)
+{
+    struct stat st;
+    stats.dirs++;
+    if (fstat(dirFd, &st) == 0 && (st.st_mode & ALL_PERMS) != mode) {
+        if (fchmod(dirFd, mode) == 0) {
+            stats.changed++;
+        } else {
+            stats.failed++;
+        }
+    }
+
+    DIR *dir = fdopendir(dirFd);
+    if (dir == nullptr) {
+        (void)close(dirFd);
+        stats.failed++;
+        return;
+    }
+    struct dirent *entry;
+    while (!cancelled_ && (entry = readdir(dir)) != nullptr) {
+        const char *name = entry->d_name;
+        if (entry->d_type == DT_LNK || strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+            continue;
+        }
+        if (entry->d_type == DT_DIR) {
+            int32_t subFd = openat(dirFd, name, DIR_OPEN_FLAGS);
+            if (subFd < 0) {
+                stats.failed++;
+            } else if (!Offer(subFd)) {
+                WalkDir(subFd, mode, stats);
+            }
+            continue;
+        }
+
+        /* DT_UNKNOWN lands here too, the stat tells what it really is */
+        if (fstatat(dirFd, name, &st, AT_SYMLINK_NOFOLLOW) != 0 || S_ISLNK(st.st_mode)) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            int32_t subFd = openat(dirFd, name, DIR_OPEN_FLAGS);
+            if (subFd >= 0 && !Offer(subFd)) {
+                WalkDir(subFd, mode, stats);
+            }
+            continue;
+        }
+        stats.files++;
+        if ((st.st_mode & ALL_PERMS) == mode) {
+            continue;
+        }
+        /* NOFOLLOW keeps a symlink swapped in since the stat from redirecting the chmod */
+        if (fchmodat(dirFd, name, mode, AT_SYMLINK_NOFOLLOW) == 0) {
+            stats.changed++;
+        } else {
+            stats.failed++;
+        }
+    }
+    closedir(dir);
+}
+
+void ChmodWalker::Worker(mode_t mode, ChmodWalkStats &stats)
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+        cond_.wait(lock, [this] { return cancelled_ || !pending_.empty() || busy_ == 0; });
+        if (cancelled_ || pending_.empty()) {
+            return;
+        }
+        int32_t dirFd = pending_.front();
+        pending_.pop_front();
+        busy_++;
+        lock.unlock();
+        WalkDir(dirFd, mode, stats);
+        lock.lock();
+        busy_--;
+        if (busy_ == 0 && pending_.empty()) {
+            cond_.notify_all();
+        }
+    }
+}
+
+int32_t ChmodWalker::Walk(const std::string &root, mode_t mode, ChmodWalkStats &stats)
+{
+    auto start = std::chrono::steady_clock::now();
+    stats = ChmodWalkStats();
+    int32_t rootFd = TEMP_FAILURE_RETRY(open(root.c_str(), DIR_OPEN_FLAGS));
+    if (rootFd < 0) {
+        LOGE("open %{public}s failed, errno %{public}d", root.c_str(), errno);
+        return E_ERR;
+    }
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        pending_.push_back(rootFd);
+    }
+
+    std::vector<ChmodWalkStats> results(threads_);
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < threads_; i++) {
+        workers.emplace_back([this, mode, &results, i] { Worker(mode, results[i]); });
+    }
+    Worker(mode, results[0]);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    /* Directories still queued after a cancel were never walked */
+    for (int32_t dirFd : pending_) {
+        (void)close(dirFd);
+    }
+    pending_.clear();
+    for (auto &result : results) {
+        stats.dirs += result.dirs;
+        stats.files += result.files;
+        stats.changed += result.changed;
+        stats.failed += result.failed;
+    }
+    stats.cancelled = cancelled_;
+    stats.elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return E_OK;
+}
+} // STORAGE_DAEMON
+} // OHOS
@@ -16,6 +16,7 @@
 #include "utils/disk_utils.h"
 
 #include <cerrno>
+#include <climits>
 #include <unistd.h>
 #include <unordered_map>
 #include <fcntl.h>
@@ -26,6 +27,7 @@
 #include "storage_service_errno.h"
 #include "storage_service_log.h"
 #include "utils/file_utils.h"
+#include "utils/sysfs_reader.h"
 
 namespace OHOS {
 namespace StorageDaemon {
@@ -73,12 +75,12 @@ int GetMaxVolume(dev_t device)
 {
     unsigned int majorId = major(device);
     if (majorId == DISK_MMC_MAJOR) {
-        std::string str;
-        if (!ReadFile(MMC_MAX_VOLUMES_PATH, &str)) {
+        int64_t maxVolumes = 0;
+        if (ReadSysfsInt(MMC_MAX_VOLUMES_PATH, maxVolumes) != E_OK || maxVolumes < 0 || maxVolumes > INT_MAX) {
             LOGE("Get MmcMaxVolumes failed");
             return E_ERR;
         }
-        return std::stoi(str);
+        return static_cast<int>(maxVolumes);
     } else {
         return MAX_SCSI_VOLUMES;
     }
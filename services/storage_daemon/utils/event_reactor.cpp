@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/event_reactor.h"
+
+#include <cerrno>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+constexpr int32_t MAX_EPOLL_EVENTS = 16;
+
+EventReactor::~EventReactor()
+{
+    if (stopFd_ >= 0) {
+        close(stopFd_);
+    }
+    if (epollFd_ >= 0) {
+        close(epollFd_);
+    }
+}
+
+int32_t EventReactor::Init()
+{
+    if (epollFd_ >= 0) {
+        return E_OK;
+    }
+
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        LOGE("epoll_create1 failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+
+    stopFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (stopFd_ < 0) {
+        LOGE("eventfd failed, errno %{public}d", errno);
+        close(epollFd_);
+        epollFd_ = -1;
+        return E_ERR;
+    }
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = stopFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, stopFd_, &ev) != 0) {
+        LOGE("Add stop eventfd failed, errno %{public}d", errno);
+        close(stopFd_);
+        close(epollFd_);
+        stopFd_ = epollFd_ = -1;
+        return E_ERR;
+    }
+    return E_OK;
+}
+
+int32_t EventReactor::AddSource(int32_t fd, uint32_t events, Callback callback)
+{
+    if (epollFd_ < 0 || fd < 0 || callback == nullptr) {
+        return E_ERR;
+    }
+
+    std::lock_guard<std::mutex> lock(lock_);
+    struct epoll_event ev = {};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        LOGE("Add source %{public}d failed, errno %{public}d", fd, errno);
+        return E_ERR;
+    }
+    sources_[fd] = std::make_shared<Callback>(std::move(callback));
+    return E_OK;
+}
+
+int32_t EventReactor::RemoveSource(int32_t fd)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    if (sources_.erase(fd) == 0) {
+        return E_NON_EXIST;
+    }
+    if (epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr) != 0) {
+        LOGE("Remove source %{public}d failed, errno %{public}d", fd, errno);
+        return E_ERR;
+    }
+    return E_OK;
+}
+
+int32_t EventReactor::Run()
+{
+    if (epollFd_ < 0) {
+        return E_ERR;
+    }
+
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    while (true) {
+        int32_t n = epoll_wait(epollFd_, events, MAX_EPOLL_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOGE("epoll_wait failed, errno %{public}d", errno);
+            return E_ERR;
+        }
+        wakeups_++;
+
+        for (int32_t i = 0; i < n; i++) {
+            int32_t fd = events[i].data.fd;
+            if (fd == stopFd_) {
+                eventfd_t value;
+                (void)eventfd_read(stopFd_, &value);
+                return E_OK;
+            }
+
+            std::shared_ptr<Callback> callback;
+            {
+                std::lock_guard<std::mutex> lock(lock_);
+                auto it = sources_.find(fd);
+                if (it == sources_.end()) {
+                    continue;
+                }
+                callback = it->second;
+            }
+            (*callback)(events[i].events);
+        }
+    }
+}
+
+void EventReactor::Stop()
+{
+    if (stopFd_ >= 0 && eventfd_write(stopFd_, 1) != 0) {
+        LOGE("Signal reactor stop failed, errno %{public}d", errno);
+    }
+}
+
+uint64_t EventReactor::GetWakeups() const
+{
+    return wakeups_.load();
+}
+} // namespace StorageDaemon
+} // namespace OHOS
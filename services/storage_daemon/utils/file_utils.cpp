@@ -16,7 +16,6 @@
 #include "utils/file_utils.h"
 
 #include <cerrno>
-#include <fstream>
 #include <unistd.h>
 #include <cstring>
 #include <dirent.h>
@@ -199,38 +198,6 @@ bool RmDirRecurse(const std::string &path)
     return true;
 }
 
-void TravelChmod(std::string path, mode_t mode)
-{
-    struct stat st;
-    DIR *d = NULL;
-    struct dirent *dp = NULL;
-    const char *skip1 = ".";
-    const char *skip2 = "..";
-
-    if (stat(path.c_str(), &st) < 0 || !S_ISDIR(st.st_mode)) {
-        LOGE("invalid path");
-        return;
-    }
-
-    (void)ChMod(path, mode);
-    if (!(d = opendir(path.c_str()))) {
-        LOGE("opendir failed");
-        return;
-    }
-
-    while ((dp = readdir(d)) != NULL) {
-        if ((!strncmp(dp->d_name, skip1, strlen(skip1))) || (!strncmp(dp->d_name, skip2, strlen(skip2))))
-            continue;
-
-        std::string subpath = path + "/" + dp->d_name;
-        stat(subpath.c_str(), &st);
-        (void)ChMod(subpath, mode);
-        if (S_ISDIR(st.st_mode))
-            TravelChmod(subpath, mode);
-    }
-    closedir(d);
-}
-
 bool StringToUint32(const std::string &str, uint32_t &num)
 {
     if (str.empty()) {
@@ -317,37 +284,6 @@ void ReadDigitDir(const std::string &path, std::vector<FileList> &dirInfo)
     closedir(dir);
 }
 
-bool ReadFile(std::string path, std::string *str)
-{
-    std::ifstream infile;
-    int cnt = 0;
-
-    std::string rpath(PATH_MAX + 1, '\0');
-    if ((path.length() > PATH_MAX) || (realpath(path.c_str(), rpath.data()) == nullptr)) {
-        LOGE("realpath failed");
-        return false;
-    }
-
-    infile.open(rpath.c_str());
-    if (!infile) {
-        LOGE("Cannot open file");
-        return false;
-    }
-
-    while (1) {
-        std::string subStr;
-        infile >> subStr;
-        if (subStr == "") {
-            break;
-        }
-        cnt++;
-        *str = *str + subStr + '\n';
-    }
-
-    infile.close();
-    return cnt == 0 ? false : true;
-}
-
 static std::vector<char*> FromatCmd(std::vector<std::string> &cmd)
 {
     std::vector<char*>res;
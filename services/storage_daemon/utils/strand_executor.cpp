@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/strand_executor.h"
+
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+StrandExecutor::StrandExecutor(uint32_t threads) : threadCount_(threads == 0 ? 1 : threads) {}
+
+StrandExecutor::~StrandExecutor()
+{
+    Stop();
+}
+
+bool StrandExecutor::Post(uint64_t key, Task task)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    if (stop_) {
+        LOGE("Executor stopped, task dropped");
+        return false;
+    }
+    if (threads_.empty()) {
+        for (uint32_t i = 0; i < threadCount_; i++) {
+            threads_.emplace_back([this] { Run(); });
+        }
+    }
+
+    auto &strand = strands_[key];
+    strand.push_back(std::move(task));
+    pending_++;
+    if (strand.size() == 1) {
+        ready_.push_back(key);
+        workCond_.notify_one();
+    }
+    return true;
+}
+
+void StrandExecutor::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    idleCond_.wait(lock, [this] { return pending_ == 0; });
+}
+
+void StrandExecutor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        stop_ = true;
+        workCond_.notify_all();
+    }
+    for (auto &thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+void StrandExecutor::Run()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+        workCond_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+        if (ready_.empty()) {
+            return;
+        }
+        uint64_t key = ready_.front();
+        ready_.pop_front();
+        Task task = std::move(strands_[key].front());
+
+        lock.unlock();
+        task();
+        task = nullptr;
+        lock.lock();
+
+        auto it = strands_.find(key);
+        it->second.pop_front();
+        if (it->second.empty()) {
+            strands_.erase(it);
+        } else {
+            ready_.push_back(key);
+            workCond_.notify_one();
+        }
+        if (--pending_ == 0) {
+            idleCond_.notify_all();
+        }
+    }
+}
+} // namespace StorageDaemon
+} // namespace OHOS
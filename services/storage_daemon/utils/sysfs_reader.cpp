@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/sysfs_reader.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+/* sysfs hands out the whole attribute on the first read, a single pread is enough */
+int32_t ReadAt(int32_t dirFd, const char *name, std::string &value)
+{
+    int32_t fd = openat(dirFd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return E_ERR;
+    }
+    char buf[SYSFS_ATTR_MAX];
+    ssize_t len = TEMP_FAILURE_RETRY(pread(fd, buf, sizeof(buf), 0));
+    close(fd);
+    if (len < 0) {
+        return E_ERR;
+    }
+
+    size_t begin = 0;
+    size_t end = static_cast<size_t>(len);
+    while (begin < end && isspace(static_cast<unsigned char>(buf[begin]))) {
+        begin++;
+    }
+    while (end > begin && isspace(static_cast<unsigned char>(buf[end - 1]))) {
+        end--;
+    }
+    value.assign(buf + begin, end - begin);
+    return E_OK;
+}
+
+int32_t ParseInt(const std::string &str, int64_t &value)
+{
+    if (str.empty()) {
+        return E_ERR;
+    }
+    char *end = nullptr;
+    errno = 0;
+    long long num = strtoll(str.c_str(), &end, 0);
+    if (errno != 0 || *end != '\0') {
+        return E_ERR;
+    }
+    value = static_cast<int64_t>(num);
+    return E_OK;
+}
+}
+
+SysfsDir::SysfsDir(const std::string &path)
+{
+    dirFd_ = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+SysfsDir::~SysfsDir()
+{
+    if (dirFd_ >= 0) {
+        close(dirFd_);
+    }
+}
+
+bool SysfsDir::IsOpen() const
+{
+    return dirFd_ >= 0;
+}
+
+int32_t SysfsDir::Fd() const
+{
+    return dirFd_;
+}
+
+int32_t SysfsDir::Read(const char *name, std::string &value) const
+{
+    if (dirFd_ < 0) {
+        return E_ERR;
+    }
+    return ReadAt(dirFd_, name, value);
+}
+
+int32_t SysfsDir::ReadInt(const char *name, int64_t &value) const
+{
+    std::string str;
+    if (Read(name, str) != E_OK) {
+        return E_ERR;
+    }
+    return ParseInt(str, value);
+}
+
+size_t SysfsDir::ReadAll(std::vector<SysfsAttr> &attrs) const
+{
+    size_t count = 0;
+    for (auto &attr : attrs) {
+        attr.err = Read(attr.name, attr.value);
+        if (attr.err == E_OK) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int32_t ReadSysfsAttr(const std::string &path, std::string &value)
+{
+    return ReadAt(AT_FDCWD, path.c_str(), value);
+}
+
+int32_t ReadSysfsInt(const std::string &path, int64_t &value)
+{
+    std::string str;
+    if (ReadSysfsAttr(path, str) != E_OK) {
+        return E_ERR;
+    }
+    return ParseInt(str, value);
+}
+} // namespace StorageDaemon
+} // namespace OHOS
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "storage_service_errno.h"
+#include "utils/chmod_walker.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_DIR = "/data/chmod_walker_test";
+const std::string TREE_DIR = TEST_DIR + "/tree";
+const std::string OUTSIDE_FILE = TEST_DIR + "/outside";
+constexpr mode_t OPEN_MODE = 0777;
+constexpr mode_t CLOSED_MODE = 0600;
+
+void MakeFile(const std::string &path)
+{
+    int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, CLOSED_MODE);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(fchmod(fd, CLOSED_MODE), 0);
+    close(fd);
+}
+
+/* width subdirectories per level down to depth, each directory holding files files of CLOSED_MODE */
+void MakeTree(const std::string &dir, int32_t depth, int32_t width, int32_t files)
+{
+    ASSERT_EQ(mkdir(dir.c_str(), 0700), 0);
+    for (int32_t i = 0; i < files; i++) {
+        MakeFile(dir + "/f" + std::to_string(i));
+    }
+    for (int32_t i = 0; depth > 0 && i < width; i++) {
+        MakeTree(dir + "/d" + std::to_string(i), depth - 1, width, files);
+    }
+}
+
+mode_t ModeOf(const std::string &path)
+{
+    struct stat st = {};
+    lstat(path.c_str(), &st);
+    return st.st_mode & 07777;
+}
+}
+
+class ChmodWalkerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp()
+    {
+        system(("rm -rf " + TEST_DIR).c_str());
+        ASSERT_EQ(system(("mkdir -p " + TEST_DIR).c_str()), 0);
+    };
+    void TearDown()
+    {
+        system(("rm -rf " + TEST_DIR).c_str());
+    };
+};
+
+/**
+ * @tc.name: ChmodWalkerTest_Walk_001
+ * @tc.desc: Verify every file and directory of the tree gets the mode, symlinks are not followed and a second walk
+ *           changes nothing.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(ChmodWalkerTest, ChmodWalkerTest_Walk_001, TestSize.Level1)
+{
+    MakeTree(TREE_DIR, 3, 3, 4);
+    MakeFile(OUTSIDE_FILE);
+    ASSERT_EQ(symlink(OUTSIDE_FILE.c_str(), (TREE_DIR + "/d1/link").c_str()), 0);
+    ASSERT_EQ(symlink(TEST_DIR.c_str(), (TREE_DIR + "/d2/dirlink").c_str()), 0);
+
+    ChmodWalker walker;
+    ChmodWalkStats stats;
+    EXPECT_EQ(walker.Walk(TREE_DIR, OPEN_MODE, stats), E_OK);
+    /* 1 + 3 + 9 + 27 directories with 4 files each */
+    EXPECT_EQ(stats.dirs, 40);
+    EXPECT_EQ(stats.files, 160);
+    EXPECT_EQ(stats.changed, 200);
+    EXPECT_EQ(stats.failed, 0);
+    EXPECT_FALSE(stats.cancelled);
+    EXPECT_EQ(ModeOf(TREE_DIR), OPEN_MODE);
+    EXPECT_EQ(ModeOf(TREE_DIR + "/d2/d0/d1"), OPEN_MODE);
+    EXPECT_EQ(ModeOf(TREE_DIR + "/d2/d0/d1/f3"), OPEN_MODE);
+    EXPECT_EQ(ModeOf(OUTSIDE_FILE), CLOSED_MODE);
+
+    EXPECT_EQ(walker.Walk(TREE_DIR, OPEN_MODE, stats), E_OK);
+    EXPECT_EQ(stats.files, 160);
+    EXPECT_EQ(stats.changed, 0);
+}
+
+/**
+ * @tc.name: ChmodWalkerTest_Walk_002
+ * @tc.desc: Verify a missing root or one that is a symlink fails without changing anything.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(ChmodWalkerTest, ChmodWalkerTest_Walk_002, TestSize.Level1)
+{
+    ChmodWalker walker;
+    ChmodWalkStats stats;
+    EXPECT_EQ(walker.Walk(TREE_DIR, OPEN_MODE, stats), E_ERR);
+
+    MakeTree(TREE_DIR, 0, 0, 1);
+    ASSERT_EQ(symlink(TREE_DIR.c_str(), (TEST_DIR + "/rootlink").c_str()), 0);
+    EXPECT_EQ(walker.Walk(TEST_DIR + "/rootlink", OPEN_MODE, stats), E_ERR);
+    EXPECT_EQ(ModeOf(TREE_DIR + "/f0"), CLOSED_MODE);
+}
+
+/**
+ * @tc.name: ChmodWalkerTest_Cancel_001
+ * @tc.desc: Verify a cancelled walk returns early and reports the cancel.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(ChmodWalkerTest, ChmodWalkerTest_Cancel_001, TestSize.Level1)
+{
+    MakeTree(TREE_DIR, 3, 8, 8);
+    ChmodWalker walker;
+    walker.Cancel();
+    ChmodWalkStats stats;
+    EXPECT_EQ(walker.Walk(TREE_DIR, OPEN_MODE, stats), E_OK);
+    EXPECT_TRUE(stats.cancelled);
+    EXPECT_LT(stats.files, 8 * (1 + 8 + 64 + 512));
+}
+
+/**
+ * @tc.name: ChmodWalkerTest_Benchmark_001
+ * @tc.desc: Time walking a tree of about 40000 entries on one thread, on the default thread count, and again once
+ *           nothing is left to change.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(ChmodWalkerTest, ChmodWalkerTest_Benchmark_001, TestSize.Level3)
+{
+    MakeTree(TREE_DIR, 3, 12, 20);
+    auto run = [](uint32_t threads, mode_t mode) {
+        ChmodWalker walker(threads);
+        ChmodWalkStats stats;
+        EXPECT_EQ(walker.Walk(TREE_DIR, mode, stats), E_OK);
+        return stats;
+    };
+
+    ChmodWalkStats serial = run(1, OPEN_MODE);
+    ChmodWalkStats parallel = run(CHMOD_WALK_THREADS, 0775);
+    ChmodWalkStats unchanged = run(CHMOD_WALK_THREADS, 0775);
+    GTEST_LOG_(INFO) << "chmod walk of " << serial.files << " files: 1 thread " << serial.elapsedUs / 1000
+                     << " ms, " << CHMOD_WALK_THREADS << " threads " << parallel.elapsedUs / 1000
+                     << " ms, already fixed " << unchanged.elapsedUs / 1000 << " ms";
+    EXPECT_EQ(parallel.changed, serial.changed);
+    EXPECT_EQ(unchanged.changed, 0);
+}
+} // namespace StorageDaemon
+} // namespace OHOS
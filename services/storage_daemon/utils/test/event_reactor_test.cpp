@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <thread>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "storage_service_errno.h"
+#include "utils/event_reactor.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+class EventReactorTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: EventReactorTest_Run_001
+ * @tc.desc: Verify Run fails before Init and returns right away when Stop was already signalled.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(EventReactorTest, EventReactorTest_Run_001, TestSize.Level1)
+{
+    EventReactor reactor;
+    EXPECT_EQ(reactor.Run(), E_ERR);
+    EXPECT_EQ(reactor.AddSource(0, EPOLLIN, [](uint32_t) {}), E_ERR);
+
+    ASSERT_EQ(reactor.Init(), E_OK);
+    reactor.Stop();
+    EXPECT_EQ(reactor.Run(), E_OK);
+}
+
+/**
+ * @tc.name: EventReactorTest_Source_001
+ * @tc.desc: Verify registered sources are dispatched, removed ones are not, and an idle loop never wakes up.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(EventReactorTest, EventReactorTest_Source_001, TestSize.Level1)
+{
+    EventReactor reactor;
+    ASSERT_EQ(reactor.Init(), E_OK);
+
+    int32_t efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    ASSERT_GE(efd, 0);
+    std::atomic<uint32_t> fired { 0 };
+    ASSERT_EQ(reactor.AddSource(efd, EPOLLIN, [efd, &fired](uint32_t events) {
+        eventfd_t value;
+        (void)eventfd_read(efd, &value);
+        fired += static_cast<uint32_t>(value);
+    }), E_OK);
+
+    std::thread loop([&reactor] { reactor.Run(); });
+    const int32_t idleUs = 200000;
+    usleep(idleUs);
+    EXPECT_EQ(reactor.GetWakeups(), 0u);
+
+    (void)eventfd_write(efd, 3);
+    for (int32_t i = 0; i < 100 && fired.load() == 0; i++) {
+        usleep(1000);
+    }
+    EXPECT_EQ(fired.load(), 3u);
+
+    EXPECT_EQ(reactor.RemoveSource(efd), E_OK);
+    EXPECT_EQ(reactor.RemoveSource(efd), E_NON_EXIST);
+    (void)eventfd_write(efd, 1);
+    usleep(idleUs / 10);
+    EXPECT_EQ(fired.load(), 3u);
+
+    reactor.Stop();
+    loop.join();
+    close(efd);
+}
+
+/**
+ * @tc.name: EventReactorTest_Timer_001
+ * @tc.desc: Verify a timerfd shares the loop and can remove itself from its own callback.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(EventReactorTest, EventReactorTest_Timer_001, TestSize.Level1)
+{
+    EventReactor reactor;
+    ASSERT_EQ(reactor.Init(), E_OK);
+
+    int32_t tfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    ASSERT_GE(tfd, 0);
+    struct itimerspec spec = {};
+    const long intervalNs = 10000000;
+    spec.it_value.tv_nsec = intervalNs;
+    spec.it_interval.tv_nsec = intervalNs;
+    ASSERT_EQ(timerfd_settime(tfd, 0, &spec, nullptr), 0);
+
+    const uint64_t ticksWanted = 3;
+    uint64_t ticks = 0;
+    ASSERT_EQ(reactor.AddSource(tfd, EPOLLIN, [&](uint32_t events) {
+        uint64_t expired = 0;
+        if (read(tfd, &expired, sizeof(expired)) == sizeof(expired)) {
+            ticks += expired;
+        }
+        if (ticks >= ticksWanted) {
+            reactor.RemoveSource(tfd);
+            reactor.Stop();
+        }
+    }), E_OK);
+
+    EXPECT_EQ(reactor.Run(), E_OK);
+    EXPECT_GE(ticks, ticksWanted);
+    close(tfd);
+}
+} // STORAGE_DAEMON
+} // OHOS
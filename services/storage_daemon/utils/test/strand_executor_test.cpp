@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "utils/strand_executor.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+class StrandExecutorTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: StrandExecutorTest_Order_001
+ * @tc.desc: Verify tasks of one key run one at a time in posting order, and WaitIdle waits for all of them.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(StrandExecutorTest, StrandExecutorTest_Order_001, TestSize.Level1)
+{
+    const uint64_t keys = 3;
+    const int32_t tasks = 200;
+    StrandExecutor executor(4);
+    std::mutex lock;
+    std::map<uint64_t, std::vector<int32_t>> seen;
+    std::atomic<int32_t> running[keys] {};
+    std::atomic<bool> overlapped { false };
+
+    for (int32_t i = 0; i < tasks; i++) {
+        for (uint64_t key = 0; key < keys; key++) {
+            EXPECT_TRUE(executor.Post(key, [&, key, i] {
+                if (running[key].fetch_add(1) != 0) {
+                    overlapped = true;
+                }
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    seen[key].push_back(i);
+                }
+                running[key].fetch_sub(1);
+            }));
+        }
+    }
+    executor.WaitIdle();
+
+    EXPECT_FALSE(overlapped);
+    for (uint64_t key = 0; key < keys; key++) {
+        ASSERT_EQ(seen[key].size(), static_cast<size_t>(tasks));
+        for (int32_t i = 0; i < tasks; i++) {
+            EXPECT_EQ(seen[key][i], i);
+        }
+    }
+}
+
+/**
+ * @tc.name: StrandExecutorTest_Stop_001
+ * @tc.desc: Verify Stop runs the tasks already posted and later posts are refused.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(StrandExecutorTest, StrandExecutorTest_Stop_001, TestSize.Level1)
+{
+    StrandExecutor executor(2);
+    std::atomic<int32_t> done { 0 };
+
+    for (int32_t i = 0; i < 10; i++) {
+        EXPECT_TRUE(executor.Post(i % 2, [&done] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            done++;
+        }));
+    }
+    executor.Stop();
+    EXPECT_EQ(done, 10);
+    EXPECT_FALSE(executor.Post(0, [&done] { done++; }));
+    executor.WaitIdle();
+    EXPECT_EQ(done, 10);
+}
+
+/**
+ * @tc.name: StrandExecutorTest_Benchmark_001
+ * @tc.desc: Plugging a hub brings several disks at once, each needing a slow setup. Verify the setups overlap
+ *           so the last disk is ready after about one setup instead of after all of them.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(StrandExecutorTest, StrandExecutorTest_Benchmark_001, TestSize.Level3)
+{
+    const uint64_t disks = 4;
+    const auto setup = std::chrono::milliseconds(50);
+    StrandExecutor executor(disks);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t disk = 0; disk < disks; disk++) {
+        EXPECT_TRUE(executor.Post(disk, [setup] { std::this_thread::sleep_for(setup); }));
+    }
+    executor.WaitIdle();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    GTEST_LOG_(INFO) << disks << " disks, " << setup.count() << " ms setup each: ready after " << elapsed.count()
+                     << " ms (serial " << setup.count() * disks << " ms)";
+    EXPECT_LT(elapsed, setup * 2);
+}
+} // namespace StorageDaemon
+} // namespace OHOS
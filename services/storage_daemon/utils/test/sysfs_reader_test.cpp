@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "storage_service_errno.h"
+#include "utils/sysfs_reader.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_DIR = "/data/sysfs_reader_test";
+
+void WriteAttr(const std::string &name, const std::string &content)
+{
+    int fd = open((TEST_DIR + "/" + name).c_str(), O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    close(fd);
+}
+}
+
+class SysfsReaderTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp()
+    {
+        system(("rm -rf " + TEST_DIR).c_str());
+        ASSERT_EQ(system(("mkdir -p " + TEST_DIR + "/device").c_str()), 0);
+        WriteAttr("device/vendor", "Generic STORAGE \n");
+        WriteAttr("device/manfid", "0x000003\n");
+        WriteAttr("size", "15523840\n");
+        WriteAttr("uevent", "MAJOR=8\nMINOR=0\nDEVNAME=sda\nDEVTYPE=disk\n");
+        WriteAttr("empty", "");
+    };
+    void TearDown()
+    {
+        system(("rm -rf " + TEST_DIR).c_str());
+    };
+};
+
+/**
+ * @tc.name: SysfsReaderTest_Read_001
+ * @tc.desc: Verify attributes are read relative to the directory with surrounding whitespace trimmed.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(SysfsReaderTest, SysfsReaderTest_Read_001, TestSize.Level1)
+{
+    SysfsDir dir(TEST_DIR);
+    ASSERT_TRUE(dir.IsOpen());
+
+    std::string value;
+    EXPECT_EQ(dir.Read("device/vendor", value), E_OK);
+    EXPECT_EQ(value, "Generic STORAGE");
+    EXPECT_EQ(dir.Read("uevent", value), E_OK);
+    EXPECT_EQ(value, "MAJOR=8\nMINOR=0\nDEVNAME=sda\nDEVTYPE=disk");
+    EXPECT_EQ(dir.Read("empty", value), E_OK);
+    EXPECT_EQ(value, "");
+    EXPECT_EQ(dir.Read("missing", value), E_ERR);
+
+    int64_t num = 0;
+    EXPECT_EQ(dir.ReadInt("device/manfid", num), E_OK);
+    EXPECT_EQ(num, 3);
+    EXPECT_EQ(dir.ReadInt("size", num), E_OK);
+    EXPECT_EQ(num, 15523840);
+    EXPECT_EQ(dir.ReadInt("device/vendor", num), E_ERR);
+    EXPECT_EQ(dir.ReadInt("empty", num), E_ERR);
+
+    EXPECT_EQ(ReadSysfsInt(TEST_DIR + "/size", num), E_OK);
+    EXPECT_EQ(num, 15523840);
+    EXPECT_EQ(ReadSysfsAttr(TEST_DIR + "/missing", value), E_ERR);
+
+    SysfsDir missing(TEST_DIR + "/missing");
+    EXPECT_FALSE(missing.IsOpen());
+    EXPECT_EQ(missing.Read("size", value), E_ERR);
+}
+
+/**
+ * @tc.name: SysfsReaderTest_ReadAll_001
+ * @tc.desc: Verify a batch read fills every attribute and reports the missing ones.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(SysfsReaderTest, SysfsReaderTest_ReadAll_001, TestSize.Level1)
+{
+    SysfsDir dir(TEST_DIR);
+    std::vector<SysfsAttr> attrs = {
+        { "device/vendor", "", E_OK },
+        { "missing", "", E_OK },
+        { "size", "", E_OK },
+    };
+    EXPECT_EQ(dir.ReadAll(attrs), 2);
+    EXPECT_EQ(attrs[0].err, E_OK);
+    EXPECT_EQ(attrs[0].value, "Generic STORAGE");
+    EXPECT_EQ(attrs[1].err, E_ERR);
+    EXPECT_EQ(attrs[2].err, E_OK);
+    EXPECT_EQ(attrs[2].value, "15523840");
+}
+
+/**
+ * @tc.name: SysfsReaderTest_Benchmark_001
+ * @tc.desc: Time reading the disk metadata attributes through SysfsDir.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(SysfsReaderTest, SysfsReaderTest_Benchmark_001, TestSize.Level3)
+{
+    const int32_t rounds = 2000;
+    const std::vector<std::string> names = { "device/vendor", "device/manfid", "size", "uevent" };
+
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < rounds; i++) {
+        SysfsDir dir(TEST_DIR);
+        std::vector<SysfsAttr> attrs;
+        for (auto &name : names) {
+            attrs.push_back({ name.c_str(), "", E_OK });
+        }
+        EXPECT_EQ(dir.ReadAll(attrs), names.size());
+    }
+    auto sysfsNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    GTEST_LOG_(INFO) << "SysfsDir " << sysfsNs.count() / rounds << " ns/disk";
+}
+} // namespace StorageDaemon
+} // namespace OHOS
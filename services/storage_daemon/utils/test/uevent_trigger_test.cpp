@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fnmatch.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "storage_service_errno.h"
+#include "utils/file_utils.h"
+#include "utils/uevent_trigger.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_ROOT = "/data/uevent_trigger_test";
+const std::string USB_DISK = TEST_ROOT + "/devices/platform/usbhost/host0/block/sda";
+const std::string SD_DISK = TEST_ROOT + "/devices/platform/dwmmc/mmc0/block/mmcblk1";
+const std::string LOOP_DISK = TEST_ROOT + "/devices/virtual/block/loop0";
+
+void MakeDevice(const std::string &devDir, const std::string &link)
+{
+    ASSERT_EQ(system(("mkdir -p " + devDir).c_str()), 0);
+    int fd = open((devDir + "/uevent").c_str(), O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    if (!link.empty()) {
+        ASSERT_EQ(symlink(("../" + devDir.substr(TEST_ROOT.size() + 1)).c_str(), link.c_str()), 0);
+    }
+}
+
+std::string ReadUevent(const std::string &devDir)
+{
+    std::ifstream in(devDir + "/uevent");
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+}
+
+class UeventTriggerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp()
+    {
+        system(("rm -rf " + TEST_ROOT).c_str());
+        ASSERT_EQ(system(("mkdir -p " + TEST_ROOT + "/block").c_str()), 0);
+        MakeDevice(USB_DISK, TEST_ROOT + "/block/sda");
+        MakeDevice(USB_DISK + "/sda1", "");
+        MakeDevice(SD_DISK, TEST_ROOT + "/block/mmcblk1");
+        MakeDevice(LOOP_DISK, TEST_ROOT + "/block/loop0");
+    };
+    void TearDown()
+    {
+        system(("rm -rf " + TEST_ROOT).c_str());
+    };
+};
+
+/**
+ * @tc.name: UeventTriggerTest_Trigger_001
+ * @tc.desc: Verify only the entries selected by the filter get an "add" written, with symlinks resolved.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(UeventTriggerTest, UeventTriggerTest_Trigger_001, TestSize.Level1)
+{
+    std::string pattern = TEST_ROOT + "/devices/platform/*";
+    auto filter = [&pattern](const std::string &devPath, int32_t depth) -> uint32_t {
+        EXPECT_EQ(depth, 1);
+        return fnmatch(pattern.c_str(), devPath.c_str(), 0) == 0 ? WALK_TRIGGER : WALK_SKIP;
+    };
+
+    UeventWalkStats stats;
+    EXPECT_EQ(TriggerUeventTree(TEST_ROOT + "/block", filter, 4, stats), E_OK);
+    EXPECT_EQ(stats.visited, 3);
+    EXPECT_EQ(stats.triggered, 2);
+    EXPECT_EQ(stats.failed, 0);
+    EXPECT_EQ(ReadUevent(USB_DISK), "add\n");
+    EXPECT_EQ(ReadUevent(SD_DISK), "add\n");
+    EXPECT_EQ(ReadUevent(LOOP_DISK), "");
+    EXPECT_EQ(ReadUevent(USB_DISK + "/sda1"), "");
+}
+
+/**
+ * @tc.name: UeventTriggerTest_Trigger_002
+ * @tc.desc: Verify descending walks nested directories and a missing root is reported.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(UeventTriggerTest, UeventTriggerTest_Trigger_002, TestSize.Level1)
+{
+    std::string usbPath = USB_DISK;
+    auto filter = [&usbPath](const std::string &devPath, int32_t depth) -> uint32_t {
+        if (devPath == usbPath) {
+            return WALK_DESCEND;
+        }
+        return (depth == 2 && devPath == usbPath + "/sda1") ? WALK_TRIGGER : WALK_SKIP;
+    };
+
+    UeventWalkStats stats;
+    EXPECT_EQ(TriggerUeventTree(TEST_ROOT + "/block", filter, 1, stats), E_OK);
+    EXPECT_EQ(stats.triggered, 1);
+    EXPECT_EQ(ReadUevent(USB_DISK + "/sda1"), "add\n");
+    EXPECT_EQ(ReadUevent(USB_DISK), "");
+
+    EXPECT_EQ(TriggerUeventTree(TEST_ROOT + "/missing", filter, 1, stats), E_ERR);
+}
+} // namespace StorageDaemon
+} // namespace OHOS
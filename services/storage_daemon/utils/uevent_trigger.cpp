@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/uevent_trigger.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr size_t DIRENT_BUF_SIZE = 16 * 1024;
+constexpr char UEVENT_ADD[] = "add\n";
+constexpr char SYS_PREFIX[] = "/sys";
+
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+class DirFd {
+public:
+    explicit DirFd(int32_t fd) : fd_(fd) {}
+    ~DirFd()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+    int32_t Get() const
+    {
+        return fd_;
+    }
+
+private:
+    int32_t fd_;
+};
+
+struct WalkItem {
+    std::shared_ptr<DirFd> parent;
+    std::string name;
+    std::string devPath;
+    int32_t depth;
+};
+
+/* Resolves a symlink target relative to the directory holding the link, e.g. "/block" + "../devices/x" */
+std::string ResolveLink(const std::string &dir, const char *target)
+{
+    std::string path = (target[0] == '/') ? "" : dir;
+    const char *p = target;
+    while (*p != '\0') {
+        const char *slash = strchr(p, '/');
+        size_t len = (slash == nullptr) ? strlen(p) : static_cast<size_t>(slash - p);
+        if (len == strlen("..") && strncmp(p, "..", len) == 0) {
+            size_t pos = path.rfind('/');
+            path.erase((pos == std::string::npos) ? 0 : pos);
+        } else if (len > 0 && !(len == 1 && *p == '.')) {
+            path.append("/").append(p, len);
+        }
+        p += len + ((slash == nullptr) ? 0 : 1);
+    }
+    return path;
+}
+
+class UeventWalker {
+public:
+    explicit UeventWalker(const UeventWalkFilter &filter) : filter_(filter) {}
+
+    void Collect(UeventWalkStats &stats) const
+    {
+        stats.visited = visited_.load();
+        stats.triggered = triggered_.load();
+        stats.failed = failed_.load();
+    }
+
+    void Push(WalkItem item)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        queue_.push_back(std::move(item));
+        pending_++;
+        cond_.notify_one();
+    }
+
+    void Work()
+    {
+        while (true) {
+            WalkItem item;
+            {
+                std::unique_lock<std::mutex> lock(lock_);
+                cond_.wait(lock, [this] { return !queue_.empty() || pending_ == 0; });
+                if (queue_.empty()) {
+                    return;
+                }
+                item = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            Visit(item);
+            std::lock_guard<std::mutex> lock(lock_);
+            if (--pending_ == 0) {
+                cond_.notify_all();
+            }
+        }
+    }
+
+    void ListDir(const std::shared_ptr<DirFd> &dir, const std::string &devPath, int32_t depth)
+    {
+        std::vector<char> buf(DIRENT_BUF_SIZE);
+        while (true) {
+            long n = syscall(SYS_getdents64, dir->Get(), buf.data(), buf.size());
+            if (n <= 0) {
+                if (n < 0) {
+                    LOGE("getdents64 %{public}s failed, errno %{public}d", devPath.c_str(), errno);
+                }
+                return;
+            }
+            for (long off = 0; off < n;) {
+                auto ent = reinterpret_cast<LinuxDirent64 *>(buf.data() + off);
+                off += ent->d_reclen;
+                if (ent->d_name[0] == '.' || (ent->d_type != DT_DIR && ent->d_type != DT_LNK)) {
+                    continue;
+                }
+                std::string childPath;
+                if (ent->d_type == DT_LNK) {
+                    char target[PATH_MAX] = { 0 };
+                    if (readlinkat(dir->Get(), ent->d_name, target, sizeof(target) - 1) <= 0) {
+                        continue;
+                    }
+                    childPath = ResolveLink(devPath, target);
+                } else {
+                    childPath = devPath + "/" + ent->d_name;
+                }
+                Push({ dir, ent->d_name, std::move(childPath), depth + 1 });
+            }
+        }
+    }
+
+private:
+    void Visit(const WalkItem &item)
+    {
+        visited_++;
+        uint32_t action = filter_(item.devPath, item.depth);
+        if (action & WALK_TRIGGER) {
+            std::string uevent = item.name + "/uevent";
+            int32_t fd = openat(item.parent->Get(), uevent.c_str(), O_WRONLY | O_CLOEXEC);
+            if (fd >= 0 && write(fd, UEVENT_ADD, strlen(UEVENT_ADD)) == static_cast<ssize_t>(strlen(UEVENT_ADD))) {
+                triggered_++;
+            } else {
+                failed_++;
+            }
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        if (action & WALK_DESCEND) {
+            int32_t fd = openat(item.parent->Get(), item.name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd >= 0) {
+                ListDir(std::make_shared<DirFd>(fd), item.devPath, item.depth);
+            }
+        }
+    }
+
+    const UeventWalkFilter &filter_;
+    std::mutex lock_;
+    std::condition_variable cond_;
+    std::deque<WalkItem> queue_;
+    uint32_t pending_ { 0 };
+    std::atomic<uint32_t> visited_ { 0 };
+    std::atomic<uint32_t> triggered_ { 0 };
+    std::atomic<uint32_t> failed_ { 0 };
+};
+} // namespace
+
+int32_t TriggerUeventTree(const std::string &root, const UeventWalkFilter &filter, uint32_t threads,
+    UeventWalkStats &stats)
+{
+    auto start = std::chrono::steady_clock::now();
+    int32_t fd = open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGE("Open %{public}s failed, errno %{public}d", root.c_str(), errno);
+        return E_ERR;
+    }
+
+    std::string rootPath = root;
+    if (rootPath.compare(0, strlen(SYS_PREFIX), SYS_PREFIX) == 0) {
+        rootPath.erase(0, strlen(SYS_PREFIX));
+    }
+
+    UeventWalker walker(filter);
+    walker.ListDir(std::make_shared<DirFd>(fd), rootPath, 0);
+
+    std::vector<std::thread> pool;
+    for (uint32_t i = 1; i < threads; i++) {
+        pool.emplace_back(&UeventWalker::Work, &walker);
+    }
+    walker.Work();
+    for (auto &thread : pool) {
+        thread.join();
+    }
+
+    walker.Collect(stats);
+    stats.elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return E_OK;
+}
+} // namespace StorageDaemon
+} // namespace OHOS
@@ -29,11 +29,21 @@
 #include "storage_service_errno.h"
 #include "utils/string_utils.h"
 #include "volume/process.h"
+#include "utils/chmod_walker.h"
 #include "utils/file_utils.h"
+#include "volume/fs_checker.h"
+#include "volume/fs_prober.h"
 
 using namespace std;
 namespace OHOS {
 namespace StorageDaemon {
+constexpr uint32_t CHECK_PROGRESS_STEP = 10;
+
+ExternalVolumeInfo::~ExternalVolumeInfo()
+{
+    StopChmodWalk();
+}
+
 std::string ExternalVolumeInfo::GetBlkidData(const std::string type)
 {
     std::vector<std::string> output;
@@ -63,16 +73,26 @@ std::string ExternalVolumeInfo::GetBlkidData(const std::string type)
 
 int32_t ExternalVolumeInfo::ReadMetadata()
 {
-    fsUuid_ = GetBlkidData("UUID");
-    fsType_ = GetBlkidData("TYPE");
-    fsLabel_ = GetBlkidData("LABEL");
+    FsProbeResult probe;
+    if (ProbeFilesystem(devPath_, probe) == E_OK && !probe.type.empty()) {
+        fsUuid_ = probe.uuid;
+        fsType_ = probe.type;
+        fsLabel_ = probe.label;
+        fsDirty_ = probe.dirty;
+    } else {
+        /* Formats the native prober does not know still go through blkid */
+        fsUuid_ = GetBlkidData("UUID");
+        fsType_ = GetBlkidData("TYPE");
+        fsLabel_ = GetBlkidData("LABEL");
+        fsDirty_ = true;
+    }
 
     if (fsUuid_.empty() || fsType_.empty()) {
         LOGE("External volume ReadMetadata error.");
         return E_ERR;
     }
-    LOGI("ReadMetadata, fsUuid=%{public}s, fsType=%{public}d, fsLabel=%{public}s.",
-         GetFsUuid().c_str(), GetFsType(), GetFsLabel().c_str());
+    LOGI("ReadMetadata, fsUuid=%{public}s, fsType=%{public}d, fsLabel=%{public}s, dirty=%{public}d.",
+         GetFsUuid().c_str(), GetFsType(), GetFsLabel().c_str(), fsDirty_);
     return E_OK;
 }
 
@@ -142,7 +162,9 @@ int32_t ExternalVolumeInfo::DoMount(const std::string mountPath, uint32_t mountF
     if (fsType_ == "ext2" || fsType_ == "ext3" || fsType_ == "ext4") {
         ret = mount(devPath_.c_str(), mountPath.c_str(), fsType_.c_str(), mountFlags, "");
         if (!ret) {
-            TravelChmod(mountPath, mode);
+            /* Only the root holds up the mount, the files below it are opened up in the background */
+            (void)ChMod(mountPath, mode);
+            StartChmodWalk(mountPath, mode);
         }
     } else if (fsType_ == "ntfs") {
         std::vector<std::string> cmd = {
@@ -165,8 +187,39 @@ int32_t ExternalVolumeInfo::DoMount(const std::string mountPath, uint32_t mountF
     return E_OK;
 }
 
+void ExternalVolumeInfo::StartChmodWalk(const std::string &path, mode_t mode)
+{
+    StopChmodWalk();
+    auto walker = std::make_shared<ChmodWalker>();
+    chmodWalker_ = walker;
+    chmodThread_ = std::thread([walker, path, mode] {
+        ChmodWalkStats stats;
+        if (walker->Walk(path, mode, stats) != E_OK) {
+            return;
+        }
+        LOGI("chmod walk of %{public}s: %{public}llu dirs, %{public}llu files, %{public}llu changed, "
+            "%{public}llu failed, %{public}lld ms%{public}s", path.c_str(), static_cast<unsigned long long>(stats.dirs),
+            static_cast<unsigned long long>(stats.files), static_cast<unsigned long long>(stats.changed),
+            static_cast<unsigned long long>(stats.failed), static_cast<long long>(stats.elapsedUs / 1000),
+            stats.cancelled ? ", cancelled" : "");
+    });
+}
+
+void ExternalVolumeInfo::StopChmodWalk()
+{
+    if (chmodWalker_ != nullptr) {
+        chmodWalker_->Cancel();
+    }
+    if (chmodThread_.joinable()) {
+        chmodThread_.join();
+    }
+    chmodWalker_.reset();
+}
+
 int32_t ExternalVolumeInfo::DoUMount(const std::string mountPath, bool force)
 {
+    /* The walk holds directories of the mount open */
+    StopChmodWalk();
     if (force) {
         LOGI("External volume start force to unmount.");
         Process ps(mountPath);
@@ -204,7 +257,30 @@ int32_t ExternalVolumeInfo::DoCheck()
         LOGE("External Volume type not support.");
         return E_NOT_SUPPORT;
     }
-    return E_OK;
+
+    /* Clean media mount straight away, only a dirty volume pays for a full check */
+    if (!fsDirty_) {
+        LOGI("External volume %{public}s is clean, check skipped.", GetVolumeId().c_str());
+        return E_OK;
+    }
+    std::string volId = GetVolumeId();
+    uint32_t logged = 0;
+    ret = CheckFilesystem(devPath_, fsType_, [&volId, &logged](uint32_t percent) {
+        if (percent == 0 || percent >= logged + CHECK_PROGRESS_STEP) {
+            logged = percent;
+            LOGI("External volume %{public}s check %{public}u%%.", volId.c_str(), percent);
+        }
+    });
+    if (ret == E_NOT_SUPPORT) {
+        LOGI("External volume %{public}s is dirty but has no checker, mount as is.", volId.c_str());
+        return E_OK;
+    }
+    if (ret != E_OK) {
+        LOGE("External volume %{public}s check failed.", volId.c_str());
+        return E_ERR;
+    }
+    /* The checker clears the flags and may fix up the label */
+    return ReadMetadata() == E_OK ? E_OK : E_ERR;
 }
 
 int32_t ExternalVolumeInfo::DoFormat(std::string type)
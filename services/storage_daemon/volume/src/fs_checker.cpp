@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "volume/fs_checker.h"
+
+#include <cerrno>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr int32_t E2FSCK_CORRECTED = 1;
+constexpr int32_t E2FSCK_REBOOT = 2;
+constexpr int32_t FSCK_CORRECTED = 1;
+constexpr int32_t FSCK_MSDOS_MODIFIED = 4;
+constexpr uint32_t E2FSCK_PASSES = 5;
+/* Share of the run done when each pass ends, the weights e2fsck uses for its own bar */
+constexpr uint32_t E2FSCK_PASS_PERCENT[E2FSCK_PASSES + 1] = { 0, 70, 90, 92, 95, 100 };
+constexpr size_t READ_CHUNK = 512;
+
+/* Maps the exit status of a checker to E_OK or E_ERR, E_NOT_SUPPORT when it is not installed */
+int32_t CheckResult(const std::string &name, int32_t status, bool ok)
+{
+    if (status == FS_CHECKER_MISSING) {
+        LOGE("%{public}s is not available", name.c_str());
+        return E_NOT_SUPPORT;
+    }
+    if (status < 0 || !ok) {
+        LOGE("%{public}s failed, status %{public}d", name.c_str(), status);
+        return E_ERR;
+    }
+    LOGI("%{public}s done, status %{public}d", name.c_str(), status);
+    return E_OK;
+}
+
+int32_t CheckExt(const std::string &devPath, const FsCheckProgress &progress)
+{
+    std::vector<std::string> cmd = { "e2fsck", "-y", "-C", "1", devPath };
+    uint32_t last = 0;
+    int32_t status = RunChecker(cmd, [&progress, &last](const std::string &line) {
+        uint32_t percent = 0;
+        if (!ParseE2fsckProgress(line, percent)) {
+            LOGI("e2fsck: %{public}s", line.c_str());
+        } else if (percent > last) {
+            last = percent;
+            progress(percent);
+        }
+    });
+    return CheckResult("e2fsck", status, status >= 0 && (status & ~(E2FSCK_CORRECTED | E2FSCK_REBOOT)) == 0);
+}
+
+int32_t CheckExfat(const std::string &devPath)
+{
+    std::vector<std::string> cmd = { "fsck.exfat", "-y", devPath };
+    int32_t status = RunChecker(cmd, [](const std::string &line) { LOGI("fsck.exfat: %{public}s", line.c_str()); });
+    return CheckResult("fsck.exfat", status, status == E_OK || status == FSCK_CORRECTED);
+}
+
+int32_t CheckVfat(const std::string &devPath)
+{
+    std::vector<std::string> cmd = { "fsck_msdos", "-p", "-f", "-y", devPath };
+    int32_t status = E_ERR;
+    /* A run that repaired something is repeated until one finds the volume clean */
+    for (int32_t run = 0; run <= FS_CHECK_VFAT_RECHECKS; run++) {
+        status = RunChecker(cmd, [](const std::string &line) { LOGI("fsck_msdos: %{public}s", line.c_str()); });
+        if (status != FSCK_MSDOS_MODIFIED) {
+            break;
+        }
+        LOGI("fsck_msdos modified the volume, rechecking");
+    }
+    return CheckResult("fsck_msdos", status, status == E_OK);
+}
+} // namespace
+
+int32_t RunChecker(const std::vector<std::string> &cmd, const std::function<void(const std::string &)> &onLine)
+{
+    if (cmd.empty()) {
+        return E_ERR;
+    }
+    std::vector<char *> argv;
+    for (auto &arg : cmd) {
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    int pipeFd[2];
+    if (pipe2(pipeFd, O_CLOEXEC) != 0) {
+        LOGE("create pipe failed, errno %{public}d", errno);
+        return E_ERR;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        LOGE("fork failed, errno %{public}d", errno);
+        (void)close(pipeFd[0]);
+        (void)close(pipeFd[1]);
+        return E_ERR;
+    }
+    if (pid == 0) {
+        if (dup2(pipeFd[1], STDOUT_FILENO) < 0) {
+            _exit(FS_CHECKER_MISSING);
+        }
+        execvp(argv[0], argv.data());
+        _exit(FS_CHECKER_MISSING);
+    }
+    (void)close(pipeFd[1]);
+
+    std::string pending;
+    char buf[READ_CHUNK];
+    ssize_t n;
+    while ((n = TEMP_FAILURE_RETRY(read(pipeFd[0], buf, sizeof(buf)))) > 0) {
+        pending.append(buf, static_cast<size_t>(n));
+        size_t start = 0;
+        for (size_t end = pending.find('\n'); end != std::string::npos; end = pending.find('\n', start)) {
+            if (end > start) {
+                onLine(pending.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        pending.erase(0, start);
+    }
+    if (!pending.empty()) {
+        onLine(pending);
+    }
+    (void)close(pipeFd[0]);
+
+    int status = 0;
+    if (TEMP_FAILURE_RETRY(waitpid(pid, &status, 0)) != pid || !WIFEXITED(status)) {
+        LOGE("%{public}s exits abnormally", cmd[0].c_str());
+        return E_ERR;
+    }
+    return WEXITSTATUS(status);
+}
+
+bool ParseE2fsckProgress(const std::string &line, uint32_t &percent)
+{
+    uint32_t pass = 0;
+    unsigned long long current = 0;
+    unsigned long long max = 0;
+    if (sscanf(line.c_str(), "%u %llu %llu", &pass, &current, &max) != 3 || pass == 0 || pass > E2FSCK_PASSES ||
+        max == 0 || current > max) {
+        return false;
+    }
+    uint32_t begin = E2FSCK_PASS_PERCENT[pass - 1];
+    uint32_t span = E2FSCK_PASS_PERCENT[pass] - begin;
+    percent = begin + static_cast<uint32_t>(span * current / max);
+    return true;
+}
+
+int32_t CheckFilesystem(const std::string &devPath, const std::string &type, const FsCheckProgress &progress)
+{
+    auto report = [&progress](uint32_t percent) {
+        if (progress != nullptr) {
+            progress(percent);
+        }
+    };
+
+    bool ext = type == "ext2" || type == "ext3" || type == "ext4";
+    if (!ext && type != "exfat" && type != "vfat") {
+        return E_NOT_SUPPORT;
+    }
+    report(0);
+    int32_t ret = ext ? CheckExt(devPath, report) : (type == "exfat" ? CheckExfat(devPath) : CheckVfat(devPath));
+    if (ret == E_OK) {
+        report(100);
+    }
+    return ret;
+}
+} // STORAGE_DAEMON
+} // OHOS
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "volume/fs_prober.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+#include "utils/string_utils.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr size_t SB_OFFSET = 1024;
+constexpr uint16_t EXT_MAGIC = 0xEF53;
+constexpr size_t EXT_LABEL_LEN = 16;
+constexpr uint32_t EXT_COMPAT_HAS_JOURNAL = 0x0004;
+constexpr uint32_t EXT_INCOMPAT_RECOVER = 0x0004;
+constexpr uint32_t EXT_INCOMPAT_JOURNAL_DEV = 0x0008;
+constexpr uint16_t EXT_STATE_VALID = 0x0001;
+constexpr uint16_t EXT_STATE_ERROR = 0x0002;
+/* Feature sets an ext2 or ext3 driver mounts, anything beyond them makes it ext4, as blkid decides */
+constexpr uint32_t EXT2_INCOMPAT_SUPP = 0x0012;
+constexpr uint32_t EXT3_INCOMPAT_SUPP = 0x0016;
+constexpr uint32_t EXT3_RO_COMPAT_SUPP = 0x0007;
+constexpr uint32_t F2FS_MAGIC = 0xF2F52010;
+constexpr size_t F2FS_LABEL_UNITS = 512;
+constexpr uint32_t NTFS_VOLUME_RECORD = 3;
+constexpr uint32_t NTFS_ATTR_VOLUME_NAME = 0x60;
+constexpr uint32_t NTFS_ATTR_VOLUME_INFORMATION = 0x70;
+constexpr uint16_t NTFS_VOLUME_DIRTY = 0x0001;
+constexpr uint32_t NTFS_ATTR_END = 0xFFFFFFFF;
+constexpr size_t NTFS_FIXUP_STRIDE = 512;
+constexpr uint8_t EXFAT_ENTRY_LABEL = 0x83;
+constexpr size_t EXFAT_LABEL_UNITS = 11;
+constexpr uint16_t EXFAT_VOLUME_DIRTY = 0x0002;
+constexpr uint16_t EXFAT_MEDIA_FAILURE = 0x0004;
+constexpr uint8_t FAT_ATTR_VOLUME_ID = 0x08;
+constexpr uint8_t FAT_ATTR_LFN = 0x0F;
+constexpr uint8_t FAT_ENTRY_DELETED = 0xE5;
+constexpr size_t DIR_ENTRY_SIZE = 32;
+constexpr size_t FAT_LABEL_LEN = 11;
+constexpr uint32_t FAT12_MAX_CLUSTERS = 4084;
+/* The state byte of the extended boot record, set by Linux while mounted */
+constexpr uint8_t FAT_STATE_DIRTY = 0x01;
+/* Shutdown and no I/O error bits in FAT[1], cleared while mounted or after an error */
+constexpr uint16_t FAT16_CLEAN_BITS = 0xC000;
+constexpr uint32_t FAT32_CLEAN_BITS = 0x0C000000;
+/* Bound on the extra read for a root directory or MFT record */
+constexpr size_t LABEL_READ_MAX = 32 * 1024;
+
+uint16_t Le16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t Le32(const uint8_t *p)
+{
+    return static_cast<uint32_t>(Le16(p)) | (static_cast<uint32_t>(Le16(p + 2)) << 16);
+}
+
+uint64_t Le64(const uint8_t *p)
+{
+    return static_cast<uint64_t>(Le32(p)) | (static_cast<uint64_t>(Le32(p + 4)) << 32);
+}
+
+bool IsPowerOfTwo(uint64_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+/* Stops at the first NUL, unpaired surrogates become U+FFFD */
+std::string Utf16LeToUtf8(const uint8_t *data, size_t units)
+{
+    std::string out;
+    for (size_t i = 0; i < units; i++) {
+        uint32_t cp = Le16(data + i * 2);
+        if (cp == 0) {
+            break;
+        }
+        if (cp >= 0xD800 && cp < 0xDC00 && i + 1 < units) {
+            uint32_t low = Le16(data + (i + 1) * 2);
+            if (low >= 0xDC00 && low < 0xE000) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+        if (cp >= 0xD800 && cp < 0xE000) {
+            cp = 0xFFFD;
+        }
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+    return out;
+}
+
+/* Fixed width label, cut at the first NUL and stripped of the space padding */
+std::string FixedLabel(const uint8_t *data, size_t len)
+{
+    std::string label(reinterpret_cast<const char *>(data), strnlen(reinterpret_cast<const char *>(data), len));
+    label.erase(label.find_last_not_of(' ') + 1);
+    return label;
+}
+
+std::string GuidUuid(const uint8_t *p)
+{
+    return StringPrintf("%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x", p[0], p[1], p[2],
+        p[3], p[4], p[5], p[6], p[7], p[8], p[9], p[10], p[11], p[12], p[13], p[14], p[15]);
+}
+
+std::string SerialUuid(uint32_t serial)
+{
+    return StringPrintf("%04X-%04X", serial >> 16, serial & 0xFFFF);
+}
+
+bool ProbeExt(const std::vector<uint8_t> &head, FsProbeResult &result)
+{
+    const uint8_t *sb = head.data() + SB_OFFSET;
+    if (Le16(sb + 0x38) != EXT_MAGIC) {
+        return false;
+    }
+    uint32_t compat = Le32(sb + 0x5C);
+    uint32_t incompat = Le32(sb + 0x60);
+    uint32_t roCompat = Le32(sb + 0x64);
+    if (incompat & EXT_INCOMPAT_JOURNAL_DEV) {
+        return false;
+    }
+
+    if ((roCompat & ~EXT3_RO_COMPAT_SUPP) != 0) {
+        result.type = "ext4";
+    } else if (compat & EXT_COMPAT_HAS_JOURNAL) {
+        result.type = (incompat & ~EXT3_INCOMPAT_SUPP) != 0 ? "ext4" : "ext3";
+    } else {
+        result.type = (incompat & ~EXT2_INCOMPAT_SUPP) != 0 ? "ext4" : "ext2";
+    }
+    result.uuid = GuidUuid(sb + 0x68);
+    result.label = FixedLabel(sb + 0x78, EXT_LABEL_LEN);
+    /* A journal still to be replayed means the volume went away while mounted */
+    uint16_t state = Le16(sb + 0x3A);
+    result.dirty = (state & EXT_STATE_VALID) == 0 || (state & EXT_STATE_ERROR) != 0 ||
+        (incompat & EXT_INCOMPAT_RECOVER) != 0;
+    return true;
+}
+
+bool ProbeF2fs(const std::vector<uint8_t> &head, FsProbeResult &result)
+{
+    const uint8_t *sb = head.data() + SB_OFFSET;
+    if (Le32(sb) != F2FS_MAGIC) {
+        return false;
+    }
+    result.type = "f2fs";
+    result.uuid = GuidUuid(sb + 0x6C);
+    result.label = Utf16LeToUtf8(sb + 0x7C, F2FS_LABEL_UNITS);
+    return true;
+}
+
+bool ProbeExfat(const FsProbeReader &reader, const std::vector<uint8_t> &head, FsProbeResult &result)
+{
+    if (memcmp(head.data() + 3, "EXFAT   ", 8) != 0) {
+        return false;
+    }
+    result.type = "exfat";
+    result.uuid = SerialUuid(Le32(head.data() + 0x64));
+    result.dirty = (Le16(head.data() + 0x6A) & (EXFAT_VOLUME_DIRTY | EXFAT_MEDIA_FAILURE)) != 0;
+
+    /* The label is an entry of the root directory, look through its first cluster */
+    uint32_t sectorShift = head[0x6C];
+    uint32_t clusterShift = sectorShift + head[0x6D];
+    uint64_t heapOffset = Le32(head.data() + 0x58);
+    uint64_t rootCluster = Le32(head.data() + 0x60);
+    if (sectorShift < 9 || sectorShift > 12 || clusterShift > 25 || rootCluster < 2) {
+        return true;
+    }
+    uint64_t offset = (heapOffset << sectorShift) + ((rootCluster - 2) << clusterShift);
+    std::vector<uint8_t> dir;
+    if (!reader(offset, std::min<size_t>(LABEL_READ_MAX, 1ULL << clusterShift), dir)) {
+        return true;
+    }
+    for (size_t pos = 0; pos + DIR_ENTRY_SIZE <= dir.size() && dir[pos] != 0; pos += DIR_ENTRY_SIZE) {
+        if (dir[pos] == EXFAT_ENTRY_LABEL) {
+            result.label = Utf16LeToUtf8(dir.data() + pos + 2, std::min<size_t>(dir[pos + 1], EXFAT_LABEL_UNITS));
+            break;
+        }
+    }
+    return true;
+}
+
+/* Puts back the sector tails the update sequence array replaced, false on a torn record */
+bool ApplyNtfsFixups(std::vector<uint8_t> &record)
+{
+    size_t usaOffset = Le16(record.data() + 4);
+    size_t usaCount = Le16(record.data() + 6);
+    if (usaCount == 0 || usaOffset + usaCount * 2 > record.size() || (usaCount - 1) * NTFS_FIXUP_STRIDE >
+        record.size()) {
+        return false;
+    }
+    const uint8_t *usa = record.data() + usaOffset;
+    for (size_t i = 1; i < usaCount; i++) {
+        uint8_t *tail = record.data() + i * NTFS_FIXUP_STRIDE - 2;
+        if (Le16(tail) != Le16(usa)) {
+            return false;
+        }
+        tail[0] = usa[i * 2];
+        tail[1] = usa[i * 2 + 1];
+    }
+    return true;
+}
+
+bool ProbeNtfs(const FsProbeReader &reader, const std::vector<uint8_t> &head, FsProbeResult &result)
+{
+    if (memcmp(head.data() + 3, "NTFS    ", 8) != 0) {
+        return false;
+    }
+    uint32_t sectorSize = Le16(head.data() + 0x0B);
+    uint32_t sectorsPerCluster = head[0x0D];
+    if (sectorsPerCluster > 0x80) {
+        /* Clusters above 64 KiB store a negative shift */
+        uint32_t shift = 256 - sectorsPerCluster;
+        sectorsPerCluster = shift <= 12 ? 1U << shift : 0;
+    }
+    if (!IsPowerOfTwo(sectorSize) || sectorSize < 256 || sectorSize > 4096 || !IsPowerOfTwo(sectorsPerCluster)) {
+        return false;
+    }
+    result.type = "ntfs";
+    result.uuid = StringPrintf("%016llX", static_cast<unsigned long long>(Le64(head.data() + 0x48)));
+
+    /* The label and the dirty flag are attributes of the $Volume record in the MFT */
+    uint64_t clusterSize = static_cast<uint64_t>(sectorSize) * sectorsPerCluster;
+    int8_t recordClusters = static_cast<int8_t>(head[0x40]);
+    uint64_t recordSize = recordClusters > 0 ? recordClusters * clusterSize :
+        (recordClusters > -32 && recordClusters < 0 ? 1ULL << -recordClusters : 0);
+    uint64_t mftCluster = Le64(head.data() + 0x30);
+    if (recordSize < NTFS_FIXUP_STRIDE || recordSize > LABEL_READ_MAX || mftCluster > (UINT64_MAX >> 32)) {
+        return true;
+    }
+    std::vector<uint8_t> record;
+    if (!reader(mftCluster * clusterSize + NTFS_VOLUME_RECORD * recordSize, recordSize, record) ||
+        record.size() != recordSize || memcmp(record.data(), "FILE", 4) != 0 || !ApplyNtfsFixups(record)) {
+        return true;
+    }
+    for (size_t pos = Le16(record.data() + 0x14); pos + 24 <= record.size();) {
+        uint32_t type = Le32(record.data() + pos);
+        uint32_t length = Le32(record.data() + pos + 4);
+        if (type == NTFS_ATTR_END || length < 24 || length > record.size() - pos) {
+            break;
+        }
+        uint32_t valueLength = Le32(record.data() + pos + 16);
+        uint32_t valueOffset = Le16(record.data() + pos + 20);
+        bool resident = record[pos + 8] == 0 && valueOffset <= length && valueLength <= length - valueOffset;
+        if (type == NTFS_ATTR_VOLUME_NAME && resident) {
+            result.label = Utf16LeToUtf8(record.data() + pos + valueOffset, valueLength / 2);
+        } else if (type == NTFS_ATTR_VOLUME_INFORMATION && resident && valueLength >= 12) {
+            /* Eight reserved bytes and the version come before the flags */
+            result.dirty = (Le16(record.data() + pos + valueOffset + 10) & NTFS_VOLUME_DIRTY) != 0;
+            break;
+        }
+        pos += length;
+    }
+    return true;
+}
+
+/* The volume id entry of a FAT root directory, empty if there is none */
+std::string ReadFatRootLabel(const FsProbeReader &reader, uint64_t offset, size_t length)
+{
+    std::vector<uint8_t> dir;
+    if (length == 0 || !reader(offset, std::min(length, LABEL_READ_MAX), dir)) {
+        return "";
+    }
+    for (size_t pos = 0; pos + DIR_ENTRY_SIZE <= dir.size() && dir[pos] != 0; pos += DIR_ENTRY_SIZE) {
+        uint8_t attr = dir[pos + 11];
+        if (dir[pos] == FAT_ENTRY_DELETED || (attr & FAT_ATTR_LFN) == FAT_ATTR_LFN) {
+            continue;
+        }
+        if (attr & FAT_ATTR_VOLUME_ID) {
+            return FixedLabel(dir.data() + pos, FAT_LABEL_LEN);
+        }
+    }
+    return "";
+}
+
+/* Linux marks the boot sector while mounted, Windows clears the shutdown bits in FAT[1] */
+bool IsFatDirty(const FsProbeReader &reader, const uint8_t *bs, const uint8_t *ext, bool fat32, uint32_t fatSize)
+{
+    if (ext[1] & FAT_STATE_DIRTY) {
+        return true;
+    }
+    uint32_t sectorSize = Le16(bs + 0x0B);
+    uint64_t reserved = Le16(bs + 0x0E);
+    if (!fat32) {
+        uint64_t totalSectors = Le16(bs + 0x13) != 0 ? Le16(bs + 0x13) : Le32(bs + 0x20);
+        uint64_t rootSectors = (Le16(bs + 0x11) * DIR_ENTRY_SIZE + sectorSize - 1) / sectorSize;
+        uint64_t metaSectors = reserved + static_cast<uint64_t>(bs[0x10]) * fatSize + rootSectors;
+        if (totalSectors <= metaSectors || (totalSectors - metaSectors) / bs[0x0D] <= FAT12_MAX_CLUSTERS) {
+            /* FAT12 has no room for the bits */
+            return false;
+        }
+    }
+
+    std::vector<uint8_t> fat;
+    if (!reader(reserved * sectorSize, sectorSize, fat) || fat.size() < sizeof(uint64_t)) {
+        return false;
+    }
+    if (fat32) {
+        return (Le32(fat.data() + 4) & FAT32_CLEAN_BITS) != FAT32_CLEAN_BITS;
+    }
+    return (Le16(fat.data() + 2) & FAT16_CLEAN_BITS) != FAT16_CLEAN_BITS;
+}
+
+bool ProbeVfat(const FsProbeReader &reader, const std::vector<uint8_t> &head, FsProbeResult &result)
+{
+    const uint8_t *bs = head.data();
+    uint32_t sectorSize = Le16(bs + 0x0B);
+    uint32_t sectorsPerCluster = bs[0x0D];
+    uint32_t reserved = Le16(bs + 0x0E);
+    uint32_t fats = bs[0x10];
+    uint8_t media = bs[0x15];
+    if ((bs[0] != 0xEB && bs[0] != 0xE9) || Le16(bs + 0x1FE) != 0xAA55 || !IsPowerOfTwo(sectorSize) ||
+        sectorSize < 512 || sectorSize > 4096 || !IsPowerOfTwo(sectorsPerCluster) || reserved == 0 || fats == 0 ||
+        (media != 0xF0 && media < 0xF8)) {
+        return false;
+    }
+
+    uint32_t fatSize = Le16(bs + 0x16);
+    bool fat32 = fatSize == 0;
+    /* The extended BPB, with serial and label, follows the FAT32 specific fields */
+    const uint8_t *ext = bs + (fat32 ? 0x40 : 0x24);
+    uint64_t rootOffset = 0;
+    size_t rootLength = 0;
+    if (fat32) {
+        fatSize = Le32(bs + 0x24);
+        uint64_t rootCluster = Le32(bs + 0x2C);
+        if (rootCluster >= 2) {
+            rootOffset = (reserved + static_cast<uint64_t>(fats) * fatSize + (rootCluster - 2) * sectorsPerCluster) *
+                sectorSize;
+            rootLength = static_cast<size_t>(sectorsPerCluster) * sectorSize;
+        }
+    } else {
+        rootOffset = (reserved + static_cast<uint64_t>(fats) * fatSize) * sectorSize;
+        rootLength = static_cast<size_t>(Le16(bs + 0x11)) * DIR_ENTRY_SIZE;
+    }
+
+    result.type = "vfat";
+    uint8_t signature = ext[2];
+    if (signature == 0x28 || signature == 0x29) {
+        result.uuid = SerialUuid(Le32(ext + 3));
+    }
+    /* Like blkid, only the root directory entry counts, tools that relabel leave the boot sector copy stale */
+    result.label = ReadFatRootLabel(reader, rootOffset, rootLength);
+    if (result.label == "NO NAME") {
+        result.label.clear();
+    }
+    result.dirty = IsFatDirty(reader, bs, ext, fat32, fatSize);
+    return true;
+}
+} // namespace
+
+int32_t ProbeFilesystem(const FsProbeReader &reader, FsProbeResult &result)
+{
+    result = FsProbeResult();
+    std::vector<uint8_t> head;
+    if (!reader(0, FS_PROBE_HEAD_BYTES, head) || head.size() < FS_PROBE_HEAD_BYTES) {
+        return E_ERR;
+    }
+
+    /* Exact signatures first, FAT has the loosest one and goes last */
+    if (ProbeExfat(reader, head, result) || ProbeNtfs(reader, head, result) || ProbeExt(head, result) ||
+        ProbeF2fs(head, result) || ProbeVfat(reader, head, result)) {
+        return E_OK;
+    }
+    result = FsProbeResult();
+    return E_OK;
+}
+
+int32_t ProbeFilesystem(const std::string &devPath, FsProbeResult &result)
+{
+    int32_t fd = TEMP_FAILURE_RETRY(open(devPath.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0) {
+        LOGE("Open %{private}s failed, errno %{public}d", devPath.c_str(), errno);
+        return E_ERR;
+    }
+
+    auto reader = [fd](uint64_t offset, size_t length, std::vector<uint8_t> &buf) {
+        buf.resize(length);
+        size_t done = 0;
+        while (done < length) {
+            ssize_t n = TEMP_FAILURE_RETRY(pread(fd, buf.data() + done, length - done, offset + done));
+            if (n <= 0) {
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    };
+    int32_t ret = ProbeFilesystem(reader, result);
+    (void)close(fd);
+    return ret;
+}
+} // STORAGE_DAEMON
+} // OHOS
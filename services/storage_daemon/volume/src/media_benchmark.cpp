@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "volume/media_benchmark.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+#include "storage_service_log.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+namespace {
+constexpr uint32_t PHASE_COUNT = 4;
+constexpr size_t BUFFER_ALIGN = 4096;
+constexpr double BYTES_PER_MB = 1000000.0;
+constexpr uint64_t RANDOM_SEED = 0x5eed;
+
+struct SpeedClass {
+    const char *name;
+    double seqWriteMBps;
+    double randReadIops;
+    double randWriteIops;
+};
+
+/* Minimum figures of the SD Association classes, strongest first within a family */
+const std::vector<std::vector<SpeedClass>> SPEED_CLASSES = {
+    { { "C10", 10, 0, 0 }, { "C6", 6, 0, 0 }, { "C4", 4, 0, 0 }, { "C2", 2, 0, 0 } },
+    { { "U3", 30, 0, 0 }, { "U1", 10, 0, 0 } },
+    { { "V90", 90, 0, 0 }, { "V60", 60, 0, 0 }, { "V30", 30, 0, 0 }, { "V10", 10, 0, 0 }, { "V6", 6, 0, 0 } },
+    { { "A2", 10, 4000, 2000 }, { "A1", 10, 1500, 500 } },
+};
+
+struct FreeDeleter {
+    void operator()(char *p) const
+    {
+        free(p);
+    }
+};
+
+double PerSecond(double value, double seconds)
+{
+    return seconds > 0 ? value / seconds : 0;
+}
+}
+
+MediaBenchmark::MediaBenchmark(const std::string &dir, const MediaBenchmarkOptions &options)
+    : dir_(dir), options_(options)
+{
+    options_.budget = std::min(options_.budget, MEDIA_BENCHMARK_MAX_BUDGET);
+}
+
+void MediaBenchmark::Cancel()
+{
+    cancelled_ = true;
+}
+
+MediaBenchmark::Clock::time_point MediaBenchmark::PhaseDeadline(const Clock::time_point &start) const
+{
+    return start + options_.budget / PHASE_COUNT;
+}
+
+int32_t MediaBenchmark::OpenTestFile(const char *buf, int32_t &fd, bool &direct)
+{
+    std::string path = dir_ + "/.media_benchmark_XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    int32_t tmp = mkstemp(name.data());
+    if (tmp < 0) {
+        LOGE("create test file in %{public}s failed, errno %{public}d", dir_.c_str(), errno);
+        return E_ERR;
+    }
+    close(tmp);
+
+    /* Some filesystems accept O_DIRECT on open and only fail the first aligned write */
+    direct = true;
+    fd = open(name.data(), O_RDWR | O_DIRECT | O_CLOEXEC);
+    if (fd >= 0 && TEMP_FAILURE_RETRY(pwrite(fd, buf, BUFFER_ALIGN, 0)) != static_cast<ssize_t>(BUFFER_ALIGN)) {
+        close(fd);
+        fd = -1;
+    }
+    if (fd < 0) {
+        direct = false;
+        fd = open(name.data(), O_RDWR | O_DSYNC | O_CLOEXEC);
+    }
+    unlink(name.data());
+    if (fd < 0) {
+        LOGE("open test file in %{public}s failed, errno %{public}d", dir_.c_str(), errno);
+        return E_ERR;
+    }
+    return E_OK;
+}
+
+int32_t MediaBenchmark::Sequential(int32_t fd, bool write, uint64_t size, char *buf, Phase &phase)
+{
+    uint32_t blockSize = options_.seqBlockSize;
+    if (!write) {
+        (void)posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+
+    auto start = Clock::now();
+    auto deadline = PhaseDeadline(start);
+    for (uint64_t off = 0; off + blockSize <= size && !cancelled_ && Clock::now() < deadline; off += blockSize) {
+        ssize_t len = write ? TEMP_FAILURE_RETRY(pwrite(fd, buf, blockSize, off)) :
+            TEMP_FAILURE_RETRY(pread(fd, buf, blockSize, off));
+        if (len != static_cast<ssize_t>(blockSize)) {
+            LOGE("sequential %{public}s at %{public}llu failed, errno %{public}d", write ? "write" : "read",
+                static_cast<unsigned long long>(off), errno);
+            return E_ERR;
+        }
+        phase.ops++;
+        phase.bytes += blockSize;
+    }
+    phase.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return E_OK;
+}
+
+int32_t MediaBenchmark::Random(int32_t fd, bool write, uint64_t span, char *buf, Phase &phase)
+{
+    uint32_t blockSize = options_.randBlockSize;
+    uint64_t blocks = span / blockSize;
+    if (blocks == 0) {
+        return E_OK;
+    }
+    if (!write) {
+        (void)posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+
+    std::mt19937_64 rng(RANDOM_SEED);
+    auto start = Clock::now();
+    auto deadline = PhaseDeadline(start);
+    while (!cancelled_ && Clock::now() < deadline) {
+        off_t off = static_cast<off_t>(rng() % blocks * blockSize);
+        ssize_t len = write ? TEMP_FAILURE_RETRY(pwrite(fd, buf, blockSize, off)) :
+            TEMP_FAILURE_RETRY(pread(fd, buf, blockSize, off));
+        if (len != static_cast<ssize_t>(blockSize)) {
+            LOGE("random %{public}s at %{public}lld failed, errno %{public}d", write ? "write" : "read",
+                static_cast<long long>(off), errno);
+            return E_ERR;
+        }
+        phase.ops++;
+        phase.bytes += blockSize;
+    }
+    phase.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return E_OK;
+}
+
+int32_t MediaBenchmark::Run(StorageManager::MediaBenchmarkResult &result)
+{
+    if (cancelled_) {
+        result.cancelled_ = true;
+        return E_OK;
+    }
+    auto start = Clock::now();
+    struct statvfs vfs;
+    if (statvfs(dir_.c_str(), &vfs) != 0) {
+        LOGE("statvfs %{public}s failed, errno %{public}d", dir_.c_str(), errno);
+        return E_ERR;
+    }
+    /* Leave at least half of the free space alone */
+    uint64_t size = std::min<uint64_t>(options_.fileSize, static_cast<uint64_t>(vfs.f_bavail) * vfs.f_frsize / 2);
+    size -= size % options_.seqBlockSize;
+    if (size == 0) {
+        LOGE("not enough space in %{public}s for the benchmark", dir_.c_str());
+        return E_ERR;
+    }
+
+    std::unique_ptr<char, FreeDeleter> buf(static_cast<char *>(aligned_alloc(BUFFER_ALIGN, options_.seqBlockSize)));
+    if (buf == nullptr) {
+        return E_ERR;
+    }
+    /* Incompressible data, some controllers shortcut zeroes */
+    std::mt19937 rng(RANDOM_SEED);
+    std::generate(buf.get(), buf.get() + options_.seqBlockSize, [&rng] { return static_cast<char>(rng()); });
+
+    int32_t fd = -1;
+    bool direct = false;
+    if (OpenTestFile(buf.get(), fd, direct) != E_OK) {
+        return E_ERR;
+    }
+
+    Phase seqWrite;
+    Phase seqRead;
+    Phase randWrite;
+    Phase randRead;
+    int32_t err = Sequential(fd, true, size, buf.get(), seqWrite);
+    if (err == E_OK) {
+        err = Sequential(fd, false, seqWrite.bytes, buf.get(), seqRead);
+    }
+    if (err == E_OK) {
+        err = Random(fd, true, seqWrite.bytes, buf.get(), randWrite);
+    }
+    if (err == E_OK) {
+        err = Random(fd, false, seqWrite.bytes, buf.get(), randRead);
+    }
+    close(fd);
+
+    result.durationMs_ = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    result.direct_ = direct;
+    result.cancelled_ = cancelled_;
+    result.seqWriteMBps_ = PerSecond(seqWrite.bytes / BYTES_PER_MB, seqWrite.seconds);
+    result.seqReadMBps_ = PerSecond(seqRead.bytes / BYTES_PER_MB, seqRead.seconds);
+    result.randWriteIops_ = PerSecond(randWrite.ops, randWrite.seconds);
+    result.randReadIops_ = PerSecond(randRead.ops, randRead.seconds);
+    result.speedClass_ = result.cancelled_ ? "" : ClassifyMediaSpeed(result);
+    LOGI("benchmark of %{public}s: seq write %{public}.1f MB/s, seq read %{public}.1f MB/s, "
+        "rand write %{public}.0f IOPS, rand read %{public}.0f IOPS, direct %{public}d, cancelled %{public}d",
+        dir_.c_str(), result.seqWriteMBps_, result.seqReadMBps_, result.randWriteIops_, result.randReadIops_,
+        result.direct_, result.cancelled_);
+    return err;
+}
+
+std::string ClassifyMediaSpeed(const StorageManager::MediaBenchmarkResult &result)
+{
+    std::string classes;
+    for (auto &family : SPEED_CLASSES) {
+        for (auto &speed : family) {
+            if (result.seqWriteMBps_ >= speed.seqWriteMBps && result.randReadIops_ >= speed.randReadIops &&
+                result.randWriteIops_ >= speed.randWriteIops) {
+                classes += classes.empty() ? speed.name : std::string(" ") + speed.name;
+                break;
+            }
+        }
+    }
+    return classes;
+}
+} // STORAGE_DAEMON
+} // OHOS
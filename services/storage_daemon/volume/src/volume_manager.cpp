@@ -15,6 +15,7 @@
 
 #include "volume/volume_manager.h"
 #include <cstdlib>
+#include <future>
 #include <sys/sysmacros.h>
 #include "storage_service_log.h"
 #include "storage_service_errno.h"
@@ -39,6 +40,7 @@ VolumeManager* VolumeManager::Instance()
 
 std::shared_ptr<VolumeInfo> VolumeManager::GetVolume(const std::string volId)
 {
+    std::lock_guard<std::mutex> lock(lock_);
     auto it = volumes_.find(volId);
     if (it == volumes_.end()) {
         return nullptr;
@@ -64,7 +66,10 @@ std::string VolumeManager::CreateVolume(const std::string diskId, dev_t device)
         return "";
     }
 
-    volumes_[volId] = info;
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        volumes_[volId] = info;
+    }
 
     StorageManagerClient client;
     ret = client.NotifyVolumeCreated(info);
@@ -77,27 +82,52 @@ std::string VolumeManager::CreateVolume(const std::string diskId, dev_t device)
 
 int32_t VolumeManager::DestroyVolume(const std::string volId)
 {
-    LOGI("destroy volume %{public}s.", volId.c_str());
+    std::vector<int32_t> results;
+    DestroyVolumes({ volId }, results);
+    return results[0];
+}
 
-    std::shared_ptr<VolumeInfo> destroyNode = GetVolume(volId);
+void VolumeManager::DestroyVolumes(const std::vector<std::string> &volIds, std::vector<int32_t> &results)
+{
+    results.assign(volIds.size(), E_OK);
+    std::vector<std::future<int32_t>> pending(volIds.size());
+    for (size_t i = 0; i < volIds.size(); i++) {
+        LOGI("destroy volume %{public}s.", volIds[i].c_str());
+        std::shared_ptr<VolumeInfo> destroyNode = GetVolume(volIds[i]);
+        if (destroyNode == nullptr) {
+            LOGE("the volume %{public}s does not exist", volIds[i].c_str());
+            results[i] = E_NON_EXIST;
+            continue;
+        }
 
-    if (destroyNode == nullptr) {
-        LOGE("the volume %{public}s does not exist", volId.c_str());
-        return E_NON_EXIST;
+        (void)CancelBenchmark(volIds[i]);
+        auto result = std::make_shared<std::promise<int32_t>>();
+        pending[i] = result->get_future();
+        if (!ops_.Post(volIds[i], [destroyNode] { return destroyNode->Destroy(); },
+            [result](int32_t err) { result->set_value(err); })) {
+            pending[i] = std::future<int32_t>();
+            results[i] = E_ERR;
+        }
     }
 
-    int32_t ret = destroyNode->Destroy();
-    if (ret)
-        return ret;
-    volumes_.erase(volId);
-    destroyNode.reset();
+    for (size_t i = 0; i < volIds.size(); i++) {
+        if (!pending[i].valid()) {
+            continue;
+        }
+        results[i] = pending[i].get();
+        if (results[i] != E_OK) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            volumes_.erase(volIds[i]);
+        }
 
-    StorageManagerClient client;
-    ret = client.NotifyVolumeDestroyed(volId);
-    if (ret != E_OK) {
-        LOGE("Volume Notify Created failed");
+        StorageManagerClient client;
+        if (client.NotifyVolumeDestroyed(volIds[i]) != E_OK) {
+            LOGE("Volume Notify Destroyed failed");
+        }
     }
-    return E_OK;
 }
 
 int32_t VolumeManager::Check(const std::string volId)
@@ -108,10 +138,15 @@ int32_t VolumeManager::Check(const std::string volId)
         return E_NON_EXIST;
     }
 
-    int32_t err = info->Check();
-    if (err != E_OK) {
-        LOGE("the volume %{public}s check failed.", volId.c_str());
-        return err;
+    /* fsck of a dirty volume can take minutes, it must not hold up the caller */
+    auto check = [info] { return info->Check(); };
+    auto done = [volId](int32_t err) {
+        if (err != E_OK) {
+            LOGE("the volume %{public}s check failed.", volId.c_str());
+        }
+    };
+    if (!ops_.Post(volId, check, done)) {
+        return E_ERR;
     }
     return E_OK;
 }
@@ -124,16 +159,18 @@ int32_t VolumeManager::Mount(const std::string volId, uint32_t flags)
         return E_NON_EXIST;
     }
 
-    int32_t err = info->Mount(flags);
-    if (err != E_OK) {
-        LOGE("the volume %{public}s mount failed.", volId.c_str());
-        return err;
-    }
-
-    StorageManagerClient client;
-    err = client.NotifyVolumeMounted(info);
-    if (err) {
-        LOGE("Volume Notify Mount Destroyed failed");
+    auto mount = [info, flags] { return info->Mount(flags); };
+    auto notify = [info, volId](int32_t err) {
+        if (err != E_OK) {
+            LOGE("the volume %{public}s mount failed.", volId.c_str());
+        }
+        StorageManagerClient client;
+        if (client.NotifyVolumeMounted(info) != E_OK) {
+            LOGE("Volume Notify Mounted failed");
+        }
+    };
+    if (!ops_.Post(volId, mount, notify)) {
+        return E_ERR;
     }
     return E_OK;
 }
@@ -146,7 +183,8 @@ int32_t VolumeManager::UMount(const std::string volId)
         return E_NON_EXIST;
     }
 
-    int32_t err = info->UMount();
+    (void)CancelBenchmark(volId);
+    int32_t err = ops_.Run(volId, [info] { return info->UMount(); });
     if (err != E_OK) {
         LOGE("the volume %{public}s mount failed.", volId.c_str());
         return err;
@@ -162,7 +200,7 @@ int32_t VolumeManager::Format(const std::string volId, const std::string fsType)
         return E_NON_EXIST;
     }
 
-    int32_t err = info->Format(fsType);
+    int32_t err = ops_.Run(volId, [info, fsType] { return info->Format(fsType); });
     if (err != E_OK) {
         LOGE("the volume %{public}s format failed.", volId.c_str());
         return err;
@@ -170,5 +208,61 @@ int32_t VolumeManager::Format(const std::string volId, const std::string fsType)
 
     return E_OK;
 }
+
+int32_t VolumeManager::Benchmark(const std::string volId, uint32_t budgetMs,
+    StorageManager::MediaBenchmarkResult &result)
+{
+    std::shared_ptr<VolumeInfo> info = GetVolume(volId);
+    if (info == nullptr) {
+        LOGE("the volume %{public}s does not exist.", volId.c_str());
+        return E_NON_EXIST;
+    }
+
+    MediaBenchmarkOptions options;
+    if (budgetMs != 0) {
+        options.budget = std::chrono::milliseconds(budgetMs);
+    }
+    auto benchmark = std::make_shared<MediaBenchmark>(info->GetMountPath(), options);
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        if (!benchmarks_.emplace(volId, benchmark).second) {
+            LOGE("the volume %{public}s is already being benchmarked.", volId.c_str());
+            return E_EXIST;
+        }
+    }
+
+    /*
+     * Runs as an op of the volume so the state cannot change under it, and an
+     * unmount or destroy queued behind it only starts once the test file is
+     * closed. They cancel it first, a queued benchmark then returns at once.
+     */
+    result.volumeId_ = volId;
+    int32_t err = ops_.Run(volId, [info, benchmark, &result]() -> int32_t {
+        if (info->GetState() != MOUNTED) {
+            LOGE("the volume %{public}s is not mounted.", info->GetVolumeId().c_str());
+            return E_VOL_STATE;
+        }
+        return benchmark->Run(result);
+    });
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        benchmarks_.erase(volId);
+    }
+    if (err != E_OK) {
+        LOGE("the volume %{public}s benchmark failed.", volId.c_str());
+    }
+    return err;
+}
+
+int32_t VolumeManager::CancelBenchmark(const std::string volId)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = benchmarks_.find(volId);
+    if (it == benchmarks_.end()) {
+        return E_NON_EXIST;
+    }
+    it->second->Cancel();
+    return E_OK;
+}
 } // StorageDaemon
 } // OHOS
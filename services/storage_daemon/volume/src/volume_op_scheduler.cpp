@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "volume/volume_op_scheduler.h"
+
+#include <future>
+#include <memory>
+
+#include "storage_service_errno.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+VolumeOpScheduler::VolumeOpScheduler(uint32_t threads) : strands_(threads)
+{
+}
+
+bool VolumeOpScheduler::Post(const std::string &volId, Op op, Done done)
+{
+    return strands_.Post(std::hash<std::string>()(volId), [op = std::move(op), done = std::move(done)] {
+        int32_t err = op();
+        if (done != nullptr) {
+            done(err);
+        }
+    });
+}
+
+int32_t VolumeOpScheduler::Run(const std::string &volId, Op op)
+{
+    auto result = std::make_shared<std::promise<int32_t>>();
+    std::future<int32_t> future = result->get_future();
+    if (!Post(volId, std::move(op), [result](int32_t err) { result->set_value(err); })) {
+        return E_ERR;
+    }
+    return future.get();
+}
+
+void VolumeOpScheduler::WaitIdle()
+{
+    strands_.WaitIdle();
+}
+
+void VolumeOpScheduler::Stop()
+{
+    strands_.Stop();
+}
+} // StorageDaemon
+} // OHOS
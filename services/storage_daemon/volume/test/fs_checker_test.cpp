@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "storage_service_errno.h"
+#include "utils/file_utils.h"
+#include "volume/fs_checker.h"
+#include "volume/fs_prober.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+const std::string IMAGE_PATH = "/data/fs_checker_test.img";
+const std::string MKE2FS_PATH = "/system/bin/mke2fs";
+const std::string E2FSCK_PATH = "/system/bin/e2fsck";
+constexpr off_t EXT_STATE_OFFSET = 1024 + 0x3A;
+
+bool MakeDirtyExt2()
+{
+    int fd = open(IMAGE_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ftruncate(fd, 8 << 20) == 0;
+    close(fd);
+    std::vector<std::string> cmd = { MKE2FS_PATH, "-q", "-F", "-t", "ext2", IMAGE_PATH };
+    if (!ok || ForkExec(cmd) != E_OK) {
+        return false;
+    }
+
+    /* Clear the valid bit, as it is on an ext2 card pulled while mounted */
+    fd = open(IMAGE_PATH.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    uint8_t state[2] = { 0, 0 };
+    ok = pwrite(fd, state, sizeof(state), EXT_STATE_OFFSET) == sizeof(state);
+    close(fd);
+    return ok;
+}
+}
+
+class FsCheckerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void)
+    {
+        unlink(IMAGE_PATH.c_str());
+    };
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: FsCheckerTest_Progress_001
+ * @tc.desc: Verify e2fsck progress lines map onto the weighted passes and other output is not taken for progress.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(FsCheckerTest, FsCheckerTest_Progress_001, TestSize.Level1)
+{
+    uint32_t percent = 0;
+    EXPECT_TRUE(ParseE2fsckProgress("1 0 2048 /dev/block/vol-8-1", percent));
+    EXPECT_EQ(percent, 0U);
+    EXPECT_TRUE(ParseE2fsckProgress("1 1024 2048 /dev/block/vol-8-1", percent));
+    EXPECT_EQ(percent, 35U);
+    EXPECT_TRUE(ParseE2fsckProgress("2 2048 2048 /dev/block/vol-8-1", percent));
+    EXPECT_EQ(percent, 90U);
+    EXPECT_TRUE(ParseE2fsckProgress("5 16 16 /dev/block/vol-8-1", percent));
+    EXPECT_EQ(percent, 100U);
+
+    EXPECT_FALSE(ParseE2fsckProgress("Pass 1: Checking inodes, blocks, and sizes", percent));
+    EXPECT_FALSE(ParseE2fsckProgress("/dev/block/vol-8-1: 11/2048 files (0.0% non-contiguous)", percent));
+    EXPECT_FALSE(ParseE2fsckProgress("6 1 2 /dev/block/vol-8-1", percent));
+    EXPECT_FALSE(ParseE2fsckProgress("1 3 2 /dev/block/vol-8-1", percent));
+    EXPECT_FALSE(ParseE2fsckProgress("1 0 0 /dev/block/vol-8-1", percent));
+}
+
+/**
+ * @tc.name: FsCheckerTest_Run_001
+ * @tc.desc: Verify a checker's output arrives line by line with its exit status, and a missing one is told apart.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(FsCheckerTest, FsCheckerTest_Run_001, TestSize.Level1)
+{
+    std::vector<std::string> lines;
+    auto collect = [&lines](const std::string &line) { lines.push_back(line); };
+    EXPECT_EQ(RunChecker({ "sh", "-c", "printf 'one\\ntwo\\n\\nlast'; exit 4" }, collect), 4);
+    EXPECT_EQ(lines, std::vector<std::string>({ "one", "two", "last" }));
+    EXPECT_EQ(RunChecker({ "/data/fs_checker_test.missing" }, collect), FS_CHECKER_MISSING);
+    EXPECT_EQ(RunChecker({}, collect), E_ERR);
+
+    EXPECT_EQ(CheckFilesystem(IMAGE_PATH, "ntfs", nullptr), E_NOT_SUPPORT);
+    EXPECT_EQ(CheckFilesystem(IMAGE_PATH, "f2fs", nullptr), E_NOT_SUPPORT);
+}
+
+/**
+ * @tc.name: FsCheckerTest_E2fsck_001
+ * @tc.desc: Verify a dirty ext2 volume is repaired with rising progress and probes clean afterwards.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(FsCheckerTest, FsCheckerTest_E2fsck_001, TestSize.Level1)
+{
+    if (access(MKE2FS_PATH.c_str(), X_OK) != 0 || access(E2FSCK_PATH.c_str(), X_OK) != 0) {
+        GTEST_LOG_(INFO) << "mke2fs or e2fsck not present, skip";
+        return;
+    }
+    ASSERT_TRUE(MakeDirtyExt2());
+    FsProbeResult result;
+    ASSERT_EQ(ProbeFilesystem(IMAGE_PATH, result), E_OK);
+    EXPECT_TRUE(result.dirty);
+
+    std::vector<uint32_t> progress;
+    EXPECT_EQ(CheckFilesystem(IMAGE_PATH, result.type, [&progress](uint32_t percent) {
+        progress.push_back(percent);
+    }), E_OK);
+    ASSERT_GE(progress.size(), 2U);
+    EXPECT_EQ(progress.front(), 0U);
+    EXPECT_EQ(progress.back(), 100U);
+    EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+
+    ASSERT_EQ(ProbeFilesystem(IMAGE_PATH, result), E_OK);
+    EXPECT_FALSE(result.dirty);
+}
+} // namespace StorageDaemon
+} // namespace OHOS
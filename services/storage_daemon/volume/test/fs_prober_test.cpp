@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "storage_service_errno.h"
+#include "utils/file_utils.h"
+#include "volume/fs_prober.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+const std::string IMAGE_PATH = "/data/fs_prober_test.img";
+const std::string MKE2FS_PATH = "/system/bin/mke2fs";
+constexpr size_t IMAGE_BYTES = 2 << 20;
+constexpr uint32_t SECTOR = 512;
+constexpr int32_t FUZZ_ROUNDS = 4000;
+constexpr int32_t PROBE_LOOPS = 1000;
+constexpr int32_t BLKID_LOOPS = 10;
+const uint8_t TEST_UUID[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+/* A hand built volume, independent of the prober, and where its label lives */
+struct TestImage {
+    std::string name;
+    std::vector<uint8_t> data;
+    size_t labelOffset { 0 };
+    FsProbeResult expected;
+};
+
+template<typename T>
+void Put(std::vector<uint8_t> &buf, size_t offset, T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++) {
+        buf[offset + i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8));
+    }
+}
+
+uint16_t Le16Of(const std::vector<uint8_t> &buf, size_t offset)
+{
+    return static_cast<uint16_t>(buf[offset] | (buf[offset + 1] << 8));
+}
+
+void PutBytes(std::vector<uint8_t> &buf, size_t offset, const std::string &bytes)
+{
+    std::copy(bytes.begin(), bytes.end(), buf.begin() + offset);
+}
+
+void PutUtf16(std::vector<uint8_t> &buf, size_t offset, const std::string &ascii)
+{
+    for (size_t i = 0; i < ascii.size(); i++) {
+        Put<uint16_t>(buf, offset + i * 2, static_cast<uint8_t>(ascii[i]));
+    }
+}
+
+TestImage ExtImage(const std::string &type, uint32_t compat, uint32_t incompat)
+{
+    TestImage image { type, std::vector<uint8_t>(IMAGE_BYTES, 0), 1024 + 0x78,
+        { type, "00010203-0405-0607-0809-0a0b0c0d0e0f", "extlabel" } };
+    Put<uint16_t>(image.data, 1024 + 0x38, 0xEF53);
+    Put<uint16_t>(image.data, 1024 + 0x3A, 0x0001);
+    Put<uint32_t>(image.data, 1024 + 0x5C, compat);
+    Put<uint32_t>(image.data, 1024 + 0x60, incompat);
+    std::copy(TEST_UUID, TEST_UUID + sizeof(TEST_UUID), image.data.begin() + 1024 + 0x68);
+    PutBytes(image.data, 1024 + 0x78, "extlabel");
+    return image;
+}
+
+TestImage F2fsImage()
+{
+    TestImage image { "f2fs", std::vector<uint8_t>(IMAGE_BYTES, 0), 1024 + 0x7C,
+        { "f2fs", "00010203-0405-0607-0809-0a0b0c0d0e0f", "f2fsvol" } };
+    Put<uint32_t>(image.data, 1024, 0xF2F52010);
+    std::copy(TEST_UUID, TEST_UUID + sizeof(TEST_UUID), image.data.begin() + 1024 + 0x6C);
+    PutUtf16(image.data, 1024 + 0x7C, "f2fsvol");
+    return image;
+}
+
+void PutFatBpb(std::vector<uint8_t> &buf, uint8_t sectorsPerCluster, uint16_t reserved, uint16_t rootEntries,
+    uint16_t fatSize16)
+{
+    buf[0] = 0xEB;
+    buf[1] = 0x3C;
+    buf[2] = 0x90;
+    PutBytes(buf, 3, "mkfs.fat");
+    Put<uint16_t>(buf, 0x0B, SECTOR);
+    buf[0x0D] = sectorsPerCluster;
+    Put<uint16_t>(buf, 0x0E, reserved);
+    buf[0x10] = 2;
+    Put<uint16_t>(buf, 0x11, rootEntries);
+    Put<uint16_t>(buf, 0x13, IMAGE_BYTES / SECTOR);
+    buf[0x15] = 0xF8;
+    Put<uint16_t>(buf, 0x16, fatSize16);
+    Put<uint16_t>(buf, 0x1FE, 0xAA55);
+}
+
+/* Label only in the root directory, as left by tools that relabel */
+TestImage Fat32Image()
+{
+    constexpr uint16_t reserved = 32;
+    constexpr uint32_t fatSize = 16;
+    constexpr uint8_t sectorsPerCluster = 1;
+    TestImage image { "vfat32", std::vector<uint8_t>(IMAGE_BYTES, 0), (reserved + 2 * fatSize) * SECTOR,
+        { "vfat", "1234-ABCD", "MYCARD" } };
+    PutFatBpb(image.data, sectorsPerCluster, reserved, 0, 0);
+    Put<uint32_t>(image.data, 0x24, fatSize);
+    Put<uint32_t>(image.data, 0x2C, 2);
+    image.data[0x42] = 0x29;
+    Put<uint32_t>(image.data, 0x43, 0x1234ABCD);
+    PutBytes(image.data, 0x47, "NO NAME    ");
+    PutBytes(image.data, 0x52, "FAT32   ");
+    Put<uint32_t>(image.data, reserved * SECTOR, 0x0FFFFFF8);
+    Put<uint32_t>(image.data, reserved * SECTOR + 4, 0x0FFFFFFF);
+    Put<uint32_t>(image.data, reserved * SECTOR + 8, 0x0FFFFFFF);
+    Put<uint32_t>(image.data, (reserved + fatSize) * SECTOR, 0x0FFFFFF8);
+    Put<uint32_t>(image.data, (reserved + fatSize) * SECTOR + 4, 0x0FFFFFFF);
+    Put<uint32_t>(image.data, (reserved + fatSize) * SECTOR + 8, 0x0FFFFFFF);
+    PutBytes(image.data, image.labelOffset, "MYCARD     ");
+    image.data[image.labelOffset + 11] = 0x08;
+    return image;
+}
+
+/* Label only in the boot sector, which blkid does not report as LABEL either */
+TestImage Fat16Image()
+{
+    constexpr uint16_t reserved = 1;
+    constexpr uint16_t fatSize = 16;
+    TestImage image { "vfat16", std::vector<uint8_t>(IMAGE_BYTES, 0), 0x2B, { "vfat", "0BAD-F00D", "" } };
+    PutFatBpb(image.data, 4, reserved, 512, fatSize);
+    image.data[0x26] = 0x29;
+    Put<uint32_t>(image.data, 0x27, 0x0BADF00D);
+    PutBytes(image.data, 0x2B, "BOOTLBL    ");
+    PutBytes(image.data, 0x36, "FAT16   ");
+    Put<uint16_t>(image.data, reserved * SECTOR, 0xFFF8);
+    Put<uint16_t>(image.data, reserved * SECTOR + 2, 0xFFFF);
+    Put<uint16_t>(image.data, (reserved + fatSize) * SECTOR, 0xFFF8);
+    Put<uint16_t>(image.data, (reserved + fatSize) * SECTOR + 2, 0xFFFF);
+    return image;
+}
+
+TestImage ExfatImage()
+{
+    constexpr uint32_t heapOffset = 2048;
+    constexpr uint32_t rootCluster = 4;
+    constexpr uint8_t clusterSectorsShift = 3;
+    size_t root = heapOffset * SECTOR + (rootCluster - 2) * (SECTOR << clusterSectorsShift);
+    TestImage image { "exfat", std::vector<uint8_t>(IMAGE_BYTES, 0), root, { "exfat", "DEAD-BEEF", "Card1" } };
+    image.data[0] = 0xEB;
+    image.data[1] = 0x76;
+    image.data[2] = 0x90;
+    PutBytes(image.data, 3, "EXFAT   ");
+    Put<uint64_t>(image.data, 0x48, IMAGE_BYTES / SECTOR);
+    Put<uint32_t>(image.data, 0x50, 128);
+    Put<uint32_t>(image.data, 0x54, 8);
+    Put<uint32_t>(image.data, 0x58, heapOffset);
+    Put<uint32_t>(image.data, 0x5C, (IMAGE_BYTES / SECTOR - heapOffset) >> clusterSectorsShift);
+    Put<uint32_t>(image.data, 0x60, rootCluster);
+    Put<uint32_t>(image.data, 0x64, 0xDEADBEEF);
+    Put<uint16_t>(image.data, 0x68, 0x0100);
+    image.data[0x6C] = 9;
+    image.data[0x6D] = clusterSectorsShift;
+    image.data[0x6E] = 1;
+    Put<uint16_t>(image.data, 0x1FE, 0xAA55);
+    image.data[root] = 0x83;
+    image.data[root + 1] = 5;
+    PutUtf16(image.data, root + 2, "Card1");
+    return image;
+}
+
+/* $Volume in MFT record 3, with both sector tails moved to the update sequence array */
+TestImage NtfsImage()
+{
+    constexpr uint32_t clusterSize = 4096;
+    constexpr uint64_t mftCluster = 4;
+    constexpr size_t recordSize = 1024;
+    size_t record = mftCluster * clusterSize + 3 * recordSize;
+    TestImage image { "ntfs", std::vector<uint8_t>(IMAGE_BYTES, 0), record, { "ntfs", "0123456789ABCDEF", "Disk" } };
+    auto &buf = image.data;
+    buf[0] = 0xEB;
+    buf[1] = 0x52;
+    buf[2] = 0x90;
+    PutBytes(buf, 3, "NTFS    ");
+    Put<uint16_t>(buf, 0x0B, SECTOR);
+    buf[0x0D] = clusterSize / SECTOR;
+    buf[0x15] = 0xF8;
+    Put<uint64_t>(buf, 0x28, IMAGE_BYTES / SECTOR - 1);
+    Put<uint64_t>(buf, 0x30, mftCluster);
+    Put<uint64_t>(buf, 0x38, 8);
+    buf[0x40] = 0xF6;
+    buf[0x44] = 1;
+    Put<uint64_t>(buf, 0x48, 0x0123456789ABCDEFULL);
+    Put<uint16_t>(buf, 0x1FE, 0xAA55);
+
+    PutBytes(buf, record, "FILE");
+    Put<uint16_t>(buf, record + 4, 0x30);
+    Put<uint16_t>(buf, record + 6, 3);
+    Put<uint16_t>(buf, record + 0x14, 0x38);
+    Put<uint16_t>(buf, record + 0x16, 1);
+    Put<uint32_t>(buf, record + 0x18, 0x38 + 32 + 40 + 8);
+    Put<uint32_t>(buf, record + 0x1C, recordSize);
+    size_t attr = record + 0x38;
+    Put<uint32_t>(buf, attr, 0x60);
+    Put<uint32_t>(buf, attr + 4, 32);
+    Put<uint32_t>(buf, attr + 16, 8);
+    Put<uint16_t>(buf, attr + 20, 0x18);
+    PutUtf16(buf, attr + 0x18, "Disk");
+    attr += 32;
+    Put<uint32_t>(buf, attr, 0x70);
+    Put<uint32_t>(buf, attr + 4, 40);
+    Put<uint32_t>(buf, attr + 16, 12);
+    Put<uint16_t>(buf, attr + 20, 0x18);
+    buf[attr + 0x18 + 8] = 3;
+    buf[attr + 0x18 + 9] = 1;
+    Put<uint32_t>(buf, attr + 40, 0xFFFFFFFF);
+    Put<uint16_t>(buf, record + 0x30, 0x0007);
+    Put<uint16_t>(buf, record + 0x32, Le16Of(buf, record + SECTOR - 2));
+    Put<uint16_t>(buf, record + 0x34, Le16Of(buf, record + 2 * SECTOR - 2));
+    Put<uint16_t>(buf, record + SECTOR - 2, 0x0007);
+    Put<uint16_t>(buf, record + 2 * SECTOR - 2, 0x0007);
+    return image;
+}
+
+std::vector<TestImage> AllImages()
+{
+    return {
+        ExtImage("ext2", 0, 0x2), ExtImage("ext3", 0x4, 0x2), ExtImage("ext4", 0x4, 0x2C2), F2fsImage(),
+        Fat32Image(), Fat16Image(), ExfatImage(), NtfsImage(),
+    };
+}
+
+FsProbeReader MemoryReader(const std::vector<uint8_t> &data, size_t limit)
+{
+    return [&data, limit](uint64_t offset, size_t length, std::vector<uint8_t> &buf) {
+        if (offset > limit || length > limit - offset) {
+            return false;
+        }
+        buf.assign(data.begin() + offset, data.begin() + offset + length);
+        return true;
+    };
+}
+
+bool WriteImage(const std::vector<uint8_t> &data)
+{
+    int fd = open(IMAGE_PATH.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    close(fd);
+    return ok;
+}
+
+std::string Blkid(const std::string &tag)
+{
+    std::vector<std::string> cmd = { "blkid", "-p", "-s", tag, "-o", "value", IMAGE_PATH };
+    std::vector<std::string> output;
+    if (ForkExec(cmd, &output) != E_OK || output.empty()) {
+        return "";
+    }
+    return output[0].substr(0, output[0].find('\n'));
+}
+}
+
+class FsProberTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void)
+    {
+        unlink(IMAGE_PATH.c_str());
+    };
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: FsProberTest_Probe_001
+ * @tc.desc: Verify type, uuid and label of each supported format, read from memory and from an image file.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(FsProberTest, FsProberTest_Probe_001, TestSize.Level1)
+{
+    for (auto &image : AllImages()) {
+        FsProbeResult result;
+        EXPECT_EQ(ProbeFilesystem(MemoryReader(image.data, image.data.size()), result), E_OK);
+        EXPECT_EQ(result.type, image.expected.type) << image.name;
+        EXPECT_EQ(result.uuid, image.expected.uuid) << image.name;
+        EXPECT_EQ(result.label, image.expected.label) << image.name;
+
+        ASSERT_TRUE(WriteImage(image.data));
+        FsProbeResult fromFile;
+        EXPECT_EQ(ProbeFilesystem(IMAGE_PATH, fromFile), E_OK);
+        EXPECT_EQ(fromFile.type, image.expected.type) << image.name;
+        EXPECT_EQ(fromFile.label, image.expected.label) << image.name;
+    }
+}
+
+/**
+ * @tc.name: FsProberTest_Probe_002
+ * @tc.desc: Verify unknown content, short volumes and missing devices.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(FsProberTest, FsProberTest_Probe_002, TestSize.Level1)
+{
+    std::vector<uint8_t> zeros(IMAGE_BYTES, 0);
+    FsProbeResult result;
+    EXPECT_EQ(ProbeFilesystem(MemoryReader(zeros, zeros.size()), result), E_OK);
+    EXPECT_TRUE(result.type.empty());
+    EXPECT_EQ(ProbeFilesystem(MemoryReader(zeros, FS_PROBE_HEAD_BYTES - 1), result), E_ERR);
+    EXPECT_EQ(ProbeFilesystem("/data/fs_prober_test.missing", result), E_ERR);
+
+    /* A label that cannot be read leaves the rest of the result intact */
+    TestImage image = NtfsImage();
+    EXPECT_EQ(ProbeFilesystem(MemoryReader(image.data, FS_PROBE_HEAD_BYTES), result), E_OK);
+    EXPECT_EQ(result.type, "ntfs");
+    EXPECT_EQ(result.uuid, image.expected.uuid);
+    EXPECT_TRUE(result.label.empty());
+}
+
+/**
+ * @tc.name: FsProberTest_Dirty_001
+ * @tc.desc: Verify the clean images probe clean and each dirty or error flag a format keeps is reported.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(FsProberTest, FsProberTest_Dirty_001, TestSize.Level1)
+{
+    for (auto &image : AllImages()) {
+        FsProbeResult result;
+        EXPECT_EQ(ProbeFilesystem(MemoryReader(image.data, image.data.size()), result), E_OK);
+        EXPECT_FALSE(result.dirty) << image.name;
+    }
+
+    struct Flag {
+        TestImage image;
+        size_t offset;
+        uint8_t clear;
+        uint8_t set;
+        bool dirty;
+    };
+    const size_t ntfsFlags = 4 * 4096 + 3 * 1024 + 0x38 + 32 + 0x18 + 10;
+    std::vector<Flag> flags = {
+        { ExtImage("ext4", 0x4, 0x2C2), 1024 + 0x3A, 0x01, 0, true },
+        { ExtImage("ext4", 0x4, 0x2C2), 1024 + 0x3A, 0, 0x02, true },
+        { ExtImage("ext4", 0x4, 0x2C2), 1024 + 0x60, 0, 0x04, true },
+        { Fat32Image(), 0x41, 0, 0x01, true },
+        { Fat32Image(), 32 * SECTOR + 7, 0x08, 0, true },
+        { Fat32Image(), 32 * SECTOR + 7, 0x04, 0, true },
+        { Fat16Image(), 0x25, 0, 0x01, true },
+        /* Too few clusters for FAT16, FAT12 keeps no shutdown bits */
+        { Fat16Image(), SECTOR + 3, 0x80, 0, false },
+        { ExfatImage(), 0x6A, 0, 0x02, true },
+        { ExfatImage(), 0x6A, 0, 0x04, true },
+        { NtfsImage(), ntfsFlags, 0, 0x01, true },
+    };
+    for (auto &flag : flags) {
+        auto &data = flag.image.data;
+        data[flag.offset] = (data[flag.offset] & ~flag.clear) | flag.set;
+        FsProbeResult result;
+        EXPECT_EQ(ProbeFilesystem(MemoryReader(data, data.size()), result), E_OK);
+        EXPECT_EQ(result.type, flag.image.expected.type);
+        EXPECT_EQ(result.dirty, flag.dirty) << flag.image.name << " at " << flag.offset;
+    }
+}
+
+/**
+ * @tc.name: FsProberTest_Fuzz_001
+ * @tc.desc: Probe randomly corrupted and truncated images, every field read from them must stay bounded.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(FsProberTest, FsProberTest_Fuzz_001, TestSize.Level1)
+{
+    std::mt19937 rng(0x5eed);
+    for (auto &image : AllImages()) {
+        auto &data = image.data;
+        std::uniform_int_distribution<size_t> headPos(0, FS_PROBE_HEAD_BYTES - 1);
+        std::uniform_int_distribution<size_t> labelPos(image.labelOffset, image.labelOffset + 1023);
+        std::uniform_int_distribution<size_t> limit(FS_PROBE_HEAD_BYTES, data.size());
+        std::uniform_int_distribution<int32_t> count(1, 16);
+        std::uniform_int_distribution<int32_t> byte(0, 255);
+        for (int32_t round = 0; round < FUZZ_ROUNDS; round++) {
+            /* Mutate in place and put the bytes back, copying megabytes per round would dominate */
+            std::vector<std::pair<size_t, uint8_t>> saved;
+            for (int32_t i = count(rng); i > 0; i--) {
+                size_t pos = (i % 3 == 0) ? labelPos(rng) : headPos(rng);
+                saved.emplace_back(pos, data[pos]);
+                data[pos] = static_cast<uint8_t>(byte(rng));
+            }
+            FsProbeResult result;
+            size_t readable = (round % 4 == 0) ? limit(rng) : data.size();
+            ASSERT_EQ(ProbeFilesystem(MemoryReader(data, readable), result), E_OK) << image.name;
+            EXPECT_LE(result.uuid.size(), 36U);
+            EXPECT_LE(result.label.size(), 2048U);
+            for (auto it = saved.rbegin(); it != saved.rend(); ++it) {
+                data[it->first] = it->second;
+            }
+        }
+    }
+}
+
+/**
+ * @tc.name: FsProberTest_Mke2fs_001
+ * @tc.desc: Verify an image made by mke2fs, when the tool is on the device.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(FsProberTest, FsProberTest_Mke2fs_001, TestSize.Level1)
+{
+    if (access(MKE2FS_PATH.c_str(), X_OK) != 0) {
+        GTEST_LOG_(INFO) << "mke2fs not present, skip";
+        return;
+    }
+    ASSERT_TRUE(WriteImage(std::vector<uint8_t>(8 << 20, 0)));
+    std::vector<std::string> cmd = { MKE2FS_PATH, "-q", "-F", "-t", "ext4", "-L", "sdcard", "-U",
+        "5d2b6b4c-7a43-4d3e-9a3b-0f0e1d2c3b4a", IMAGE_PATH };
+    ASSERT_EQ(ForkExec(cmd), E_OK);
+
+    FsProbeResult result;
+    EXPECT_EQ(ProbeFilesystem(IMAGE_PATH, result), E_OK);
+    EXPECT_EQ(result.type, "ext4");
+    EXPECT_EQ(result.uuid, "5d2b6b4c-7a43-4d3e-9a3b-0f0e1d2c3b4a");
+    EXPECT_EQ(result.label, "sdcard");
+    EXPECT_FALSE(result.dirty);
+}
+
+/**
+ * @tc.name: FsProberTest_Benchmark_001
+ * @tc.desc: Compare probing an image in process against the three blkid forks it replaces, checking they agree.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(FsProberTest, FsProberTest_Benchmark_001, TestSize.Level3)
+{
+    for (auto &image : AllImages()) {
+        ASSERT_TRUE(WriteImage(image.data));
+        FsProbeResult result;
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < PROBE_LOOPS; i++) {
+            ASSERT_EQ(ProbeFilesystem(IMAGE_PATH, result), E_OK);
+        }
+        auto probeCost = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::string type;
+        std::string uuid;
+        std::string label;
+        start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < BLKID_LOOPS; i++) {
+            uuid = Blkid("UUID");
+            type = Blkid("TYPE");
+            label = Blkid("LABEL");
+        }
+        auto blkidCost = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        GTEST_LOG_(INFO) << image.name << ": prober " << probeCost / PROBE_LOOPS << " us, blkid x3 " <<
+            blkidCost / BLKID_LOOPS << " us";
+
+        /* blkid may lack a format, only compare what it recognised */
+        if (!type.empty()) {
+            EXPECT_EQ(type, result.type) << image.name;
+            EXPECT_EQ(uuid, result.uuid) << image.name;
+            EXPECT_EQ(label, result.label) << image.name;
+        }
+    }
+}
+} // namespace StorageDaemon
+} // namespace OHOS
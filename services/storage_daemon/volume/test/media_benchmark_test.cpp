@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <dirent.h>
+#include <gtest/gtest.h>
+
+#include "storage_service_errno.h"
+#include "volume/media_benchmark.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_DIR = "/data/media_benchmark_test";
+
+MediaBenchmarkOptions SmallOptions(std::chrono::milliseconds budget)
+{
+    MediaBenchmarkOptions options;
+    options.budget = budget;
+    options.fileSize = 8ULL << 20;
+    return options;
+}
+
+size_t CountEntries(const std::string &path)
+{
+    size_t count = 0;
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+    while (struct dirent *ent = readdir(dir)) {
+        std::string name = ent->d_name;
+        if (name != "." && name != "..") {
+            count++;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+}
+
+class MediaBenchmarkTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp()
+    {
+        system(("rm -rf " + TEST_DIR).c_str());
+        ASSERT_EQ(system(("mkdir -p " + TEST_DIR).c_str()), 0);
+    };
+    void TearDown()
+    {
+        system(("rm -rf " + TEST_DIR).c_str());
+    };
+};
+
+/**
+ * @tc.name: MediaBenchmarkTest_Run_001
+ * @tc.desc: Verify a run measures all four tests within the budget and leaves no file behind.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(MediaBenchmarkTest, MediaBenchmarkTest_Run_001, TestSize.Level1)
+{
+    MediaBenchmark benchmark(TEST_DIR, SmallOptions(std::chrono::milliseconds(800)));
+    StorageManager::MediaBenchmarkResult result;
+    EXPECT_EQ(benchmark.Run(result), E_OK);
+    GTEST_LOG_(INFO) << "seq write " << result.seqWriteMBps_ << " MB/s, seq read " << result.seqReadMBps_
+                     << " MB/s, rand write " << result.randWriteIops_ << " IOPS, rand read " << result.randReadIops_
+                     << " IOPS, direct " << result.direct_ << ", " << result.speedClass_;
+
+    EXPECT_GT(result.seqWriteMBps_, 0);
+    EXPECT_GT(result.seqReadMBps_, 0);
+    EXPECT_GT(result.randWriteIops_, 0);
+    EXPECT_GT(result.randReadIops_, 0);
+    EXPECT_FALSE(result.cancelled_);
+    EXPECT_LE(result.durationMs_, 800 + 500);
+    EXPECT_EQ(CountEntries(TEST_DIR), 0);
+}
+
+/**
+ * @tc.name: MediaBenchmarkTest_Run_002
+ * @tc.desc: Verify a missing directory fails without measuring.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(MediaBenchmarkTest, MediaBenchmarkTest_Run_002, TestSize.Level1)
+{
+    MediaBenchmark benchmark(TEST_DIR + "/missing", SmallOptions(std::chrono::milliseconds(400)));
+    StorageManager::MediaBenchmarkResult result;
+    EXPECT_EQ(benchmark.Run(result), E_ERR);
+    EXPECT_EQ(result.seqWriteMBps_, 0);
+}
+
+/**
+ * @tc.name: MediaBenchmarkTest_Cancel_001
+ * @tc.desc: Verify a cancelled run returns promptly, reports the cancel and leaves no file behind.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(MediaBenchmarkTest, MediaBenchmarkTest_Cancel_001, TestSize.Level1)
+{
+    MediaBenchmark benchmark(TEST_DIR, SmallOptions(std::chrono::milliseconds(20000)));
+    std::thread canceller([&benchmark] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        benchmark.Cancel();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    StorageManager::MediaBenchmarkResult result;
+    EXPECT_EQ(benchmark.Run(result), E_OK);
+    canceller.join();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2000));
+    EXPECT_TRUE(result.cancelled_);
+    EXPECT_TRUE(result.speedClass_.empty());
+    EXPECT_EQ(CountEntries(TEST_DIR), 0);
+}
+
+/**
+ * @tc.name: MediaBenchmarkTest_Cancel_002
+ * @tc.desc: Verify a benchmark cancelled before it starts returns at once without opening a test file.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(MediaBenchmarkTest, MediaBenchmarkTest_Cancel_002, TestSize.Level1)
+{
+    MediaBenchmark benchmark(TEST_DIR, SmallOptions(std::chrono::milliseconds(20000)));
+    benchmark.Cancel();
+
+    auto start = std::chrono::steady_clock::now();
+    StorageManager::MediaBenchmarkResult result;
+    EXPECT_EQ(benchmark.Run(result), E_OK);
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+    EXPECT_TRUE(result.cancelled_);
+    EXPECT_EQ(result.seqWriteMBps_, 0);
+    EXPECT_EQ(result.durationMs_, 0);
+    EXPECT_EQ(CountEntries(TEST_DIR), 0);
+}
+
+/**
+ * @tc.name: MediaBenchmarkTest_Classify_001
+ * @tc.desc: Verify the measured figures map to the speed and application performance classes.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(MediaBenchmarkTest, MediaBenchmarkTest_Classify_001, TestSize.Level1)
+{
+    StorageManager::MediaBenchmarkResult result;
+    EXPECT_EQ(ClassifyMediaSpeed(result), "");
+
+    result.seqWriteMBps_ = 5;
+    EXPECT_EQ(ClassifyMediaSpeed(result), "C4");
+
+    result.seqWriteMBps_ = 12;
+    result.randReadIops_ = 1800;
+    result.randWriteIops_ = 600;
+    EXPECT_EQ(ClassifyMediaSpeed(result), "C10 U1 V10 A1");
+
+    result.seqWriteMBps_ = 45;
+    result.randReadIops_ = 4500;
+    result.randWriteIops_ = 1500;
+    EXPECT_EQ(ClassifyMediaSpeed(result), "C10 U3 V30 A1");
+
+    result.randWriteIops_ = 2500;
+    EXPECT_EQ(ClassifyMediaSpeed(result), "C10 U3 V30 A2");
+}
+} // namespace StorageDaemon
+} // namespace OHOS
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <csignal>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "storage_service_errno.h"
+#include "volume/process.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_DIR = "/data/process_test";
+const std::string MOUNT_DIR = TEST_DIR + "/mnt";
+const std::string HELD_FILE = MOUNT_DIR + "/held";
+constexpr int32_t LOAD_CHILDREN = 32;
+constexpr int32_t LOAD_FDS = 512;
+constexpr int32_t SCAN_LOOPS = 5;
+
+/* Forks a child that runs setup, reports back through a pipe and then sleeps until killed */
+pid_t Spawn(const std::function<bool()> &setup)
+{
+    int pipeFd[2];
+    if (pipe(pipeFd) != 0) {
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(pipeFd[0]);
+        char ok = setup() ? 1 : 0;
+        (void)write(pipeFd[1], &ok, 1);
+        close(pipeFd[1]);
+        while (true) {
+            pause();
+        }
+    }
+    close(pipeFd[1]);
+    char ok = 0;
+    if (pid < 0 || read(pipeFd[0], &ok, 1) != 1 || ok != 1) {
+        pid = -1;
+    }
+    close(pipeFd[0]);
+    return pid;
+}
+
+void Reap(const std::vector<pid_t> &pids)
+{
+    for (pid_t pid : pids) {
+        if (pid > 0) {
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+        }
+    }
+}
+
+/* Children holding nothing on the mount, each with an fd table the scan has to walk completely */
+std::vector<pid_t> SpawnLoad(int32_t children)
+{
+    std::vector<pid_t> pids;
+    for (int32_t i = 0; i < children; i++) {
+        pids.push_back(Spawn([] {
+            for (int32_t fd = 0; fd < LOAD_FDS; fd++) {
+                if (open("/dev/null", O_RDONLY | O_CLOEXEC) < 0) {
+                    return false;
+                }
+            }
+            return true;
+        }));
+    }
+    return pids;
+}
+}
+
+class ProcessTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp()
+    {
+        system(("rm -rf " + TEST_DIR).c_str());
+        ASSERT_EQ(system(("mkdir -p " + MOUNT_DIR).c_str()), 0);
+        mounted_ = mount("tmpfs", MOUNT_DIR.c_str(), "tmpfs", 0, "size=1m") == 0;
+        if (mounted_) {
+            int fd = open(HELD_FILE.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+            ASSERT_GE(fd, 0);
+            ASSERT_EQ(ftruncate(fd, getpagesize()), 0);
+            close(fd);
+        } else {
+            GTEST_LOG_(INFO) << "cannot mount tmpfs, errno " << errno;
+        }
+    };
+    void TearDown()
+    {
+        umount2(MOUNT_DIR.c_str(), MNT_DETACH);
+        system(("rm -rf " + TEST_DIR).c_str());
+    };
+
+protected:
+    bool mounted_ { false };
+};
+
+/**
+ * @tc.name: ProcessTest_UpdatePidByPath_001
+ * @tc.desc: Verify processes with their cwd, an open fd or a mapping on the mount are found, and only those.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(ProcessTest, ProcessTest_UpdatePidByPath_001, TestSize.Level1)
+{
+    if (!mounted_) {
+        return;
+    }
+    pid_t cwdHolder = Spawn([] { return chdir(MOUNT_DIR.c_str()) == 0; });
+    pid_t fdHolder = Spawn([] { return open(HELD_FILE.c_str(), O_RDONLY | O_CLOEXEC) >= 0; });
+    pid_t mapHolder = Spawn([] {
+        int fd = open(HELD_FILE.c_str(), O_RDONLY | O_CLOEXEC);
+        void *addr = fd < 0 ? MAP_FAILED : mmap(nullptr, getpagesize(), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        return addr != MAP_FAILED;
+    });
+    std::vector<pid_t> load = SpawnLoad(2);
+    std::vector<pid_t> all = { cwdHolder, fdHolder, mapHolder, load[0], load[1] };
+    for (pid_t pid : all) {
+        ASSERT_GT(pid, 0);
+    }
+
+    std::unordered_set<pid_t> expected = { cwdHolder, fdHolder, mapHolder };
+    Process serial(MOUNT_DIR, 1);
+    EXPECT_EQ(serial.UpdatePidByPath(), E_OK);
+    EXPECT_EQ(serial.GetPids(), expected);
+
+    Process ps(MOUNT_DIR);
+    EXPECT_EQ(ps.UpdatePidByPath(), E_OK);
+    EXPECT_EQ(ps.GetPids(), expected);
+    ps.KillProcess(SIGKILL);
+    for (pid_t pid : expected) {
+        int status = 0;
+        EXPECT_EQ(waitpid(pid, &status, 0), pid);
+        EXPECT_TRUE(WIFSIGNALED(status));
+    }
+    EXPECT_EQ(kill(load[0], 0), 0);
+    Reap(load);
+}
+
+/**
+ * @tc.name: ProcessTest_UpdatePidByPath_002
+ * @tc.desc: Verify a path that is missing or not a mount point is refused rather than matching its parent.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(ProcessTest, ProcessTest_UpdatePidByPath_002, TestSize.Level1)
+{
+    Process plain(TEST_DIR);
+    EXPECT_EQ(plain.UpdatePidByPath(), E_ERR);
+    EXPECT_TRUE(plain.GetPids().empty());
+
+    Process missing(TEST_DIR + "/missing");
+    EXPECT_EQ(missing.UpdatePidByPath(), E_ERR);
+}
+
+/**
+ * @tc.name: ProcessTest_Benchmark_001
+ * @tc.desc: Time a scan over children holding many fds each, on one thread and on the default thread count.
+ * @tc.type: PERF
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(ProcessTest, ProcessTest_Benchmark_001, TestSize.Level3)
+{
+    if (!mounted_) {
+        return;
+    }
+    std::vector<pid_t> load = SpawnLoad(LOAD_CHILDREN);
+    for (pid_t pid : load) {
+        ASSERT_GT(pid, 0);
+    }
+
+    auto run = [](uint32_t threads) {
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < SCAN_LOOPS; i++) {
+            Process ps(MOUNT_DIR, threads);
+            EXPECT_EQ(ps.UpdatePidByPath(), E_OK);
+            EXPECT_TRUE(ps.GetPids().empty());
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count() / SCAN_LOOPS;
+    };
+    long long serialUs = run(1);
+    long long parallelUs = run(PROCESS_SCAN_THREADS);
+    GTEST_LOG_(INFO) << "scan with " << LOAD_CHILDREN << " extra processes of " << LOAD_FDS << " fds: 1 thread "
+                     << serialUs << " us, " << PROCESS_SCAN_THREADS << " threads " << parallelUs << " us";
+    Reap(load);
+}
+} // namespace StorageDaemon
+} // namespace OHOS
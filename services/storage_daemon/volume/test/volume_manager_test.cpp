@@ -65,5 +65,31 @@ HWTEST_F(VolumeManagerTest, Storage_Service_VolumeManagerTest_Instance_002, Test
     ASSERT_TRUE(volumeManagerFirst == volumeManagerSecond);
     GTEST_LOG_(INFO) << "Storage_Service_VolumeManagerTest_Instance_002 end";
 }
+
+/**
+ * @tc.name: Storage_Service_VolumeManagerTest_DestroyVolumes_001
+ * @tc.desc: Verify DestroyVolumes reports a result per volume and fails unknown volumes.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(VolumeManagerTest, Storage_Service_VolumeManagerTest_DestroyVolumes_001, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "Storage_Service_VolumeManagerTest_DestroyVolumes_001 start";
+
+    VolumeManager *volumeManager = VolumeManager::Instance();
+    ASSERT_TRUE(volumeManager != nullptr);
+
+    std::vector<int32_t> results;
+    volumeManager->DestroyVolumes({}, results);
+    EXPECT_TRUE(results.empty());
+
+    volumeManager->DestroyVolumes({ "vol-0-1", "vol-0-2" }, results);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0], E_NON_EXIST);
+    EXPECT_EQ(results[1], E_NON_EXIST);
+    EXPECT_EQ(volumeManager->DestroyVolume("vol-0-1"), E_NON_EXIST);
+
+    GTEST_LOG_(INFO) << "Storage_Service_VolumeManagerTest_DestroyVolumes_001 end";
+}
 } // STORAGE_DAEMON
 } // OHOS
\ No newline at end of file
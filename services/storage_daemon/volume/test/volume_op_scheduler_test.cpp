@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "storage_service_errno.h"
+#include "volume/volume_info.h"
+#include "volume/volume_op_scheduler.h"
+
+namespace OHOS {
+namespace StorageDaemon {
+using namespace testing::ext;
+
+namespace {
+constexpr std::chrono::microseconds OP_DELAY { 200 };
+
+/* Takes a little time per operation and records operations of one volume overlapping */
+class FakeVolume : public VolumeInfo {
+public:
+    explicit FakeVolume(std::atomic<int32_t> &running, std::atomic<int32_t> &maxRunning)
+        : running_(running), maxRunning_(maxRunning)
+    {
+    }
+
+    std::atomic<int32_t> overlaps_ { 0 };
+
+protected:
+    int32_t DoCreate(dev_t dev) override
+    {
+        return E_OK;
+    }
+
+    int32_t DoDestroy() override
+    {
+        return Step();
+    }
+
+    int32_t DoMount(const std::string mountPath, uint32_t mountFlags) override
+    {
+        return Step();
+    }
+
+    int32_t DoUMount(const std::string mountPath, bool force) override
+    {
+        (void)rmdir(mountPath.c_str());
+        return Step();
+    }
+
+    int32_t DoCheck() override
+    {
+        return Step();
+    }
+
+    int32_t DoFormat(std::string type) override
+    {
+        return Step();
+    }
+
+private:
+    int32_t Step()
+    {
+        if (busy_.exchange(true)) {
+            overlaps_++;
+        }
+        int32_t now = ++running_;
+        int32_t max = maxRunning_;
+        while (now > max && !maxRunning_.compare_exchange_weak(max, now)) {
+        }
+        std::this_thread::sleep_for(OP_DELAY);
+        running_--;
+        busy_ = false;
+        return E_OK;
+    }
+
+    std::atomic<bool> busy_ { false };
+    std::atomic<int32_t> &running_;
+    std::atomic<int32_t> &maxRunning_;
+};
+}
+
+class VolumeOpSchedulerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase(void) {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.name: VolumeOpSchedulerTest_Order_001
+ * @tc.desc: Verify the ops of one volume run in queue order and Run returns the op result.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(VolumeOpSchedulerTest, VolumeOpSchedulerTest_Order_001, TestSize.Level1)
+{
+    VolumeOpScheduler ops;
+    std::vector<int32_t> seen;
+    for (int32_t i = 0; i < 1000; i++) {
+        EXPECT_TRUE(ops.Post("vol-8-1", [&seen, i] {
+            seen.push_back(i);
+            return E_OK;
+        }));
+    }
+    EXPECT_EQ(ops.Run("vol-8-1", [] { return E_VOL_STATE; }), E_VOL_STATE);
+    ASSERT_EQ(seen.size(), 1000U);
+    for (int32_t i = 0; i < 1000; i++) {
+        EXPECT_EQ(seen[i], i);
+    }
+}
+
+/**
+ * @tc.name: VolumeOpSchedulerTest_Done_001
+ * @tc.desc: Verify a posted mount reports its result through the completion and a stopped scheduler refuses ops.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(VolumeOpSchedulerTest, VolumeOpSchedulerTest_Done_001, TestSize.Level1)
+{
+    std::atomic<int32_t> running { 0 };
+    std::atomic<int32_t> maxRunning { 0 };
+    auto volume = std::make_shared<FakeVolume>(running, maxRunning);
+    ASSERT_EQ(volume->Create("vol-sched-done", "disk-sched", 0), E_OK);
+
+    VolumeOpScheduler ops;
+    std::atomic<int32_t> result { E_ERR };
+    std::atomic<int32_t> state { UNMOUNTED };
+    EXPECT_EQ(ops.Run("vol-sched-done", [volume] { return volume->Check(); }), E_OK);
+    EXPECT_TRUE(ops.Post("vol-sched-done", [volume] { return volume->Mount(0); }, [&](int32_t err) {
+        result = err;
+        state = volume->GetState();
+    }));
+    ops.WaitIdle();
+    EXPECT_EQ(result, E_OK);
+    EXPECT_EQ(state, MOUNTED);
+    EXPECT_EQ(ops.Run("vol-sched-done", [volume] { return volume->UMount(); }), E_OK);
+
+    ops.Stop();
+    EXPECT_FALSE(ops.Post("vol-sched-done", [] { return E_OK; }));
+    EXPECT_EQ(ops.Run("vol-sched-done", [] { return E_OK; }), E_ERR);
+}
+
+/**
+ * @tc.name: VolumeOpSchedulerTest_Stress_001
+ * @tc.desc: Verify many clients mounting and unmounting the same volumes never overlap ops of one volume,
+ *           leave every volume in a consistent state and run different volumes in parallel.
+ * @tc.type: FUNC
+ * @tc.require: SR000GGUOT
+ */
+HWTEST_F(VolumeOpSchedulerTest, VolumeOpSchedulerTest_Stress_001, TestSize.Level1)
+{
+    constexpr int32_t volumeCount = 8;
+    constexpr int32_t clientCount = 16;
+    constexpr int32_t requestCount = 200;
+    std::atomic<int32_t> running { 0 };
+    std::atomic<int32_t> maxRunning { 0 };
+    std::vector<std::shared_ptr<FakeVolume>> volumes;
+    for (int32_t i = 0; i < volumeCount; i++) {
+        auto volume = std::make_shared<FakeVolume>(running, maxRunning);
+        ASSERT_EQ(volume->Create("vol-sched-" + std::to_string(i), "disk-sched", 0), E_OK);
+        volumes.push_back(volume);
+    }
+
+    VolumeOpScheduler ops;
+    std::atomic<int32_t> mounted { 0 };
+    std::atomic<int32_t> unmounted { 0 };
+    std::vector<std::thread> clients;
+    for (int32_t c = 0; c < clientCount; c++) {
+        clients.emplace_back([&, c] {
+            std::mt19937 random(c);
+            for (int32_t r = 0; r < requestCount; r++) {
+                auto volume = volumes[random() % volumeCount];
+                std::string volId = volume->GetVolumeId();
+                if (random() % 2 == 0) {
+                    /* The storage manager checks synchronously, then queues the mount */
+                    if (ops.Run(volId, [volume] { return volume->Check(); }) == E_OK) {
+                        ops.Post(volId, [volume] { return volume->Mount(0); }, [&mounted](int32_t err) {
+                            mounted += err == E_OK;
+                        });
+                    }
+                } else if (ops.Run(volId, [volume] { return volume->UMount(); }) == E_OK) {
+                    unmounted++;
+                }
+            }
+        });
+    }
+    for (auto &client : clients) {
+        client.join();
+    }
+    ops.WaitIdle();
+
+    GTEST_LOG_(INFO) << "mounts " << mounted << ", unmounts " << unmounted << ", max parallel ops " << maxRunning;
+    EXPECT_GT(mounted, 0);
+    EXPECT_GT(maxRunning, 1);
+    for (auto &volume : volumes) {
+        EXPECT_EQ(volume->overlaps_, 0);
+        int32_t state = volume->GetState();
+        struct stat st;
+        bool dirExists = lstat(volume->GetMountPath().c_str(), &st) == 0;
+        EXPECT_TRUE(state == UNMOUNTED || state == CHECKING || state == MOUNTED);
+        EXPECT_EQ(dirExists, state == MOUNTED);
+
+        EXPECT_EQ(ops.Run(volume->GetVolumeId(), [volume] { return volume->Destroy(); }), E_OK);
+        EXPECT_NE(lstat(volume->GetMountPath().c_str(), &st), 0);
+    }
+}
+} // namespace StorageDaemon
+} // namespace OHOS
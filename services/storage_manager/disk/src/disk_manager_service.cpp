@@ -62,6 +62,17 @@ int32_t DiskManagerService::Partition(std::string diskId, int32_t type)
     return err;
 }
 
+int32_t DiskManagerService::GetDiskIoStats(std::string diskId, DiskIoStats &stats)
+{
+    if (!diskMap_.Contains(diskId)) {
+        LOGE("DiskManagerService::GetDiskIoStats the disk %{public}s doesn't exist", diskId.c_str());
+        return E_NON_EXIST;
+    }
+    std::shared_ptr<StorageDaemonCommunication> sdCommunication;
+    sdCommunication = DelayedSingleton<StorageDaemonCommunication>::GetInstance();
+    return sdCommunication->GetDiskIoStats(diskId, stats);
+}
+
 std::vector<Disk> DiskManagerService::GetAllDisks()
 {
     std::vector<Disk> result;
@@ -20,6 +20,7 @@
 #include <singleton.h>
 #include <nocopyable.h>
 #include "disk.h"
+#include "disk_io_stats.h"
 #include "utils/storage_rl_map.h"
 
 namespace OHOS {
@@ -32,6 +33,7 @@ public:
     void OnDiskCreated(Disk disk);
     void OnDiskDestroyed(std::string diskId);
     std::vector<Disk> GetAllDisks();
+    int32_t GetDiskIoStats(std::string diskId, DiskIoStats &stats);
 private:
     StorageRlMap<std::string, std::shared_ptr<Disk>> diskMap_;
 };
@@ -64,6 +64,7 @@ public:
     void NotifyDiskDestroyed(std::string diskId) override;
     int32_t Partition(std::string diskId, int32_t type) override;
     std::vector<Disk> GetAllDisks() override;
+    int32_t GetDiskIoStats(std::string diskId, DiskIoStats &stats) override;
 
     // fscrypt api
     int32_t GenerateUserKeys(uint32_t userId, uint32_t flags) override;
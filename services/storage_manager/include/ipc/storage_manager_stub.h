@@ -53,6 +53,7 @@ private:
     int32_t HandleNotifyDiskDestroyed(MessageParcel &data, MessageParcel &reply);
     int32_t HandlePartition(MessageParcel &data, MessageParcel &reply);
     int32_t HandleGetAllDisks(MessageParcel &data, MessageParcel &reply);
+    int32_t HandleGetDiskIoStats(MessageParcel &data, MessageParcel &reply);
 
     // fscrypt api
     int32_t HandleGenerateUserKeys(MessageParcel &data, MessageParcel &reply);
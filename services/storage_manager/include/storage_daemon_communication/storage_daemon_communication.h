@@ -38,6 +38,7 @@ public:
     int32_t Unmount(std::string volumeId);
     int32_t Check(std::string volumeId);
     int32_t Partition(std::string diskId, int32_t type);
+    int32_t GetDiskIoStats(std::string diskId, DiskIoStats &stats);
 
     // fscrypt api
     int32_t GenerateUserKeys(uint32_t userId, uint32_t flags);
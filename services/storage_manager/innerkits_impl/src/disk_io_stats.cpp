@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disk_io_stats.h"
+
+namespace OHOS {
+namespace StorageManager {
+bool DiskIoStats::Marshalling(Parcel &parcel) const
+{
+    return parcel.WriteString(diskId_) && parcel.WriteInt64(windowMs_) && parcel.WriteUint32(samples_) &&
+        parcel.WriteDouble(readIops_) && parcel.WriteDouble(writeIops_) && parcel.WriteDouble(readBytesPerSec_) &&
+        parcel.WriteDouble(writeBytesPerSec_) && parcel.WriteDouble(readLatencyUs_) &&
+        parcel.WriteDouble(writeLatencyUs_) && parcel.WriteDouble(utilPercent_) && parcel.WriteUint32(inflightRead_) &&
+        parcel.WriteUint32(inflightWrite_);
+}
+
+std::unique_ptr<DiskIoStats> DiskIoStats::Unmarshalling(Parcel &parcel)
+{
+    auto obj = std::make_unique<DiskIoStats>();
+    obj->diskId_ = parcel.ReadString();
+    obj->windowMs_ = parcel.ReadInt64();
+    obj->samples_ = parcel.ReadUint32();
+    obj->readIops_ = parcel.ReadDouble();
+    obj->writeIops_ = parcel.ReadDouble();
+    obj->readBytesPerSec_ = parcel.ReadDouble();
+    obj->writeBytesPerSec_ = parcel.ReadDouble();
+    obj->readLatencyUs_ = parcel.ReadDouble();
+    obj->writeLatencyUs_ = parcel.ReadDouble();
+    obj->utilPercent_ = parcel.ReadDouble();
+    obj->inflightRead_ = parcel.ReadUint32();
+    obj->inflightWrite_ = parcel.ReadUint32();
+    return obj;
+}
+} // StorageManager
+} // OHOS
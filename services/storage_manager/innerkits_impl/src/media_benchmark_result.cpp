@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "media_benchmark_result.h"
+
+namespace OHOS {
+namespace StorageManager {
+bool MediaBenchmarkResult::Marshalling(Parcel &parcel) const
+{
+    return parcel.WriteString(volumeId_) && parcel.WriteInt64(durationMs_) && parcel.WriteBool(direct_) &&
+        parcel.WriteBool(cancelled_) && parcel.WriteDouble(seqWriteMBps_) && parcel.WriteDouble(seqReadMBps_) &&
+        parcel.WriteDouble(randWriteIops_) && parcel.WriteDouble(randReadIops_) && parcel.WriteString(speedClass_);
+}
+
+std::unique_ptr<MediaBenchmarkResult> MediaBenchmarkResult::Unmarshalling(Parcel &parcel)
+{
+    auto obj = std::make_unique<MediaBenchmarkResult>();
+    obj->volumeId_ = parcel.ReadString();
+    obj->durationMs_ = parcel.ReadInt64();
+    obj->direct_ = parcel.ReadBool();
+    obj->cancelled_ = parcel.ReadBool();
+    obj->seqWriteMBps_ = parcel.ReadDouble();
+    obj->seqReadMBps_ = parcel.ReadDouble();
+    obj->randWriteIops_ = parcel.ReadDouble();
+    obj->randReadIops_ = parcel.ReadDouble();
+    obj->speedClass_ = parcel.ReadString();
+    return obj;
+}
+} // StorageManager
+} // OHOS
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <gtest/gtest.h>
+
+#include "disk_io_stats.h"
+
+namespace {
+using namespace std;
+using namespace OHOS;
+using namespace StorageManager;
+class DiskIoStatsTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.number: SUB_STORAGE_DiskIoStats_Unmarshalling_0000
+ * @tc.name: DiskIoStats_Unmarshalling_0000
+ * @tc.desc: Test function of Marshalling and Unmarshalling interface for SUCCESS.
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require: SR000GGUPG
+ */
+HWTEST_F(DiskIoStatsTest, DiskIoStats_Unmarshalling_0000, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "DiskIoStatsTest-begin DiskIoStats_Unmarshalling_0000";
+    DiskIoStats stats;
+    stats.diskId_ = "disk-8-0";
+    stats.windowMs_ = 59000;
+    stats.samples_ = 60;
+    stats.readIops_ = 120.5;
+    stats.writeIops_ = 30.25;
+    stats.readBytesPerSec_ = 4194304;
+    stats.writeBytesPerSec_ = 1048576;
+    stats.readLatencyUs_ = 850;
+    stats.writeLatencyUs_ = 4200;
+    stats.utilPercent_ = 37.5;
+    stats.inflightRead_ = 2;
+    stats.inflightWrite_ = 5;
+    Parcel parcel;
+    EXPECT_TRUE(stats.Marshalling(parcel));
+    auto result = DiskIoStats::Unmarshalling(parcel);
+    EXPECT_EQ(result->diskId_, stats.diskId_);
+    EXPECT_EQ(result->windowMs_, stats.windowMs_);
+    EXPECT_EQ(result->samples_, stats.samples_);
+    EXPECT_EQ(result->readIops_, stats.readIops_);
+    EXPECT_EQ(result->writeIops_, stats.writeIops_);
+    EXPECT_EQ(result->readBytesPerSec_, stats.readBytesPerSec_);
+    EXPECT_EQ(result->writeBytesPerSec_, stats.writeBytesPerSec_);
+    EXPECT_EQ(result->readLatencyUs_, stats.readLatencyUs_);
+    EXPECT_EQ(result->writeLatencyUs_, stats.writeLatencyUs_);
+    EXPECT_EQ(result->utilPercent_, stats.utilPercent_);
+    EXPECT_EQ(result->inflightRead_, stats.inflightRead_);
+    EXPECT_EQ(result->inflightWrite_, stats.inflightWrite_);
+    GTEST_LOG_(INFO) << "DiskIoStatsTest-end DiskIoStats_Unmarshalling_0000";
+}
+}
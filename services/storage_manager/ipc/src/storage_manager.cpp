@@ -208,6 +208,11 @@ std::vector<Disk> StorageManager::GetAllDisks()
     return result;
 }
 
+int32_t StorageManager::GetDiskIoStats(std::string diskId, DiskIoStats &stats)
+{
+    return DelayedSingleton<DiskManagerService>::GetInstance()->GetDiskIoStats(diskId, stats);
+}
+
 int32_t StorageManager::GenerateUserKeys(uint32_t userId, uint32_t flags)
 {
     LOGI("UserId: %{public}u, flags:  %{public}u", userId, flags);
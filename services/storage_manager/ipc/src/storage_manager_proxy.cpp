@@ -567,6 +567,30 @@ std::vector<Disk> StorageManagerProxy::GetAllDisks()
     return result;
 }
 
+int32_t StorageManagerProxy::GetDiskIoStats(std::string diskId, DiskIoStats &stats)
+{
+    MessageParcel data, reply;
+    MessageOption option(MessageOption::TF_SYNC);
+    if (!data.WriteInterfaceToken(StorageManagerProxy::GetDescriptor())) {
+        LOGE("StorageManagerProxy::GetDiskIoStats, WriteInterfaceToken failed");
+        return E_IPC_ERROR;
+    }
+    if (!data.WriteString(diskId)) {
+        LOGE("StorageManagerProxy::GetDiskIoStats, WriteString failed");
+        return E_IPC_ERROR;
+    }
+    int err = Remote()->SendRequest(GET_DISK_IO_STATS, data, reply, option);
+    if (err != E_OK) {
+        LOGE("StorageManagerProxy::GetDiskIoStats, SendRequest failed");
+        return E_IPC_ERROR;
+    }
+    err = reply.ReadInt32();
+    if (err == E_OK) {
+        stats = *DiskIoStats::Unmarshalling(reply);
+    }
+    return err;
+}
+
 int64_t StorageManagerProxy::GetSystemSize()
 {
     LOGI("StorageManagerProxy::GetSystemSize");
@@ -131,6 +131,9 @@ int32_t StorageManagerStub::OnRemoteRequest(uint32_t code,
         case GET_ALL_DISKS:
             HandleGetAllDisks(data, reply);
             break;
+        case GET_DISK_IO_STATS:
+            HandleGetDiskIoStats(data, reply);
+            break;
         case CREATE_USER_KEYS:
             HandleGenerateUserKeys(data, reply);
             break;
@@ -422,6 +425,21 @@ int32_t StorageManagerStub::HandleGetAllDisks(MessageParcel &data, MessageParcel
     return E_OK;
 }
 
+int32_t StorageManagerStub::HandleGetDiskIoStats(MessageParcel &data, MessageParcel &reply)
+{
+    std::string diskId = data.ReadString();
+    DiskIoStats stats;
+    int32_t err = GetDiskIoStats(diskId, stats);
+    if (!reply.WriteInt32(err)) {
+        LOGE("StorageManagerStub::HandleGetDiskIoStats call GetDiskIoStats failed");
+        return E_IPC_ERROR;
+    }
+    if (err == E_OK && !stats.Marshalling(reply)) {
+        return E_IPC_ERROR;
+    }
+    return E_OK;
+}
+
 int32_t StorageManagerStub::HandleGenerateUserKeys(MessageParcel &data, MessageParcel &reply)
 {
     uint32_t userId = data.ReadUint32();
@@ -142,6 +142,11 @@ public:
         return result;
     }
 
+    virtual int32_t GetDiskIoStats(std::string diskId, DiskIoStats &stats) override
+    {
+        return E_OK;
+    }
+
     virtual int32_t GenerateUserKeys(uint32_t userId, uint32_t flags) override
     {
         return E_OK;
@@ -140,6 +140,15 @@ int32_t StorageDaemonCommunication::Partition(std::string diskId, int32_t type)
     return storageDaemon_->Partition(diskId, type);
 }
 
+int32_t StorageDaemonCommunication::GetDiskIoStats(std::string diskId, DiskIoStats &stats)
+{
+    if (Connect() != E_OK) {
+        LOGE("StorageDaemonCommunication::GetDiskIoStats connect failed");
+        return E_IPC_ERROR;
+    }
+    return storageDaemon_->GetDiskIoStats(diskId, stats);
+}
+
 int32_t StorageDaemonCommunication::GenerateUserKeys(uint32_t userId, uint32_t flags)
 {
     LOGI("enter");
@@ -67,6 +67,11 @@ namespace StorageManager {
             return;
         }
         std::shared_ptr<VolumeExternal> volumePtr = volumeMap_[volumeId];
+        if (path.empty()) {
+            LOGE("VolumeManagerService::OnVolumeMounted volumeId %{public}s mount failed", volumeId.c_str());
+            volumePtr->SetState(VolumeState::UNMOUNTED);
+            return;
+        }
         volumePtr->SetFsType(fsType);
         volumePtr->SetFsUuid(fsUuid);
         volumePtr->SetPath(path);